@@ -0,0 +1,351 @@
+/*
+* array-bench.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Benchmark array template against std::array and raw arrays
+* - times fill, swap, forward/reverse iteration, operator[], and at()
+* - reports ns per operation and bytes per cycle (TSC cycles)
+* - build with optimizations: results from debug builds are meaningless
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../include/array.h"
+
+//element types: trivial, non-trivial, and over-aligned
+struct overAligned
+{
+   alignas(64) int value;
+};
+
+static std::size_t weight(unsigned char v) { return v; }
+static std::size_t weight(int v) { return static_cast<std::size_t>(v); }
+static std::size_t weight(const std::string& v) { return v.size(); }
+static std::size_t weight(const overAligned& v)
+{
+   return static_cast<std::size_t>(v.value);
+}
+
+template<typename T> T sampleValue();
+template<> unsigned char sampleValue() { return 'x'; }
+template<> int sampleValue() { return 7; }
+template<> std::string sampleValue() { return "sigcpp"; }
+template<> overAligned sampleValue() { return overAligned{ 7 }; }
+
+static const char* typeName(unsigned char) { return "uchar"; }
+static const char* typeName(int) { return "int"; }
+static const char* typeName(const std::string&) { return "string"; }
+static const char* typeName(const overAligned&) { return "aligned64"; }
+
+
+//keep the optimizer from discarding work whose result is never used
+#if defined(_MSC_VER)
+static volatile const void* escapeSink;
+static void escape(const void* p)
+{
+   escapeSink = p;
+   _ReadWriteBarrier();
+}
+#else
+static void escape(const void* p)
+{
+   asm volatile("" : : "g"(p) : "memory");
+}
+#endif
+
+static std::uint64_t readCycles()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+   return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#else
+   return 0; //no cycle counter: bytes/cycle is not reported
+#endif
+}
+
+
+//raw array wrapped only so it can be heap allocated like the other kinds
+template<typename T, std::size_t N>
+struct rawArray
+{
+   T values[N];
+};
+
+//operations on each kind of container: sigcpp::array, std::array, T[N]
+//-sigcpp::array and std::array are exercised through their public API only
+template<typename A, typename T>
+void fillOp(A& a, const T& v) { a.fill(v); }
+
+template<typename T, std::size_t N>
+void fillOp(rawArray<T, N>& a, const T& v)
+{
+   for (std::size_t i = 0; i < N; ++i)
+      a.values[i] = v;
+}
+
+template<typename A>
+void swapOp(A& a, A& b) { a.swap(b); }
+
+template<typename T, std::size_t N>
+void swapOp(rawArray<T, N>& a, rawArray<T, N>& b)
+{
+   using std::swap;
+   for (std::size_t i = 0; i < N; ++i)
+      swap(a.values[i], b.values[i]);
+}
+
+template<typename A>
+std::size_t iterateOp(const A& a)
+{
+   std::size_t sum = 0;
+   for (auto it = a.begin(); it != a.end(); ++it)
+      sum += weight(*it);
+   return sum;
+}
+
+template<typename T, std::size_t N>
+std::size_t iterateOp(const rawArray<T, N>& a)
+{
+   std::size_t sum = 0;
+   for (const T* p = a.values; p != a.values + N; ++p)
+      sum += weight(*p);
+   return sum;
+}
+
+template<typename A>
+std::size_t reverseOp(const A& a)
+{
+   std::size_t sum = 0;
+   for (auto it = a.rbegin(); it != a.rend(); ++it)
+      sum += weight(*it);
+   return sum;
+}
+
+template<typename T, std::size_t N>
+std::size_t reverseOp(const rawArray<T, N>& a)
+{
+   std::size_t sum = 0;
+   using rIt = std::reverse_iterator<const T*>;
+   for (rIt it(a.values + N); it != rIt(a.values); ++it)
+      sum += weight(*it);
+   return sum;
+}
+
+template<typename A>
+std::size_t indexOp(const A& a)
+{
+   std::size_t sum = 0;
+   for (std::size_t i = 0; i < a.size(); ++i)
+      sum += weight(a[i]);
+   return sum;
+}
+
+template<typename T, std::size_t N>
+std::size_t indexOp(const rawArray<T, N>& a)
+{
+   std::size_t sum = 0;
+   for (std::size_t i = 0; i < N; ++i)
+      sum += weight(a.values[i]);
+   return sum;
+}
+
+template<typename A>
+std::size_t atOp(const A& a)
+{
+   std::size_t sum = 0;
+   for (std::size_t i = 0; i < a.size(); ++i)
+      sum += weight(a.at(i));
+   return sum;
+}
+
+
+//timing
+struct result
+{
+   double nsPerOp;
+   double bytesPerCycle;
+   bool valid;
+};
+
+constexpr unsigned trials = 5;
+constexpr std::size_t elementsPerTrial = std::size_t(1) << 22;
+
+//run an op repeatedly and keep the best of several trials
+template<typename F>
+result measure(std::size_t bytesPerOp, std::size_t reps, F&& op)
+{
+   using clock = std::chrono::steady_clock;
+
+   op(); //warm-up: also faults in pages of freshly allocated arrays
+
+   result best{ 0, 0, true };
+   for (unsigned t = 0; t < trials; ++t)
+   {
+      auto start = clock::now();
+      std::uint64_t c0 = readCycles();
+      for (std::size_t r = 0; r < reps; ++r)
+         op();
+      std::uint64_t c1 = readCycles();
+      auto stop = clock::now();
+
+      double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+      double nsPerOp = ns / static_cast<double>(reps);
+      double cycles = static_cast<double>(c1 - c0);
+      double bpc = cycles > 0 ?
+         static_cast<double>(bytesPerOp) * static_cast<double>(reps) / cycles : 0;
+
+      if (t == 0 || nsPerOp < best.nsPerOp)
+         best = result{ nsPerOp, bpc, true };
+   }
+
+   return best;
+}
+
+static void printResult(const result& r)
+{
+   if (!r.valid)
+   {
+      std::cout << std::setw(11) << '-' << std::setw(8) << '-';
+      return;
+   }
+
+   std::cout << std::setw(11) << std::setprecision(2) << r.nsPerOp;
+   if (r.bytesPerCycle > 0)
+      std::cout << std::setw(8) << std::setprecision(3) << r.bytesPerCycle;
+   else
+      std::cout << std::setw(8) << "n/a";
+}
+
+static void printRow(const char* type, std::size_t n, const char* op,
+                     const result& s, const result& std, const result& raw)
+{
+   std::cout << std::left << std::setw(10) << type << std::right
+             << std::setw(7) << n << "  " << std::left << std::setw(8) << op
+             << std::right;
+   printResult(s);
+   std::cout << " |";
+   printResult(std);
+   std::cout << " |";
+   printResult(raw);
+   std::cout << '\n';
+}
+
+static void printHeader()
+{
+   std::cout << std::left << std::setw(10) << "type" << std::right
+             << std::setw(7) << "N" << "  " << std::left << std::setw(8) << "op"
+             << std::right;
+   for (const char* kind : { "sigcpp", "std", "T[N]" })
+   {
+      std::cout << std::setw(11) << kind << std::setw(8) << "B/cyc";
+      if (*kind != 'T')
+         std::cout << " |";
+   }
+   std::cout << '\n';
+}
+
+
+//benchmark all ops for one element type and size
+template<typename T, std::size_t N>
+void benchmark()
+{
+   constexpr std::size_t bytes = N * sizeof(T);
+   const std::size_t reps = elementsPerTrial / N > 0 ? elementsPerTrial / N : 1;
+
+   //heap allocate: the larger sizes do not fit comfortably on the stack
+   auto s1 = std::make_unique<sigcpp::array<T, N>>();
+   auto s2 = std::make_unique<sigcpp::array<T, N>>();
+   auto d1 = std::make_unique<std::array<T, N>>();
+   auto d2 = std::make_unique<std::array<T, N>>();
+   auto r1 = std::make_unique<rawArray<T, N>>();
+   auto r2 = std::make_unique<rawArray<T, N>>();
+
+   const T v = sampleValue<T>();
+   fillOp(*s1, v); fillOp(*s2, v);
+   fillOp(*d1, v); fillOp(*d2, v);
+   fillOp(*r1, v); fillOp(*r2, v);
+
+   const char* type = typeName(v);
+   const result none{ 0, 0, false };
+
+   auto fill = [&](auto& a) { return measure(bytes, reps,
+      [&] { fillOp(a, v); escape(&a); }); };
+   printRow(type, N, "fill", fill(*s1), fill(*d1), fill(*r1));
+
+   auto swap = [&](auto& a, auto& b) { return measure(2 * bytes, reps,
+      [&] { swapOp(a, b); escape(&a); escape(&b); }); };
+   printRow(type, N, "swap", swap(*s1, *s2), swap(*d1, *d2), swap(*r1, *r2));
+
+   //read-only ops: publish the sum so the loop cannot be removed
+   auto read = [&](auto& a, auto op) {
+      std::size_t sum = 0;
+      result r = measure(bytes, reps, [&] { sum += op(a); escape(&a); });
+      escape(&sum);
+      return r;
+   };
+
+   auto iterate = [](const auto& a) { return iterateOp(a); };
+   printRow(type, N, "iterate", read(*s1, iterate), read(*d1, iterate),
+            read(*r1, iterate));
+
+   auto reverse = [](const auto& a) { return reverseOp(a); };
+   printRow(type, N, "reverse", read(*s1, reverse), read(*d1, reverse),
+            read(*r1, reverse));
+
+   auto index = [](const auto& a) { return indexOp(a); };
+   printRow(type, N, "[]", read(*s1, index), read(*d1, index),
+            read(*r1, index));
+
+   auto at = [](const auto& a) { return atOp(a); };
+   printRow(type, N, "at()", read(*s1, at), read(*d1, at), none);
+}
+
+template<typename T>
+void benchmarkSizes()
+{
+   benchmark<T, 4>();
+   benchmark<T, 64>();
+   benchmark<T, 1024>();
+   benchmark<T, 65536>();
+}
+
+int main()
+{
+   std::cout << std::fixed;
+   std::cout << "sigcpp::array vs std::array vs T[N]: best of " << trials
+             << " trials, ns/op and bytes per TSC cycle\n";
+
+   //parity with raw pointers holds only for unchecked iterators
+   std::cout << "iterators: "
+             << (SIGCPP_ITERATOR_DEBUG ? "checked" : "unchecked")
+             << ", sizeof(iterator) = " << sizeof(sigcpp::array<int, 4>::iterator)
+             << ", sizeof(int*) = " << sizeof(int*) << "\n\n";
+
+   printHeader();
+   benchmarkSizes<unsigned char>();
+   benchmarkSizes<int>();
+   benchmarkSizes<std::string>();
+   benchmarkSizes<overAligned>();
+}
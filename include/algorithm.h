@@ -0,0 +1,482 @@
+/*
+* algorithm.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define bulk algorithms on array: reduce, minmax, find, count, equal, and
+* lexicographical_compare
+* - element types with a SIMD vector type (see simd.h) use vector kernels;
+*   other types use the corresponding std algorithms
+* - kernels are specialized on N: the main loop has a constant trip count and
+*   the tail is unrolled at compile time, so there is no remainder loop
+* - reduce adds in a different order than std::accumulate: floating-point
+*   results may differ in the last bits, as permitted for std::reduce
+* - minmax is unspecified if any floating-point element is NaN
+* - overloads for aligned_array use aligned loads if Align is at least the
+*   register size
+* - overloads for span<T, N> with a static extent use the same kernels: a
+*   function may take span<const T, N> to accept arrays, aligned arrays, and
+*   subspans alike
+*/
+
+#ifndef SIGCPP_ALGORITHM_H
+#define SIGCPP_ALGORITHM_H
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+
+#include "config.h"
+#include "array.h"
+#include "aligned_array.h"
+#include "span.h"
+#include "bit.h"
+#include "simd.h"
+
+namespace sigcpp::simd
+{
+	//call f(First), f(First + 1), ... f(First + sizeof...(I) - 1)
+	template<std::size_t First, typename F, std::size_t... I>
+	SIGCPP_FORCEINLINE constexpr void unroll(F&& f, std::index_sequence<I...>)
+	{
+		(f(First + I), ...);
+	}
+
+	//as unroll, but stop at the first call that returns true
+	template<std::size_t First, typename F, std::size_t... I>
+	SIGCPP_FORCEINLINE constexpr bool unroll_any(F&& f, std::index_sequence<I...>)
+	{
+		return (f(First + I) || ...);
+	}
+
+	template<typename T, bool Aligned>
+	typename vector_traits<T>::reg load(const T* p)
+	{
+		if constexpr (Aligned)
+			return vector_traits<T>::load_aligned(p);
+		else
+			return vector_traits<T>::load(p);
+	}
+
+	//kernels: each operates on the N elements starting at p
+	//-Aligned requires p to be aligned to the register size
+
+	template<typename T, std::size_t N, bool Aligned = false>
+	T reduce(const T* p, T init)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		T sum = init;
+
+		if constexpr (body != 0)
+		{
+			//independent accumulators hide the latency of each add
+			constexpr std::size_t U = body / W < 4 ? body / W : 4;
+			typename V::reg acc[U];
+
+			unroll<0>([&](std::size_t u) { acc[u] = load<T, Aligned>(p + u * W); },
+				std::make_index_sequence<U>{});
+
+			std::size_t i = U * W;
+			for (; i + U * W <= body; i += U * W)
+			{
+				unroll<0>([&](std::size_t u) {
+						acc[u] = V::add(acc[u], load<T, Aligned>(p + i + u * W));
+					}, std::make_index_sequence<U>{});
+			}
+
+			for (; i < body; i += W)
+				acc[0] = V::add(acc[0], load<T, Aligned>(p + i));
+
+			unroll<1>([&](std::size_t u) { acc[0] = V::add(acc[0], acc[u]); },
+				std::make_index_sequence<U - 1>{});
+
+			T lanes[W];
+			V::store(lanes, acc[0]);
+			unroll<0>([&](std::size_t k) { sum += lanes[k]; },
+				std::make_index_sequence<W>{});
+		}
+
+		unroll<body>([&](std::size_t k) { sum += p[k]; },
+			std::make_index_sequence<N - body>{});
+
+		return sum;
+	}
+
+	template<typename T, std::size_t N, bool Aligned = false>
+	std::pair<T, T> minmax(const T* p)
+	{
+		static_assert(N != 0, "minmax requires at least one element");
+
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		T lo, hi;
+		if constexpr (body != 0)
+		{
+			typename V::reg vlo = load<T, Aligned>(p);
+			typename V::reg vhi = vlo;
+			for (std::size_t i = W; i < body; i += W)
+			{
+				typename V::reg r = load<T, Aligned>(p + i);
+				vlo = V::min(vlo, r);
+				vhi = V::max(vhi, r);
+			}
+
+			T lanesLo[W], lanesHi[W];
+			V::store(lanesLo, vlo);
+			V::store(lanesHi, vhi);
+			lo = lanesLo[0];
+			hi = lanesHi[0];
+			unroll<1>([&](std::size_t k) {
+					lo = lanesLo[k] < lo ? lanesLo[k] : lo;
+					hi = hi < lanesHi[k] ? lanesHi[k] : hi;
+				}, std::make_index_sequence<W - 1>{});
+		}
+		else
+			lo = hi = p[0];
+
+		unroll<body>([&](std::size_t k) {
+				lo = p[k] < lo ? p[k] : lo;
+				hi = hi < p[k] ? p[k] : hi;
+			}, std::make_index_sequence<N - body>{});
+
+		return { lo, hi };
+	}
+
+	//index of the first element equal to value; N if there is none
+	template<typename T, std::size_t N, bool Aligned = false>
+	std::size_t find(const T* p, const T& value)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		if constexpr (body != 0)
+		{
+			const typename V::reg v = V::set1(value);
+			for (std::size_t i = 0; i < body; i += W)
+			{
+				unsigned m = V::eq_mask(load<T, Aligned>(p + i), v);
+				if (m != 0)
+					return i + static_cast<std::size_t>(countr_zero(m));
+			}
+		}
+
+		std::size_t found = N;
+		unroll_any<body>([&](std::size_t k) {
+				if (!(p[k] == value))
+					return false;
+				found = k;
+				return true;
+			}, std::make_index_sequence<N - body>{});
+
+		return found;
+	}
+
+	template<typename T, std::size_t N, bool Aligned = false>
+	std::size_t count(const T* p, const T& value)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		std::size_t n = 0;
+		if constexpr (body != 0)
+		{
+			const typename V::reg v = V::set1(value);
+			for (std::size_t i = 0; i < body; i += W)
+				n += static_cast<std::size_t>(
+					popcount(V::eq_mask(load<T, Aligned>(p + i), v)));
+		}
+
+		unroll<body>([&](std::size_t k) { n += p[k] == value; },
+			std::make_index_sequence<N - body>{});
+
+		return n;
+	}
+
+	template<typename T, std::size_t N, bool Aligned = false>
+	bool equal(const T* a, const T* b)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		for (std::size_t i = 0; i < body; i += W)
+		{
+			unsigned m = V::eq_mask(load<T, Aligned>(a + i), load<T, Aligned>(b + i));
+			if (m != lane_mask(W))
+				return false;
+		}
+
+		return !unroll_any<body>([&](std::size_t k) { return !(a[k] == b[k]); },
+			std::make_index_sequence<N - body>{});
+	}
+
+	//find mismatches a block at a time, then order the mismatched elements
+	//-elements that are unequal but unordered (NaN) do not decide the result
+	template<typename T, std::size_t N, bool Aligned = false>
+	bool lexicographical_compare(const T* a, const T* b)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		for (std::size_t i = 0; i < body; i += W)
+		{
+			unsigned m = V::eq_mask(load<T, Aligned>(a + i), load<T, Aligned>(b + i));
+			for (unsigned diff = ~m & lane_mask(W); diff != 0; diff &= diff - 1)
+			{
+				std::size_t k = i + static_cast<std::size_t>(countr_zero(diff));
+				if (a[k] < b[k])
+					return true;
+				if (b[k] < a[k])
+					return false;
+			}
+		}
+
+		bool less = false;
+		unroll_any<body>([&](std::size_t k) {
+				if (a[k] < b[k])
+					less = true;
+				else if (!(b[k] < a[k]))
+					return false;
+				return true;
+			}, std::make_index_sequence<N - body>{});
+
+		return less;
+	}
+
+}	//namespace sigcpp::simd
+
+
+namespace sigcpp
+{
+	//the algorithms proper, on the N elements at p (and at q)
+	//-Aligned selects aligned loads in vector kernels
+	template<bool Aligned, std::size_t N, typename T>
+	T _reduce(const T* p, T init)
+	{
+		if constexpr (simd::vector_traits<T>::arithmetic)
+			return simd::reduce<T, N, Aligned>(p, init);
+		else
+			return std::accumulate(p, p + N, init);
+	}
+
+	template<bool Aligned, std::size_t N, typename T>
+	std::pair<T, T> _minmax(const T* p)
+	{
+		static_assert(N != 0, "minmax requires at least one element");
+
+		if constexpr (simd::vector_traits<T>::arithmetic)
+			return simd::minmax<T, N, Aligned>(p);
+		else
+		{
+			auto r = std::minmax_element(p, p + N);
+			return { *r.first, *r.second };
+		}
+	}
+
+	template<bool Aligned, std::size_t N, typename T>
+	std::size_t _find(const T* p, const T& value)
+	{
+		if constexpr (simd::vector_traits<T>::supported)
+			return simd::find<T, N, Aligned>(p, value);
+		else
+			return static_cast<std::size_t>(std::find(p, p + N, value) - p);
+	}
+
+	template<bool Aligned, std::size_t N, typename T>
+	std::size_t _count(const T* p, const T& value)
+	{
+		if constexpr (simd::vector_traits<T>::supported)
+			return simd::count<T, N, Aligned>(p, value);
+		else
+			return static_cast<std::size_t>(std::count(p, p + N, value));
+	}
+
+	template<bool Aligned, std::size_t N, typename T>
+	bool _equal(const T* p, const T* q)
+	{
+		if constexpr (simd::vector_traits<T>::supported)
+			return simd::equal<T, N, Aligned>(p, q);
+		else
+			return std::equal(p, p + N, q);
+	}
+
+	template<bool Aligned, std::size_t N, typename T>
+	bool _lexicographical_compare(const T* p, const T* q)
+	{
+		if constexpr (simd::vector_traits<T>::supported)
+			return simd::lexicographical_compare<T, N, Aligned>(p, q);
+		else
+			return std::lexicographical_compare(p, p + N, q, q + N);
+	}
+
+	//aligned loads are possible if storage is aligned to the register size
+	template<std::size_t Align>
+	inline constexpr bool _is_register_aligned =
+		simd::register_size != 0 && Align >= simd::register_size;
+
+
+	//sum of init and all elements
+	template<typename T, std::size_t N>
+	T reduce(const array<T, N>& a, T init = T())
+	{
+		return _reduce<false, N>(a.data(), init);
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	T reduce(const aligned_array<T, N, A>& a, T init = T())
+	{
+		return _reduce<_is_register_aligned<A>, N>(a.data(), init);
+	}
+
+	//smallest and largest elements
+	template<typename T, std::size_t N>
+	std::pair<T, T> minmax(const array<T, N>& a)
+	{
+		return _minmax<false, N>(a.data());
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	std::pair<T, T> minmax(const aligned_array<T, N, A>& a)
+	{
+		return _minmax<_is_register_aligned<A>, N>(a.data());
+	}
+
+	//first element equal to value
+	template<typename T, std::size_t N>
+	typename array<T, N>::iterator find(array<T, N>& a, const T& value)
+	{
+		using diff = typename array<T, N>::difference_type;
+		return a.begin() + static_cast<diff>(_find<false, N>(a.data(), value));
+	}
+
+	template<typename T, std::size_t N>
+	typename array<T, N>::const_iterator find(const array<T, N>& a,
+		const T& value)
+	{
+		using diff = typename array<T, N>::difference_type;
+		return a.cbegin() + static_cast<diff>(_find<false, N>(a.data(), value));
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	typename array<T, N>::iterator find(aligned_array<T, N, A>& a,
+		const T& value)
+	{
+		using diff = typename array<T, N>::difference_type;
+		return a.begin() + static_cast<diff>(
+			_find<_is_register_aligned<A>, N>(a.data(), value));
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	typename array<T, N>::const_iterator find(const aligned_array<T, N, A>& a,
+		const T& value)
+	{
+		using diff = typename array<T, N>::difference_type;
+		return a.cbegin() + static_cast<diff>(
+			_find<_is_register_aligned<A>, N>(a.data(), value));
+	}
+
+	//number of elements equal to value
+	template<typename T, std::size_t N>
+	std::size_t count(const array<T, N>& a, const T& value)
+	{
+		return _count<false, N>(a.data(), value);
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	std::size_t count(const aligned_array<T, N, A>& a, const T& value)
+	{
+		return _count<_is_register_aligned<A>, N>(a.data(), value);
+	}
+
+	template<typename T, std::size_t N>
+	bool equal(const array<T, N>& a, const array<T, N>& b)
+	{
+		return _equal<false, N>(a.data(), b.data());
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	bool equal(const aligned_array<T, N, A>& a, const aligned_array<T, N, A>& b)
+	{
+		return _equal<_is_register_aligned<A>, N>(a.data(), b.data());
+	}
+
+	template<typename T, std::size_t N>
+	bool lexicographical_compare(const array<T, N>& a, const array<T, N>& b)
+	{
+		return _lexicographical_compare<false, N>(a.data(), b.data());
+	}
+
+	template<typename T, std::size_t N, std::size_t A>
+	bool lexicographical_compare(const aligned_array<T, N, A>& a,
+		const aligned_array<T, N, A>& b)
+	{
+		return _lexicographical_compare<_is_register_aligned<A>, N>(a.data(), b.data());
+	}
+
+	//spans of a static extent
+	template<typename T, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent>>
+	std::remove_cv_t<T> reduce(span<T, N> s, std::remove_cv_t<T> init = std::remove_cv_t<T>())
+	{
+		return _reduce<false, N>(static_cast<const std::remove_cv_t<T>*>(s.data()), init);
+	}
+
+	template<typename T, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent>>
+	std::pair<std::remove_cv_t<T>, std::remove_cv_t<T>> minmax(span<T, N> s)
+	{
+		return _minmax<false, N>(static_cast<const std::remove_cv_t<T>*>(s.data()));
+	}
+
+	template<typename T, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent>>
+	typename span<T, N>::iterator find(span<T, N> s, const std::remove_cv_t<T>& value)
+	{
+		using diff = typename span<T, N>::difference_type;
+		return s.begin() + static_cast<diff>(
+			_find<false, N>(static_cast<const std::remove_cv_t<T>*>(s.data()), value));
+	}
+
+	template<typename T, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent>>
+	std::size_t count(span<T, N> s, const std::remove_cv_t<T>& value)
+	{
+		return _count<false, N>(static_cast<const std::remove_cv_t<T>*>(s.data()), value);
+	}
+
+	template<typename T, typename U, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent &&
+			std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<U>>>>
+	bool equal(span<T, N> a, span<U, N> b)
+	{
+		using V = std::remove_cv_t<T>;
+		return _equal<false, N>(static_cast<const V*>(a.data()), static_cast<const V*>(b.data()));
+	}
+
+	template<typename T, typename U, std::size_t N,
+		typename = std::enable_if_t<N != dynamic_extent &&
+			std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<U>>>>
+	bool lexicographical_compare(span<T, N> a, span<U, N> b)
+	{
+		using V = std::remove_cv_t<T>;
+		return _lexicographical_compare<false, N>(static_cast<const V*>(a.data()),
+			static_cast<const V*>(b.data()));
+	}
+
+}	//namespace sigcpp
+
+#endif
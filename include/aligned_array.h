@@ -0,0 +1,59 @@
+/*
+* aligned_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for arrays with over-aligned storage
+* - aligned_array<T, N, Align> is an array<T, N> whose data() is aligned to
+*   Align bytes and whose size is a multiple of Align
+* - it remains an aggregate: aligned_array<short, 3, 16> s{ 8, -2, 7 };
+* - it converts to array<T, N>&: functions taking an array accept it
+* - it has the tuple interface of array: auto [x, y, z, w] = v;
+*/
+
+#ifndef SIGCPP_ALIGNED_ARRAY_H
+#define SIGCPP_ALIGNED_ARRAY_H
+
+#include <cstddef>
+
+#include "array.h"
+
+namespace sigcpp
+{
+	//size of a cache line on the targets of interest
+	//-align data written by different threads to this to avoid false sharing
+	inline constexpr std::size_t cache_line_size = 64;
+
+	template<typename T, std::size_t N, std::size_t Align>
+	struct alignas(Align) aligned_array : array<T, N>
+	{
+		static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+			"alignment must be a power of two");
+		static_assert(Align >= alignof(T),
+			"alignment must not be less than the alignment of T");
+
+		static constexpr std::size_t alignment = Align;
+
+	}; //template aligned_array
+
+}	//namespace sigcpp
+
+//tuple interface: get<I> is that of the base array
+namespace std
+{
+	template<typename T, std::size_t N, std::size_t Align>
+	struct tuple_size<sigcpp::aligned_array<T, N, Align>>
+		: std::integral_constant<std::size_t, N> {};
+
+	template<std::size_t I, typename T, std::size_t N, std::size_t Align>
+	struct tuple_element<I, sigcpp::aligned_array<T, N, Align>>
+		: tuple_element<I, sigcpp::array<T, N>> {};
+
+}	//namespace std
+
+#endif
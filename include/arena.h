@@ -0,0 +1,330 @@
+/*
+* arena.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define memory resources over caller-supplied buffers
+* - monotonic_arena bump-allocates from a buffer such as array<std::byte, N>:
+*   deallocate is a no-op, release frees everything at once
+* - static_arena<N> is a monotonic_arena that holds its own N-byte buffer
+* - block_pool serves fixed-size blocks from a buffer, with a free list
+* - both are std::pmr::memory_resource: containers in sigcpp::pmr (aliases
+*   of std::pmr containers) allocate from them
+* - requests the buffer cannot meet go to the upstream resource; the default
+*   upstream is std::pmr::null_memory_resource(), which throws std::bad_alloc
+* - stats (bytes or blocks in use, high-water mark, upstream use) help size
+*   buffers: the high-water mark persists across release
+* - not thread safe: use one resource per thread, as with
+*   std::pmr::monotonic_buffer_resource
+*/
+
+#ifndef SIGCPP_ARENA_H
+#define SIGCPP_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "throw.h"
+#include "array.h"
+
+namespace sigcpp
+{
+	class monotonic_arena : public std::pmr::memory_resource
+	{
+	public:
+		//ctors
+		monotonic_arena(void* buffer, std::size_t size,
+			std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+			: first(static_cast<std::byte*>(buffer)), capacityBytes(size),
+			cursor(first), last(first + size), upstreamResource(upstream),
+			nextChunkSize(size < 1024 ? 1024 : size) {}
+
+		template<std::size_t N>
+		explicit monotonic_arena(array<std::byte, N>& buffer,
+			std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+			: monotonic_arena(buffer.data(), N, upstream) {}
+
+		monotonic_arena(const monotonic_arena&) = delete;
+		monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+		~monotonic_arena() override { release(); }
+
+		//free all memory: the buffer is reused, upstream chunks are returned
+		void release() noexcept
+		{
+			while (chunks != nullptr)
+			{
+				chunk* prev = chunks->prev;
+				upstreamResource->deallocate(chunks, chunks->size, alignof(std::max_align_t));
+				chunks = prev;
+			}
+
+			cursor = first;
+			last = first + capacityBytes;
+			used = 0;
+		}
+
+		std::pmr::memory_resource* upstream_resource() const noexcept
+		{
+			return upstreamResource;
+		}
+
+		//stats
+		//-bytes include alignment padding
+		std::size_t capacity() const noexcept { return capacityBytes; }
+		std::size_t bytes_used() const noexcept { return used; }
+		std::size_t high_water() const noexcept { return highWater; }
+		std::size_t allocation_count() const noexcept { return allocations; }
+
+		//bytes obtained from upstream since construction: 0 if the buffer sufficed
+		std::size_t upstream_bytes() const noexcept { return upstreamBytes; }
+
+	protected:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			void* p = _bump(bytes, alignment);
+			if (p == nullptr)
+			{
+				_grow(bytes, alignment);
+				p = _bump(bytes, alignment);
+
+				//a new chunk has room by construction: guard against a miscount
+				if (p == nullptr)
+					_throw_bad_alloc();
+			}
+
+			++allocations;
+			return p;
+		}
+
+		void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+		bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override
+		{
+			return this == &r;
+		}
+
+	private:
+		//header of each chunk obtained from upstream
+		struct alignas(std::max_align_t) chunk
+		{
+			chunk* prev;
+			std::size_t size;
+		};
+
+		std::byte* first;
+		std::size_t capacityBytes;
+		std::byte* cursor;
+		std::byte* last;
+		std::pmr::memory_resource* upstreamResource;
+		chunk* chunks{ nullptr };
+		std::size_t nextChunkSize;
+
+		std::size_t used{ 0 };
+		std::size_t highWater{ 0 };
+		std::size_t allocations{ 0 };
+		std::size_t upstreamBytes{ 0 };
+
+		//nullptr if the current block cannot hold the request
+		void* _bump(std::size_t bytes, std::size_t alignment) noexcept
+		{
+			void* p = cursor;
+			std::size_t space = static_cast<std::size_t>(last - cursor);
+			if (std::align(alignment, bytes, p, space) == nullptr)
+				return nullptr;
+
+			std::byte* end = static_cast<std::byte*>(p) + bytes;
+			used += static_cast<std::size_t>(end - cursor);
+			highWater = used > highWater ? used : highWater;
+			cursor = end;
+			return p;
+		}
+
+		//continue in a new upstream chunk; chunk sizes grow geometrically
+		//-requests whose chunk size would overflow throw std::bad_alloc
+		void _grow(std::size_t bytes, std::size_t alignment)
+		{
+			constexpr std::size_t max = static_cast<std::size_t>(-1);
+			if (bytes > max - sizeof(chunk) || alignment > max - sizeof(chunk) - bytes)
+				_throw_bad_alloc();
+
+			std::size_t size = sizeof(chunk) + bytes + alignment;
+			size = size < nextChunkSize ? nextChunkSize : size;
+
+			chunk* c = static_cast<chunk*>(
+				upstreamResource->allocate(size, alignof(std::max_align_t)));
+			c->prev = chunks;
+			c->size = size;
+			chunks = c;
+
+			cursor = reinterpret_cast<std::byte*>(c + 1);
+			last = reinterpret_cast<std::byte*>(c) + size;
+			upstreamBytes += size;
+			nextChunkSize = size > max / 2 ? size : size * 2;
+		}
+
+	}; //class monotonic_arena
+
+
+	//the buffer is a base so that it is constructed before the arena
+	template<std::size_t N>
+	struct _arena_buffer
+	{
+		alignas(std::max_align_t) array<std::byte, N> buffer;
+	};
+
+	template<std::size_t N>
+	class static_arena : private _arena_buffer<N>, public monotonic_arena
+	{
+	public:
+		explicit static_arena(
+			std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+			: monotonic_arena(this->buffer, upstream) {}
+
+	}; //template static_arena
+
+
+	class block_pool : public std::pmr::memory_resource
+	{
+	public:
+		//ctors
+		//-block size is rounded up to a multiple of a pointer's size; blocks are
+		//aligned to the largest power of two dividing it, up to max_align_t
+		block_pool(void* buffer, std::size_t size, std::size_t blockSize,
+			std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+			: blockBytes(_round_block(blockSize)), blockAlign(_block_alignment(blockBytes)),
+			upstreamResource(upstream)
+		{
+			void* p = buffer;
+			if (std::align(blockAlign, blockBytes, p, size) == nullptr)
+				size = 0;
+
+			first = static_cast<std::byte*>(p);
+			blocks = size / blockBytes;
+			last = first + blocks * blockBytes;
+
+			//free list in address order
+			for (std::size_t i = blocks; i-- > 0;)
+				_push(first + i * blockBytes);
+		}
+
+		template<std::size_t N>
+		block_pool(array<std::byte, N>& buffer, std::size_t blockSize,
+			std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+			: block_pool(buffer.data(), N, blockSize, upstream) {}
+
+		block_pool(const block_pool&) = delete;
+		block_pool& operator=(const block_pool&) = delete;
+
+		std::pmr::memory_resource* upstream_resource() const noexcept
+		{
+			return upstreamResource;
+		}
+
+		//stats
+		std::size_t block_size() const noexcept { return blockBytes; }
+		std::size_t block_alignment() const noexcept { return blockAlign; }
+		std::size_t block_count() const noexcept { return blocks; }
+		std::size_t blocks_in_use() const noexcept { return inUse; }
+		std::size_t high_water() const noexcept { return highWater; }
+
+		//requests sent upstream: too large, over-aligned, or the pool was empty
+		std::size_t upstream_allocations() const noexcept { return upstreamCount; }
+
+	protected:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			if (bytes <= blockBytes && alignment <= blockAlign && freeList != nullptr)
+			{
+				free_block* b = freeList;
+				freeList = b->next;
+				++inUse;
+				highWater = inUse > highWater ? inUse : highWater;
+				return b;
+			}
+
+			++upstreamCount;
+			return upstreamResource->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+		{
+			std::byte* b = static_cast<std::byte*>(p);
+			if (first <= b && b < last)
+			{
+				_push(b);
+				--inUse;
+			}
+			else
+				upstreamResource->deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override
+		{
+			return this == &r;
+		}
+
+	private:
+		struct free_block
+		{
+			free_block* next;
+		};
+
+		std::size_t blockBytes;
+		std::size_t blockAlign;
+		std::pmr::memory_resource* upstreamResource;
+		std::byte* first{ nullptr };
+		std::byte* last{ nullptr };
+		std::size_t blocks{ 0 };
+		free_block* freeList{ nullptr };
+
+		std::size_t inUse{ 0 };
+		std::size_t highWater{ 0 };
+		std::size_t upstreamCount{ 0 };
+
+		static constexpr std::size_t _round_block(std::size_t n) noexcept
+		{
+			constexpr std::size_t unit = sizeof(free_block);
+			return n <= unit ? unit : (n + unit - 1) / unit * unit;
+		}
+
+		static constexpr std::size_t _block_alignment(std::size_t n) noexcept
+		{
+			const std::size_t a = n & (~n + 1);
+			return a < alignof(std::max_align_t) ? a : alignof(std::max_align_t);
+		}
+
+		void _push(std::byte* p) noexcept
+		{
+			freeList = ::new (p) free_block{ freeList };
+		}
+
+	}; //class block_pool
+
+
+	//std::pmr containers: construct with a pointer to a resource
+	namespace pmr
+	{
+		template<typename T>
+		using vector = std::pmr::vector<T>;
+
+		template<typename CharT, typename Traits = std::char_traits<CharT>>
+		using basic_string = std::pmr::basic_string<CharT, Traits>;
+
+		using string = std::pmr::string;
+		using wstring = std::pmr::wstring;
+
+	}	//namespace pmr
+
+}	//namespace sigcpp
+
+#endif
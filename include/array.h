@@ -18,14 +18,22 @@
 #define SIGCPP_ARRAY_H
 
 #include <cstddef>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
 #include <algorithm>
 #include <iterator>
 #include <type_traits>
 
+#include "config.h"
+#include "throw.h"
+#include "instrument.h"
 #include "array_iterator.h"
 
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#endif
+
 namespace sigcpp
 {
 	template<typename T, std::size_t N>
@@ -40,7 +48,7 @@ namespace sigcpp
 		using size_type = std::size_t;
 		using difference_type = std::ptrdiff_t;
 
-		//unchecked iterators: simple but standards-compliant
+		//iterators: unchecked or checked per SIGCPP_ITERATOR_DEBUG
 		using iterator = array_iterator<pointer>; 
 		using const_iterator = array_iterator<const_pointer>;
 		using reverse_iterator = std::reverse_iterator<iterator>;
@@ -50,11 +58,52 @@ namespace sigcpp
 		value_type values[N==0 ? 1 : N];
 
 		//utility
-		void fill(const T& u) { std::fill_n(values, N, u); }
+		//fill and swap are loops rather than calls to std::fill_n and
+		//std::swap_ranges: those algorithms are constexpr only from C++20
+		//-at run time, trivially-copyable elements take byte-wise fast paths
+		constexpr void fill(const T& u)
+		{
+			if constexpr (_is_bytewise && sizeof(T) == 1)
+			{
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				{
+					unsigned char byte;
+					std::memcpy(&byte, &u, 1);
+					std::memset(values, byte, N);
+					return;
+				}
+			}
+
+			//a trivially-copyable local broadcasts from a register in the
+			//store loop; other types assign from u, which may alias an
+			//element because self-assignment is safe
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				const value_type v = u;
+				for (size_type i = 0; i < N; ++i)
+					values[i] = v;
+			}
+			else
+			{
+				for (size_type i = 0; i < N; ++i)
+					values[i] = u;
+			}
+		}
 
-		void swap(array& a) noexcept(std::is_nothrow_swappable_v<T>)
+		constexpr void swap(array& a) noexcept(std::is_nothrow_swappable_v<T>)
 		{
-			std::swap_ranges(values, values + N, a.values);
+			if constexpr (_is_bytewise)
+			{
+				if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				{
+					if (this != &a)
+						_swap_blocks(values, a.values);
+					return;
+				}
+			}
+
+			for (size_type i = 0; i < N; ++i)
+				_swap(values[i], a.values[i]);
 		}
 
 		//iterators
@@ -88,7 +137,7 @@ namespace sigcpp
 			if constexpr (N == 0)
 				return const_iterator();
 			else
-				return const_iterator(values);
+				return const_iterator(values, values, values + N);
 		}
 
 		constexpr const_iterator cend() const noexcept
@@ -96,7 +145,7 @@ namespace sigcpp
 			if constexpr (N == 0)
 				return const_iterator();
 			else
-				return const_iterator(values + N);
+				return const_iterator(values + N, values, values + N);
 		}
 
 		constexpr const_reverse_iterator crbegin() const noexcept 
@@ -115,10 +164,15 @@ namespace sigcpp
 		constexpr size_type max_size() const noexcept { return N; }
 
 		//unchecked element access
-		constexpr reference operator[](size_type pos) { return values[pos]; }
+		constexpr reference operator[](size_type pos)
+		{
+			_instrument_access(values, N, pos, access_kind::index);
+			return values[pos];
+		}
 		
 		constexpr const_reference operator[](size_type pos) const 
 		{ 
+			_instrument_access(values, N, pos, access_kind::index);
 			return values[pos]; 
 		}
 
@@ -130,6 +184,17 @@ namespace sigcpp
 
 		constexpr const_reference at(size_type pos) const { return _at(pos); }
 
+		//checked element access without exceptions: nullptr if out of range
+		constexpr pointer try_at(size_type pos) noexcept
+		{
+			return const_cast<pointer>(_try_at(pos));
+		}
+
+		constexpr const_pointer try_at(size_type pos) const noexcept
+		{
+			return _try_at(pos);
+		}
+
 		constexpr reference front() { return values[0]; }
 		constexpr const_reference front() const { return values[0]; }
 
@@ -145,13 +210,63 @@ namespace sigcpp
 		constexpr const_pointer data() const noexcept { return _data(); }
 
 	private:
+		//fill and swap may copy bytes instead of elements
+		static constexpr bool _is_bytewise =
+			N != 0 && std::is_trivially_copyable_v<T>;
+
 		//utility functions to eliminate redundancy in public members
+
+		//std::swap is not constexpr in C++17: exchange trivially-copyable
+		//elements directly, which is equivalent; defer to ADL otherwise
+		static constexpr void _swap(reference x, reference y)
+			noexcept(std::is_nothrow_swappable_v<T>)
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				value_type t = x;
+				x = y;
+				y = t;
+			}
+			else
+			{
+				using std::swap;
+				swap(x, y);
+			}
+		}
+
+		//swap whole cache lines through a small stack buffer
+		//-block and trip counts are constants: memcpy calls expand inline
+		static void _swap_blocks(void* x, void* y) noexcept
+		{
+			constexpr size_type bytes = sizeof(value_type) * N;
+			constexpr size_type block = bytes < 256 ? bytes : 256;
+			constexpr size_type rest = bytes % block;
+
+			unsigned char buffer[block];
+			unsigned char* p = static_cast<unsigned char*>(x);
+			unsigned char* q = static_cast<unsigned char*>(y);
+
+			for (size_type i = 0; i < bytes / block; ++i, p += block, q += block)
+			{
+				std::memcpy(buffer, p, block);
+				std::memcpy(p, q, block);
+				std::memcpy(q, buffer, block);
+			}
+
+			if constexpr (rest != 0)
+			{
+				std::memcpy(buffer, p, rest);
+				std::memcpy(p, q, rest);
+				std::memcpy(q, buffer, rest);
+			}
+		}
+
 		constexpr iterator _begin() noexcept
 		{
 			if constexpr (N == 0)
 				return iterator();
 			else
-				return iterator(values);
+				return iterator(values, values, values + N);
 		}
 
 		constexpr iterator _end() noexcept
@@ -159,15 +274,21 @@ namespace sigcpp
 			if constexpr (N == 0)
 				return iterator();
 			else
-				return iterator(values + N);
+				return iterator(values + N, values, values + N);
 		}
 
 		constexpr const_reference _at(size_type pos) const
 		{
-			if (pos < N)
-				return values[pos];
-			else
-				throw new std::out_of_range("array index out of range");
+			if (pos >= N)
+				_throw_out_of_range("array index out of range");
+
+			_instrument_access(values, N, pos, access_kind::checked);
+			return values[pos];
+		}
+
+		constexpr const_pointer _try_at(size_type pos) const noexcept
+		{
+			return pos < N ? values + pos : nullptr;
 		}
 
 		constexpr const_reference _back() const
@@ -188,6 +309,197 @@ namespace sigcpp
 
 	}; //template array
 
+	//comparison: see C++17 [array.overview], [container.requirements.general]
+	//-at run time, equality of elements whose operator== is built in and has
+	//unique object representations is equality of bytes: memcmp
+	//-so is ordering of unsigned bytes: memcmp compares unsigned char
+	//-class types may define operator== over only some of their bytes: they
+	//are compared element-wise
+
+	//true if element equality is equality of bytes
+	template<typename T>
+	inline constexpr bool _is_memcmp_equal =
+		(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+		std::has_unique_object_representations_v<T>;
+
+	template<typename T, std::size_t N>
+	inline constexpr bool _is_memcmp_equal<array<T, N>> =
+		N != 0 && _is_memcmp_equal<T>;
+
+	template<typename T, std::size_t N>
+	inline constexpr bool _is_memcmp_equal<const array<T, N>> =
+		_is_memcmp_equal<array<T, N>>;
+
+	//true if element order is the order of memcmp
+	template<typename T>
+	inline constexpr bool _is_memcmp_ordered =
+		std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte> ||
+#if defined(__cpp_char8_t)
+		std::is_same_v<T, char8_t> ||
+#endif
+		(std::is_same_v<T, char> && std::is_unsigned_v<char>);
+
+	template<typename T, std::size_t N>
+	constexpr bool operator==(const array<T, N>& a, const array<T, N>& b)
+	{
+		if constexpr (N != 0 && _is_memcmp_equal<T>)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				return std::memcmp(a.values, b.values, sizeof(T) * N) == 0;
+		}
+
+		for (std::size_t i = 0; i < N; ++i)
+			if (!(a.values[i] == b.values[i]))
+				return false;
+		return true;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator!=(const array<T, N>& a, const array<T, N>& b)
+	{
+		return !(a == b);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<(const array<T, N>& a, const array<T, N>& b)
+	{
+		if constexpr (N != 0 && _is_memcmp_ordered<T>)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				return std::memcmp(a.values, b.values, N) < 0;
+		}
+
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			if (a.values[i] < b.values[i])
+				return true;
+			if (b.values[i] < a.values[i])
+				return false;
+		}
+		return false;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>(const array<T, N>& a, const array<T, N>& b)
+	{
+		return b < a;
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator<=(const array<T, N>& a, const array<T, N>& b)
+	{
+		return !(b < a);
+	}
+
+	template<typename T, std::size_t N>
+	constexpr bool operator>=(const array<T, N>& a, const array<T, N>& b)
+	{
+		return !(a < b);
+	}
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+	template<typename T, std::size_t N>
+		requires std::three_way_comparable<T>
+	constexpr std::compare_three_way_result_t<T> operator<=>(const array<T, N>& a,
+		const array<T, N>& b)
+	{
+		if constexpr (N != 0 && _is_memcmp_ordered<T>)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				return std::memcmp(a.values, b.values, N) <=> 0;
+		}
+
+		for (std::size_t i = 0; i < N; ++i)
+			if (auto c = a.values[i] <=> b.values[i]; c != 0)
+				return c;
+		return std::strong_ordering::equal;
+	}
+#endif
+
+	//deduction guide: array a{ 1, 2, 3 } is array<int, 3>
+	//-see C++17 [array.cons]
+	template<typename T, typename... U>
+	array(T, U...) -> array<std::enable_if_t<(std::is_same_v<T, U> && ...), T>,
+		1 + sizeof...(U)>;
+
+	//create an array from a built-in array: copy lvalue elements, move rvalue
+	//elements
+	//-see C++20 [array.creation]
+	template<typename T, std::size_t N, std::size_t... I>
+	constexpr array<std::remove_cv_t<T>, N> _to_array(T (&a)[N],
+		std::index_sequence<I...>)
+	{
+		return { { a[I]... } };
+	}
+
+	template<typename T, std::size_t N, std::size_t... I>
+	constexpr array<std::remove_cv_t<T>, N> _to_array(T (&&a)[N],
+		std::index_sequence<I...>)
+	{
+		return { { std::move(a[I])... } };
+	}
+
+	template<typename T, std::size_t N>
+	constexpr array<std::remove_cv_t<T>, N> to_array(T (&a)[N])
+	{
+		static_assert(!std::is_array_v<T>, "multidimensional arrays are not supported");
+		static_assert(std::is_constructible_v<T, T&>, "elements must be copyable");
+		return _to_array(a, std::make_index_sequence<N>());
+	}
+
+	template<typename T, std::size_t N>
+	constexpr array<std::remove_cv_t<T>, N> to_array(T (&&a)[N])
+	{
+		static_assert(!std::is_array_v<T>, "multidimensional arrays are not supported");
+		static_assert(std::is_move_constructible_v<T>, "elements must be movable");
+		return _to_array(std::move(a), std::make_index_sequence<N>());
+	}
+
+	//tuple interface: element I, with I checked at compile time
+	//-see C++17 [array.tuple]
+	template<std::size_t I, typename T, std::size_t N>
+	constexpr T& get(array<T, N>& a) noexcept
+	{
+		static_assert(I < N, "array index out of range");
+		return a.values[I];
+	}
+
+	template<std::size_t I, typename T, std::size_t N>
+	constexpr T&& get(array<T, N>&& a) noexcept
+	{
+		static_assert(I < N, "array index out of range");
+		return std::move(a.values[I]);
+	}
+
+	template<std::size_t I, typename T, std::size_t N>
+	constexpr const T& get(const array<T, N>& a) noexcept
+	{
+		static_assert(I < N, "array index out of range");
+		return a.values[I];
+	}
+
+	template<std::size_t I, typename T, std::size_t N>
+	constexpr const T&& get(const array<T, N>&& a) noexcept
+	{
+		static_assert(I < N, "array index out of range");
+		return std::move(a.values[I]);
+	}
+
 }	//namespace sigcpp
 
+//tuple_size and tuple_element: enable structured bindings and std::apply
+namespace std
+{
+	template<typename T, std::size_t N>
+	struct tuple_size<sigcpp::array<T, N>> : std::integral_constant<std::size_t, N> {};
+
+	template<std::size_t I, typename T, std::size_t N>
+	struct tuple_element<I, sigcpp::array<T, N>>
+	{
+		static_assert(I < N, "array index out of range");
+		using type = T;
+	};
+
+}	//namespace std
+
 #endif
\ No newline at end of file
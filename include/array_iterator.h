@@ -16,9 +16,34 @@
 
 #include <cstddef>
 #include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "instrument.h"
+
+#if SIGCPP_ITERATOR_DEBUG
+#include <cstdio>
+#include <cstdlib>
+#endif
 
 namespace sigcpp
 {
+#if SIGCPP_ITERATOR_DEBUG
+	//called with a description when a checked iterator detects misuse
+	//-the handler may throw to recover; the program aborts if it returns
+	inline void (*iterator_failure_handler)(const char* msg) = nullptr;
+
+	[[noreturn]] inline void _iterator_failure(const char* msg)
+	{
+		if (iterator_failure_handler)
+			iterator_failure_handler(msg);
+
+		std::fputs(msg, stderr);
+		std::fputc('\n', stderr);
+		std::abort();
+	}
+#endif
+
 	template<typename P> //P is a pointer type
 	class array_iterator
 	{
@@ -32,25 +57,62 @@ namespace sigcpp
 		using reference = typename std::iterator_traits<P>::reference;
 
 		//ctors
-		array_iterator() noexcept = default;
-		array_iterator(P p) noexcept : basePtr(p){}
+		//-an iterator made from just a pointer is never checked
+		//-the range [first, last) is retained only if iterators are checked
+		//or instrumented
+		constexpr array_iterator() noexcept = default;
+		constexpr array_iterator(P p) noexcept : basePtr(p){}
+
+#if SIGCPP_ITERATOR_DEBUG || SIGCPP_INSTRUMENT
+		constexpr array_iterator(P p, P first, P last) noexcept
+			: basePtr(p), rangeFirst(first), rangeLast(last) {}
+#else
+		constexpr array_iterator(P p, P, P) noexcept : basePtr(p){}
+#endif
+
+		//conversion from iterator to const_iterator
+		template<typename Q,
+			typename = std::enable_if_t<std::is_convertible_v<Q, P>>>
+		constexpr array_iterator(const array_iterator<Q>& it) noexcept
+#if SIGCPP_ITERATOR_DEBUG || SIGCPP_INSTRUMENT
+			: basePtr(it.basePtr), rangeFirst(it.rangeFirst),
+			rangeLast(it.rangeLast) {}
+#else
+			: basePtr(it.basePtr) {}
+#endif
 
 		//the wrapped iter
 		constexpr P base() const noexcept { return basePtr; }
 
 		//dereference and member access
-		constexpr reference operator*() const { return *basePtr; }
-		constexpr pointer operator->() const noexcept { return basePtr; }
+		constexpr reference operator*() const
+		{
+			_check_deref(0);
+			_instrument(0, access_kind::deref);
+			return *basePtr;
+		}
+
+		constexpr pointer operator->() const
+			noexcept(!SIGCPP_ITERATOR_DEBUG && !SIGCPP_INSTRUMENT)
+		{
+			_check_deref(0);
+			_instrument(0, access_kind::deref);
+			return basePtr;
+		}
 		
 		//element access
 		constexpr reference operator[](difference_type n) const
 		{
+			_check_deref(n);
+			_instrument(n, access_kind::deref);
 			return basePtr[n];
 		}
 
 		//increment and decrement
 		constexpr array_iterator& operator++() 
 		{
+			_check_move(1);
+			_instrument(1, access_kind::move);
 			++basePtr;
 			return *this;
 		}
@@ -58,12 +120,14 @@ namespace sigcpp
 		constexpr array_iterator operator++(int) 
 		{
 			array_iterator beforeIncrement = *this;
-			++basePtr;
+			++*this;
 			return beforeIncrement;
 		}
 
 		constexpr array_iterator& operator--() 
 		{
+			_check_move(-1);
+			_instrument(-1, access_kind::move);
 			--basePtr;
 			return *this;
 		}
@@ -71,7 +135,7 @@ namespace sigcpp
 		constexpr array_iterator operator--(int) 
 		{
 			array_iterator beforeDecrement = *this;
-			--basePtr;
+			--*this;
 			return beforeDecrement;
 		}
 
@@ -90,42 +154,62 @@ namespace sigcpp
 			return t;
 		}
 
-		array_iterator& operator+=(difference_type n)
+		constexpr array_iterator& operator+=(difference_type n)
 		{
+			_check_move(n);
+			_instrument(n, access_kind::move);
 			basePtr += n;
 			return *this;
 		}
 
-		array_iterator& operator-=(difference_type n)
+		constexpr array_iterator& operator-=(difference_type n)
 		{
+			_check_move(-n);
+			_instrument(-n, access_kind::move);
 			basePtr -= n;
 			return *this;
 		}
 
+		constexpr difference_type operator-(const array_iterator& r) const
+		{
+			_check_same(r);
+			return basePtr - r.basePtr;
+		}
+
+		friend constexpr array_iterator operator+(difference_type n,
+			const array_iterator& it)
+		{
+			return it + n;
+		}
+
 		//comparison
 		constexpr bool operator==(const array_iterator& r) const 
 		{
+			_check_same(r);
 			return basePtr == r.basePtr;
 		}
 
 		constexpr bool operator!=(const array_iterator& r) const
 		{
+			_check_same(r);
 			return basePtr != r.basePtr;
 		}
 
 		constexpr bool operator<(const array_iterator& r) const
 		{
+			_check_same(r);
 			return basePtr < r.basePtr;
 		}
 
 		constexpr bool operator>(const array_iterator& r) const
 		{
+			_check_same(r);
 			return basePtr > r.basePtr;
 		}
 
 		constexpr bool operator<=(const array_iterator& r) const
 		{
-			return !(r > *this);
+			return !(r < *this);
 		}
 
 		constexpr bool operator>=(const array_iterator& r) const
@@ -134,8 +218,59 @@ namespace sigcpp
 		}
 
 	private:
+		template<typename Q> friend class array_iterator;
+
 		P basePtr{ nullptr };
 
+#if SIGCPP_ITERATOR_DEBUG || SIGCPP_INSTRUMENT
+		P rangeFirst{ nullptr };
+		P rangeLast{ nullptr };
+#endif
+
+		//checks: no-ops if iterators are unchecked or the range is unknown
+		//-offsets are compared, not pointers: forming a pointer out of range
+		//is itself undefined
+
+		//element at offset n from basePtr must be in range
+		constexpr void _check_deref([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (rangeFirst != nullptr &&
+				!(rangeFirst - basePtr <= n && n < rangeLast - basePtr))
+				_iterator_failure("array_iterator: dereference out of range");
+#endif
+		}
+
+		//moving by n must stay within [first, last]
+		constexpr void _check_move([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (rangeFirst != nullptr &&
+				!(rangeFirst - basePtr <= n && n <= rangeLast - basePtr))
+				_iterator_failure("array_iterator: arithmetic out of range");
+#endif
+		}
+
+		//iterators compared or subtracted must share a range
+		constexpr void _check_same([[maybe_unused]] const array_iterator& r) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (rangeFirst != r.rangeFirst || rangeLast != r.rangeLast)
+				_iterator_failure("array_iterator: iterators of different ranges");
+#endif
+		}
+
+		//record access to, or a move by, offset n from basePtr
+		constexpr void _instrument([[maybe_unused]] difference_type n,
+			[[maybe_unused]] access_kind kind) const
+		{
+#if SIGCPP_INSTRUMENT
+			if (rangeFirst != nullptr)
+				_instrument_access(rangeFirst, static_cast<std::size_t>(rangeLast - rangeFirst),
+					static_cast<std::size_t>(basePtr - rangeFirst + n), kind);
+#endif
+		}
+
 	}; //template array_iterator
 
 }	//namespace sigcpp
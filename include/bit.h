@@ -0,0 +1,95 @@
+/*
+* bit.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define bit-manipulation functions for unsigned integers
+* - subset of C++20 [bit.count] for use in C++17
+* - https://timsong-cpp.github.io/cppwp/n4861/bit.count
+*/
+
+#ifndef SIGCPP_BIT_H
+#define SIGCPP_BIT_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "config.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace sigcpp
+{
+	//number of 1 bits in x
+	template<typename U>
+	constexpr int popcount(U x) noexcept
+	{
+		static_assert(std::is_unsigned_v<U>, "popcount requires unsigned type");
+
+#if defined(__GNUC__) || defined(__clang__)
+		if constexpr (sizeof(U) <= sizeof(unsigned))
+			return __builtin_popcount(x);
+		else
+			return __builtin_popcountll(x);
+#else
+		//SWAR count: bit pairs, nibbles, then bytes summed by a multiply
+		std::uint64_t v = x;
+		v = v - ((v >> 1) & 0x5555555555555555ull);
+		v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+		v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return static_cast<int>((v * 0x0101010101010101ull) >> 56);
+#endif
+	}
+
+	//number of consecutive 0 bits starting at the least significant bit
+	//-returns the bit width of U if x is zero
+	template<typename U>
+	constexpr int countr_zero(U x) noexcept
+	{
+		static_assert(std::is_unsigned_v<U>, "countr_zero requires unsigned type");
+
+		if (x == 0)
+			return static_cast<int>(sizeof(U) * 8);
+
+#if defined(__GNUC__) || defined(__clang__)
+		if constexpr (sizeof(U) <= sizeof(unsigned))
+			return __builtin_ctz(x);
+		else
+			return __builtin_ctzll(x);
+#else
+#if defined(_MSC_VER)
+		if (!SIGCPP_IS_CONSTANT_EVALUATED())
+		{
+			unsigned long index;
+	#if defined(_M_X64) || defined(_M_ARM64)
+			_BitScanForward64(&index, x);
+	#else
+			if (static_cast<std::uint32_t>(x) != 0)
+				_BitScanForward(&index, static_cast<unsigned long>(x));
+			else
+			{
+				_BitScanForward(&index,
+					static_cast<unsigned long>(static_cast<std::uint64_t>(x) >> 32));
+				index += 32;
+			}
+	#endif
+			return static_cast<int>(index);
+		}
+#endif
+		int n = 0;
+		for (; (x & 1) == 0; x >>= 1)
+			++n;
+		return n;
+#endif
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,102 @@
+/*
+* config.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define configuration macros shared by sigcpp headers
+*/
+
+#ifndef SIGCPP_CONFIG_H
+#define SIGCPP_CONFIG_H
+
+#include <type_traits>
+
+//SIGCPP_IS_CONSTANT_EVALUATED(): true if evaluated in a constant expression
+//- lets a constexpr function use non-constexpr fast paths (memcpy, memset,
+//  intrinsics) at run time and portable code during constant evaluation
+//- evaluates to true if the compiler cannot tell: fast paths are then never
+//  taken, but the function remains usable in constant expressions
+#if defined(__cpp_lib_is_constant_evaluated)
+	#define SIGCPP_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif defined(__GNUC__) && __GNUC__ >= 9
+	#define SIGCPP_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#elif defined(__clang__) && defined(__has_builtin)
+	#if __has_builtin(__builtin_is_constant_evaluated)
+		#define SIGCPP_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+	#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+	#define SIGCPP_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+#ifndef SIGCPP_IS_CONSTANT_EVALUATED
+	#define SIGCPP_IS_CONSTANT_EVALUATED() true
+#endif
+
+//SIGCPP_NOINLINE, SIGCPP_COLD: keep rarely-run code out of line and out of
+//the hot path, e.g., functions that only throw
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define SIGCPP_NOINLINE __declspec(noinline)
+	#define SIGCPP_COLD
+#elif defined(__GNUC__) || defined(__clang__)
+	#define SIGCPP_NOINLINE __attribute__((noinline))
+	#define SIGCPP_COLD __attribute__((cold))
+#else
+	#define SIGCPP_NOINLINE
+	#define SIGCPP_COLD
+#endif
+
+//SIGCPP_FORCEINLINE, SIGCPP_INLINE_LAMBDA: inline a function (before its
+//declaration) or a lambda (after its parameter list) into each caller, e.g.,
+//unrolled loops and their bodies: nested bodies are otherwise often called
+//out of line
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define SIGCPP_FORCEINLINE __forceinline
+	#define SIGCPP_INLINE_LAMBDA
+#elif defined(__GNUC__) || defined(__clang__)
+	#define SIGCPP_FORCEINLINE __attribute__((always_inline)) inline
+	#define SIGCPP_INLINE_LAMBDA __attribute__((always_inline))
+#else
+	#define SIGCPP_FORCEINLINE inline
+	#define SIGCPP_INLINE_LAMBDA
+#endif
+
+//SIGCPP_ITERATOR_DEBUG: 1 for checked iterators, 0 for unchecked iterators
+//- checked iterators retain their range and trap on out-of-range access,
+//  arithmetic out of range, and comparison of iterators of different ranges
+//- unchecked iterators have exactly the layout of the wrapped pointer, unless
+//  SIGCPP_INSTRUMENT is 1
+//- defaults to 1 if NDEBUG is not defined (as with assert), else 0
+//- all translation units in a program must use the same value
+#ifndef SIGCPP_ITERATOR_DEBUG
+	#ifdef NDEBUG
+		#define SIGCPP_ITERATOR_DEBUG 0
+	#else
+		#define SIGCPP_ITERATOR_DEBUG 1
+	#endif
+#endif
+
+//SIGCPP_STREAM_THRESHOLD: bytes at and above which stream_fill and
+//stream_copy use non-temporal stores (see stream.h)
+//- data this large is unlikely to be in cache when next read: bypassing the
+//  cache keeps the working set of this and other cores in place
+//- defaults to 4 MiB; all translation units must use the same value
+#ifndef SIGCPP_STREAM_THRESHOLD
+	#define SIGCPP_STREAM_THRESHOLD (4u << 20)
+#endif
+
+//SIGCPP_INSTRUMENT: 1 to record accesses to arrays and their iterators
+//- counts, strides, and heat maps of accesses per array, reported at exit
+//  (see instrument.h); much slower: for profiling builds only
+//- iterators then retain their range, as checked iterators do
+//- defaults to 0: instrumentation compiles to nothing
+//- all translation units in a program must use the same value
+#ifndef SIGCPP_INSTRUMENT
+	#define SIGCPP_INSTRUMENT 0
+#endif
+
+#endif
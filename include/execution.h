@@ -0,0 +1,373 @@
+/*
+* execution.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define execution policies and parallel algorithms on array: for_each,
+* transform, reduce, sort, and fill
+* - modeled on C++17 [execution] and [algorithms.parallel]
+* - each algorithm takes an array or a range of array_iterator
+* - par and par_unseq split [0, N) into chunks that run on
+*   thread_pool::instance(); par_unseq is par with chunk loops over raw
+*   pointers, which compilers may vectorize
+* - chunk sizes are whole cache lines of elements, so chunks of an
+*   aligned_array<T, N, cache_line_size> never share a line; for arrays the
+*   chunking is decided at compile time
+* - ranges of fewer than SIGCPP_PARALLEL_THRESHOLD bytes run sequentially
+* - reduce combines per-chunk results in chunk order: op must be
+*   associative; floating-point results may differ from a sequential reduce
+*/
+
+#ifndef SIGCPP_EXECUTION_H
+#define SIGCPP_EXECUTION_H
+
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "array.h"
+#include "aligned_array.h"
+#include "thread_pool.h"
+
+//SIGCPP_PARALLEL_THRESHOLD: size in bytes below which parallel policies
+//run sequentially: starting threads costs more than it saves
+#ifndef SIGCPP_PARALLEL_THRESHOLD
+	#define SIGCPP_PARALLEL_THRESHOLD (std::size_t(1) << 16)
+#endif
+
+namespace sigcpp::execution
+{
+	struct sequenced_policy {};
+	struct parallel_policy {};
+	struct parallel_unsequenced_policy {};
+
+	inline constexpr sequenced_policy seq{};
+	inline constexpr parallel_policy par{};
+	inline constexpr parallel_unsequenced_policy par_unseq{};
+
+	template<typename P>
+	inline constexpr bool is_execution_policy_v =
+		std::is_same_v<P, sequenced_policy> ||
+		std::is_same_v<P, parallel_policy> ||
+		std::is_same_v<P, parallel_unsequenced_policy>;
+
+}	//namespace sigcpp::execution
+
+namespace sigcpp
+{
+	//most chunks a range is split into: bounds per-chunk results of reduce
+	inline constexpr std::size_t parallel_max_chunks = 64;
+
+	//smallest chunk worth a task switch
+	inline constexpr std::size_t parallel_min_chunk_bytes = 1 << 14;
+
+	template<typename Policy>
+	using _enable_if_policy = std::enable_if_t<
+		execution::is_execution_policy_v<std::decay_t<Policy>>, int>;
+
+	template<typename Policy>
+	inline constexpr bool _is_parallel =
+		!std::is_same_v<std::decay_t<Policy>, execution::sequenced_policy>;
+
+	//elements per chunk for a range of n elements of type T
+	//-a multiple of the elements in a cache line, and at least
+	//parallel_min_chunk_bytes, but no more than parallel_max_chunks chunks
+	template<typename T>
+	constexpr std::size_t _chunk_size(std::size_t n) noexcept
+	{
+		constexpr std::size_t line =
+			sizeof(T) < cache_line_size ? cache_line_size / sizeof(T) : 1;
+		constexpr std::size_t least =
+			sizeof(T) < parallel_min_chunk_bytes ? parallel_min_chunk_bytes / sizeof(T) : 1;
+
+		const std::size_t even = (n + parallel_max_chunks - 1) / parallel_max_chunks;
+		const std::size_t c = even > least ? even : least;
+		return (c + line - 1) / line * line;
+	}
+
+	template<typename T>
+	constexpr bool _run_parallel(std::size_t n) noexcept
+	{
+		return n * sizeof(T) >= SIGCPP_PARALLEL_THRESHOLD;
+	}
+
+	//call body(first, last) over chunks of [0, n): in parallel unless the
+	//policy is seq or the range is small
+	template<typename Policy, typename T, typename Body>
+	void _for_chunks(std::size_t n, Body&& body)
+	{
+		if constexpr (_is_parallel<Policy>)
+		{
+			if (_run_parallel<T>(n))
+			{
+				const std::size_t c = _chunk_size<T>(n);
+				thread_pool::instance().parallel_for((n + c - 1) / c,
+					[n, c, &body](std::size_t i) {
+						const std::size_t first = i * c;
+						body(first, first + c < n ? first + c : n);
+					});
+				return;
+			}
+		}
+
+		body(std::size_t(0), n);
+	}
+
+	//as _for_chunks, but with the size and so the chunking fixed at compile time
+	template<typename Policy, typename T, std::size_t N, typename Body>
+	void _for_chunks(Body&& body)
+	{
+		if constexpr (_is_parallel<Policy> && _run_parallel<T>(N))
+		{
+			constexpr std::size_t c = _chunk_size<T>(N);
+			constexpr std::size_t chunks = (N + c - 1) / c;
+
+			thread_pool::instance().parallel_for(chunks, [&body](std::size_t i) {
+				const std::size_t first = i * c;
+				body(first, first + c < N ? first + c : N);
+			});
+		}
+		else
+			body(std::size_t(0), N);
+	}
+
+	//raw pointer to the first element of a range; checks the range if
+	//iterators are checked
+	template<typename P>
+	std::pair<P, std::size_t> _raw_range(array_iterator<P> first,
+		array_iterator<P> last)
+	{
+		const auto n = last - first;
+		return { first.base(), static_cast<std::size_t>(n) };
+	}
+
+
+	//for_each
+	template<typename Policy, typename T, std::size_t N, typename F,
+		_enable_if_policy<Policy> = 0>
+	void for_each(Policy&&, array<T, N>& a, F f)
+	{
+		T* p = a.data();
+		_for_chunks<Policy, T, N>([p, &f](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i)
+				f(p[i]);
+		});
+	}
+
+	template<typename Policy, typename P, typename F, _enable_if_policy<Policy> = 0>
+	void for_each(Policy&&, array_iterator<P> first, array_iterator<P> last, F f)
+	{
+		using T = typename array_iterator<P>::value_type;
+		const auto [p, n] = _raw_range(first, last);
+		_for_chunks<Policy, T>(n, [p = p, &f](std::size_t b, std::size_t e) {
+			for (std::size_t i = b; i < e; ++i)
+				f(p[i]);
+		});
+	}
+
+
+	//transform: unary and binary
+	template<typename Policy, typename T, typename U, std::size_t N, typename F,
+		_enable_if_policy<Policy> = 0>
+	void transform(Policy&&, const array<T, N>& a, array<U, N>& out, F f)
+	{
+		const T* p = a.data();
+		U* q = out.data();
+		_for_chunks<Policy, U, N>([p, q, &f](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i)
+				q[i] = f(p[i]);
+		});
+	}
+
+	template<typename Policy, typename T1, typename T2, typename U, std::size_t N,
+		typename F, _enable_if_policy<Policy> = 0>
+	void transform(Policy&&, const array<T1, N>& a, const array<T2, N>& b,
+		array<U, N>& out, F f)
+	{
+		const T1* p = a.data();
+		const T2* r = b.data();
+		U* q = out.data();
+		_for_chunks<Policy, U, N>([p, r, q, &f](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i)
+				q[i] = f(p[i], r[i]);
+		});
+	}
+
+	template<typename Policy, typename P, typename Q, typename F,
+		_enable_if_policy<Policy> = 0>
+	array_iterator<Q> transform(Policy&&, array_iterator<P> first,
+		array_iterator<P> last, array_iterator<Q> out, F f)
+	{
+		using U = typename array_iterator<Q>::value_type;
+		const auto [p, n] = _raw_range(first, last);
+		const auto end = out + static_cast<std::ptrdiff_t>(n);
+		Q q = out.base();
+
+		_for_chunks<Policy, U>(n, [p = p, q, &f](std::size_t b, std::size_t e) {
+			for (std::size_t i = b; i < e; ++i)
+				q[i] = f(p[i]);
+		});
+		return end;
+	}
+
+
+	//reduce: per-chunk results are combined in chunk order
+	template<typename T, std::size_t Chunks, typename BinaryOp>
+	T _combine(T init, array<T, Chunks>& partial, std::size_t chunks, BinaryOp& op)
+	{
+		for (std::size_t i = 0; i < chunks; ++i)
+			init = op(std::move(init), std::move(partial[i]));
+		return init;
+	}
+
+	template<typename T, typename P, typename BinaryOp>
+	T _reduce_range(P p, std::size_t first, std::size_t last, BinaryOp& op)
+	{
+		T sum = p[first];
+		for (std::size_t i = first + 1; i < last; ++i)
+			sum = op(std::move(sum), p[i]);
+		return sum;
+	}
+
+	template<typename Policy, typename T, std::size_t N,
+		typename BinaryOp = std::plus<>, _enable_if_policy<Policy> = 0>
+	T reduce(Policy&&, const array<T, N>& a, T init, BinaryOp op = BinaryOp())
+	{
+		if constexpr (N == 0)
+			return init;
+		else if constexpr (_is_parallel<Policy> && _run_parallel<T>(N))
+		{
+			constexpr std::size_t c = _chunk_size<T>(N);
+			constexpr std::size_t chunks = (N + c - 1) / c;
+
+			array<T, chunks> partial{};
+			const T* p = a.data();
+			thread_pool::instance().parallel_for(chunks, [&](std::size_t i) {
+				const std::size_t first = i * c;
+				partial[i] = _reduce_range<T>(p, first, first + c < N ? first + c : N, op);
+			});
+			return _combine(std::move(init), partial, chunks, op);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < N; ++i)
+				init = op(std::move(init), a[i]);
+			return init;
+		}
+	}
+
+	template<typename Policy, typename P, typename T,
+		typename BinaryOp = std::plus<>, _enable_if_policy<Policy> = 0>
+	T reduce(Policy&&, array_iterator<P> first, array_iterator<P> last, T init,
+		BinaryOp op = BinaryOp())
+	{
+		using V = typename array_iterator<P>::value_type;
+		const auto [p, n] = _raw_range(first, last);
+
+		if constexpr (_is_parallel<Policy>)
+		{
+			if (_run_parallel<V>(n))
+			{
+				const std::size_t c = _chunk_size<V>(n);
+				const std::size_t chunks = (n + c - 1) / c;
+
+				array<T, parallel_max_chunks> partial{};
+				thread_pool::instance().parallel_for(chunks, [&, p = p](std::size_t i) {
+					const std::size_t b = i * c;
+					partial[i] = _reduce_range<T>(p, b, b + c < n ? b + c : n, op);
+				});
+				return _combine(std::move(init), partial, chunks, op);
+			}
+		}
+
+		for (std::size_t i = 0; i < n; ++i)
+			init = op(std::move(init), p[i]);
+		return init;
+	}
+
+
+	//sort: chunks are sorted in parallel, then merged pairwise in rounds
+	template<typename Policy, typename T, typename Compare>
+	void _sort(T* p, std::size_t n, Compare& comp)
+	{
+		if constexpr (_is_parallel<Policy>)
+		{
+			if (_run_parallel<T>(n))
+			{
+				const std::size_t c = _chunk_size<T>(n);
+				const std::size_t chunks = (n + c - 1) / c;
+				auto bound = [n](std::size_t i) { return i < n ? i : n; };
+
+				thread_pool& pool = thread_pool::instance();
+				pool.parallel_for(chunks, [&](std::size_t i) {
+					std::sort(p + i * c, p + bound((i + 1) * c), comp);
+				});
+
+				for (std::size_t width = c; width < n; width *= 2)
+				{
+					const std::size_t pairs = (n + 2 * width - 1) / (2 * width);
+					pool.parallel_for(pairs, [&](std::size_t i) {
+						const std::size_t first = i * 2 * width;
+						std::inplace_merge(p + first, p + bound(first + width),
+							p + bound(first + 2 * width), comp);
+					});
+				}
+				return;
+			}
+		}
+
+		std::sort(p, p + n, comp);
+	}
+
+	template<typename Policy, typename T, std::size_t N,
+		typename Compare = std::less<>, _enable_if_policy<Policy> = 0>
+	void sort(Policy&&, array<T, N>& a, Compare comp = Compare())
+	{
+		_sort<Policy>(a.data(), N, comp);
+	}
+
+	template<typename Policy, typename P, typename Compare = std::less<>,
+		_enable_if_policy<Policy> = 0>
+	void sort(Policy&&, array_iterator<P> first, array_iterator<P> last,
+		Compare comp = Compare())
+	{
+		const auto [p, n] = _raw_range(first, last);
+		_sort<Policy>(p, n, comp);
+	}
+
+
+	//fill
+	template<typename Policy, typename T, std::size_t N, _enable_if_policy<Policy> = 0>
+	void fill(Policy&&, array<T, N>& a, const T& value)
+	{
+		//copy first: value may alias an element
+		const T v = value;
+		T* p = a.data();
+		_for_chunks<Policy, T, N>([p, &v](std::size_t first, std::size_t last) {
+			std::fill(p + first, p + last, v);
+		});
+	}
+
+	template<typename Policy, typename P, typename T, _enable_if_policy<Policy> = 0>
+	void fill(Policy&&, array_iterator<P> first, array_iterator<P> last,
+		const T& value)
+	{
+		using V = typename array_iterator<P>::value_type;
+		const V v = value;
+		const auto [p, n] = _raw_range(first, last);
+		_for_chunks<Policy, V>(n, [p = p, &v](std::size_t b, std::size_t e) {
+			std::fill(p + b, p + e, v);
+		});
+	}
+
+}	//namespace sigcpp
+
+#endif
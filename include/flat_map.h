@@ -0,0 +1,528 @@
+/*
+* flat_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a sorted map adaptor over contiguous storage
+* - modeled on C++23 flat_map: https://wg21.link/p0429
+* - flat_map<Key, T, KeyContainer, MappedContainer> keeps keys and values in
+*   two containers: a lookup reads only keys
+* - storage is array for immutable tables, static_vector for mutable ones;
+*   both containers are of the same kind and capacity
+* - over array, every operation is constexpr: a table built with
+*   make_flat_map is sorted and checked at compile time; duplicate keys throw
+*   std::invalid_argument, a compile error in constant evaluation
+* - over static_vector, insert and erase shift keys and values; of equal keys
+*   in initial containers, the first is kept
+* - layouts, lookup, and Compare are as in flat_set: see flat_set.h
+* - iterators are random access and yield pair<const Key&, T&> by value
+*/
+
+#ifndef SIGCPP_FLAT_MAP_H
+#define SIGCPP_FLAT_MAP_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include "throw.h"
+#include "array.h"
+#include "static_vector.h"
+#include "sort.h"
+#include "search.h"
+#include "flat_set.h"
+
+namespace sigcpp
+{
+	//random-access iterator over a key iterator and a value iterator in step
+	template<typename KeyIt, typename ValueIt>
+	class flat_map_iterator
+	{
+	public:
+
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::pair<typename std::iterator_traits<KeyIt>::value_type,
+			typename std::iterator_traits<ValueIt>::value_type>;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::pair<typename std::iterator_traits<KeyIt>::reference,
+			typename std::iterator_traits<ValueIt>::reference>;
+
+		//operator-> yields a pair held by value
+		struct pointer
+		{
+			reference r;
+			constexpr const reference* operator->() const noexcept { return &r; }
+		};
+
+		//ctors
+		constexpr flat_map_iterator() = default;
+		constexpr flat_map_iterator(KeyIt k, ValueIt v) : keyIt(k), valueIt(v) {}
+
+		//conversion from iterator to const_iterator
+		template<typename K, typename V,
+			typename = std::enable_if_t<std::is_convertible_v<K, KeyIt> &&
+				std::is_convertible_v<V, ValueIt>>>
+		constexpr flat_map_iterator(const flat_map_iterator<K, V>& it)
+			: keyIt(it.key_iterator()), valueIt(it.value_iterator()) {}
+
+		constexpr KeyIt key_iterator() const { return keyIt; }
+		constexpr ValueIt value_iterator() const { return valueIt; }
+
+		//dereference and element access
+		constexpr reference operator*() const { return reference(*keyIt, *valueIt); }
+		constexpr pointer operator->() const { return pointer{ **this }; }
+
+		constexpr reference operator[](difference_type n) const
+		{
+			return reference(keyIt[n], valueIt[n]);
+		}
+
+		//increment and decrement
+		constexpr flat_map_iterator& operator++()
+		{
+			++keyIt;
+			++valueIt;
+			return *this;
+		}
+
+		constexpr flat_map_iterator operator++(int)
+		{
+			flat_map_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		constexpr flat_map_iterator& operator--()
+		{
+			--keyIt;
+			--valueIt;
+			return *this;
+		}
+
+		constexpr flat_map_iterator operator--(int)
+		{
+			flat_map_iterator beforeDecrement = *this;
+			--*this;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr flat_map_iterator operator+(difference_type n) const
+		{
+			return flat_map_iterator(keyIt + n, valueIt + n);
+		}
+
+		constexpr flat_map_iterator operator-(difference_type n) const
+		{
+			return flat_map_iterator(keyIt - n, valueIt - n);
+		}
+
+		constexpr flat_map_iterator& operator+=(difference_type n)
+		{
+			keyIt += n;
+			valueIt += n;
+			return *this;
+		}
+
+		constexpr flat_map_iterator& operator-=(difference_type n)
+		{
+			keyIt -= n;
+			valueIt -= n;
+			return *this;
+		}
+
+		constexpr difference_type operator-(const flat_map_iterator& r) const
+		{
+			return keyIt - r.keyIt;
+		}
+
+		friend constexpr flat_map_iterator operator+(difference_type n,
+			const flat_map_iterator& it)
+		{
+			return it + n;
+		}
+
+		//comparison: key iterators only
+		constexpr bool operator==(const flat_map_iterator& r) const { return keyIt == r.keyIt; }
+		constexpr bool operator!=(const flat_map_iterator& r) const { return keyIt != r.keyIt; }
+		constexpr bool operator<(const flat_map_iterator& r) const { return keyIt < r.keyIt; }
+		constexpr bool operator>(const flat_map_iterator& r) const { return keyIt > r.keyIt; }
+		constexpr bool operator<=(const flat_map_iterator& r) const { return keyIt <= r.keyIt; }
+		constexpr bool operator>=(const flat_map_iterator& r) const { return keyIt >= r.keyIt; }
+
+	private:
+		KeyIt keyIt{};
+		ValueIt valueIt{};
+
+	}; //template flat_map_iterator
+
+
+	//max_size of a container whose capacity is part of its type, such as
+	//static_vector; 0 for containers that can grow on the heap
+	template<typename C, typename = void>
+	inline constexpr std::size_t _static_max_size = 0;
+
+	template<typename C>
+	inline constexpr std::size_t _static_max_size<C,
+		std::void_t<std::integral_constant<std::size_t, C::max_size()>>> = C::max_size();
+
+
+	template<typename Key, typename T, typename KeyContainer, typename MappedContainer,
+		typename Compare = std::less<Key>, typename Layout = sorted_layout>
+	class flat_map
+	{
+		static_assert(std::is_same_v<Key, typename KeyContainer::value_type>,
+			"KeyContainer must hold Key");
+		static_assert(std::is_same_v<T, typename MappedContainer::value_type>,
+			"MappedContainer must hold T");
+		static_assert(_is_fixed_size<KeyContainer> == _is_fixed_size<MappedContainer>,
+			"KeyContainer and MappedContainer must both be fixed-size or resizable");
+		static_assert(std::is_same_v<Layout, sorted_layout> || _is_fixed_size<KeyContainer>,
+			"eytzinger_layout requires fixed-size storage");
+		static_assert(_static_max_size<KeyContainer> == _static_max_size<MappedContainer>,
+			"KeyContainer and MappedContainer must have the same capacity");
+
+		static constexpr bool fixed = _is_fixed_size<KeyContainer>;
+		static constexpr bool sorted = std::is_same_v<Layout, sorted_layout>;
+
+	public:
+		//types
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<Key, T>;
+		using key_compare = Compare;
+		using key_container_type = KeyContainer;
+		using mapped_container_type = MappedContainer;
+		using layout_type = Layout;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = flat_map_iterator<typename KeyContainer::const_iterator,
+			typename MappedContainer::iterator>;
+		using const_iterator = flat_map_iterator<typename KeyContainer::const_iterator,
+			typename MappedContainer::const_iterator>;
+		using reference = typename iterator::reference;
+		using const_reference = typename const_iterator::reference;
+
+		//ctors
+		//-an empty map only over resizable storage
+		template<typename C = KeyContainer, typename = std::enable_if_t<!_is_fixed_size<C>>>
+		flat_map() noexcept {}
+
+		constexpr flat_map(const KeyContainer& keys, const MappedContainer& values)
+		{
+			if (keys.size() != values.size())
+				_throw_invalid_argument("flat_map key and value counts differ");
+
+			if constexpr (fixed)
+			{
+				_sort_fixed(keys, values);
+				_check_unique<Compare>(k.data(), k.size(), "flat_map keys not unique");
+				_to_layout();
+			}
+			else
+				for (size_type i = 0; i < keys.size(); ++i)
+					try_emplace(keys[i], values[i]);
+		}
+
+		constexpr flat_map(sorted_unique_t, const KeyContainer& keys,
+			const MappedContainer& values)
+			: k(keys), v(values)
+		{
+			if (keys.size() != values.size())
+				_throw_invalid_argument("flat_map key and value counts differ");
+			_to_layout();
+		}
+
+		template<typename C = KeyContainer, typename = std::enable_if_t<!_is_fixed_size<C>>>
+		flat_map(std::initializer_list<value_type> list)
+		{
+			for (const value_type& e : list)
+				try_emplace(e.first, e.second);
+		}
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(k.cbegin(), v.begin()); }
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr iterator end() noexcept { return iterator(k.cend(), v.end()); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr const_iterator cbegin() const noexcept
+		{
+			return const_iterator(k.cbegin(), v.cbegin());
+		}
+
+		constexpr const_iterator cend() const noexcept
+		{
+			return const_iterator(k.cend(), v.cend());
+		}
+
+		//capacity
+		constexpr bool empty() const noexcept { return k.size() == 0; }
+		constexpr size_type size() const noexcept { return k.size(); }
+		constexpr size_type max_size() const noexcept { return k.max_size(); }
+
+		//lookup
+		constexpr iterator find(const Key& key) { return begin() + _offset(_find(key)); }
+
+		constexpr const_iterator find(const Key& key) const
+		{
+			return begin() + _offset(_find(key));
+		}
+
+		constexpr bool contains(const Key& key) const { return _find(key) != size(); }
+		constexpr size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+		constexpr T& at(const Key& key) { return v[_at(key)]; }
+		constexpr const T& at(const Key& key) const { return v[_at(key)]; }
+
+		//ordered lookup: sorted layout only
+		constexpr iterator lower_bound(const Key& key)
+		{
+			return begin() + _offset(_lower_bound_sorted(key));
+		}
+
+		constexpr const_iterator lower_bound(const Key& key) const
+		{
+			return begin() + _offset(_lower_bound_sorted(key));
+		}
+
+		constexpr iterator upper_bound(const Key& key)
+		{
+			return begin() + _offset(_upper_bound(key));
+		}
+
+		constexpr const_iterator upper_bound(const Key& key) const
+		{
+			return begin() + _offset(_upper_bound(key));
+		}
+
+		constexpr std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+		{
+			const size_type i = _lower_bound_sorted(key);
+			const bool found = i != size() && !Compare()(key, k[i]);
+			return { begin() + _offset(i), begin() + _offset(found ? i + 1 : i) };
+		}
+
+		//modifiers: resizable storage only
+		//-a new key in a full map throws std::length_error
+		T& operator[](const Key& key) { return try_emplace(key).first->second; }
+		T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+		std::pair<iterator, bool> insert(const value_type& e)
+		{
+			return try_emplace(e.first, e.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& e)
+		{
+			return try_emplace(std::move(e.first), std::move(e.second));
+		}
+
+		//insert only if key is absent; args are not used otherwise
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			return _try_emplace(key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+		{
+			return _try_emplace(std::move(key), std::forward<Args>(args)...);
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const Key& key, M&& m)
+		{
+			std::pair<iterator, bool> r = try_emplace(key, std::forward<M>(m));
+			if (!r.second)
+				r.first->second = std::forward<M>(m);
+			return r;
+		}
+
+		size_type erase(const Key& key)
+		{
+			const size_type i = _find(key);
+			if (i == size())
+				return 0;
+
+			erase(begin() + _offset(i));
+			return 1;
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			static_assert(!fixed, "erase requires resizable storage");
+
+			const difference_type i = pos.key_iterator() - k.cbegin();
+			k.erase(pos.key_iterator());
+			v.erase(pos.value_iterator());
+			return begin() + i;
+		}
+
+		iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+		void clear() noexcept
+		{
+			static_assert(!fixed, "clear requires resizable storage");
+			k.clear();
+			v.clear();
+		}
+
+		//observers
+		constexpr key_compare key_comp() const { return key_compare(); }
+		constexpr const KeyContainer& keys() const noexcept { return k; }
+		constexpr const MappedContainer& values() const noexcept { return v; }
+
+	private:
+		KeyContainer k{};
+		MappedContainer v{};
+
+		static constexpr difference_type _offset(size_type i) noexcept
+		{
+			return static_cast<difference_type>(i);
+		}
+
+		constexpr size_type _lower_bound(const Key& key) const
+		{
+			return _flat_lower_bound<Layout, Compare>(k.data(), size(), key);
+		}
+
+		constexpr size_type _lower_bound_sorted(const Key& key) const
+		{
+			static_assert(sorted, "lower_bound and equal_range require sorted_layout");
+			return _lower_bound(key);
+		}
+
+		constexpr size_type _upper_bound(const Key& key) const
+		{
+			static_assert(sorted, "upper_bound requires sorted_layout");
+			const Key* p = k.data();
+			return static_cast<size_type>(branchless_lower_bound(p, size(), key,
+				[](const Key& e, const Key& x) { return !Compare()(x, e); }) - p);
+		}
+
+		//index of key; size() if absent
+		constexpr size_type _find(const Key& key) const
+		{
+			const size_type i = _lower_bound(key);
+			return i != size() && !Compare()(key, k[i]) ? i : size();
+		}
+
+		constexpr size_type _at(const Key& key) const
+		{
+			const size_type i = _find(key);
+			if (i == size())
+				_throw_out_of_range("flat_map key not found");
+			return i;
+		}
+
+		//sort keys and values together by sorting their indices
+		constexpr void _sort_fixed(const KeyContainer& keys, const MappedContainer& values)
+		{
+			constexpr std::size_t N = std::tuple_size<KeyContainer>::value;
+
+			array<std::size_t, N> order{};
+			for (std::size_t i = 0; i < N; ++i)
+				order[i] = i;
+
+			sigcpp::sort(order, [&keys](std::size_t a, std::size_t b) {
+				return Compare()(keys[a], keys[b]);
+			});
+
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				k[i] = keys[order[i]];
+				v[i] = values[order[i]];
+			}
+		}
+
+		constexpr void _to_layout()
+		{
+			if constexpr (!sorted)
+			{
+				k = to_eytzinger(k);
+				v = to_eytzinger(v);
+			}
+		}
+
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> _try_emplace(K&& key, Args&&... args)
+		{
+			static_assert(!fixed, "insert requires resizable storage");
+
+			const size_type i = _lower_bound(key);
+			if (i != size() && !Compare()(key, k[i]))
+				return { begin() + _offset(i), false };
+
+			if (size() == k.max_size() || size() == v.max_size())
+				_throw_length_error("flat_map capacity exceeded");
+
+			//keys and values stay the same size if the value throws
+			k.insert(k.cbegin() + _offset(i), std::forward<K>(key));
+			try
+			{
+				v.emplace(v.cbegin() + _offset(i), std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				k.erase(k.cbegin() + _offset(i));
+				throw;
+			}
+			return { begin() + _offset(i), true };
+		}
+
+	}; //template flat_map
+
+	template<typename Key, typename T, typename KC, typename MC, typename Compare,
+		typename Layout>
+	constexpr bool operator==(const flat_map<Key, T, KC, MC, Compare, Layout>& a,
+		const flat_map<Key, T, KC, MC, Compare, Layout>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+
+		for (std::size_t i = 0; i < a.size(); ++i)
+			if (!(a.keys()[i] == b.keys()[i]) || !(a.values()[i] == b.values()[i]))
+				return false;
+		return true;
+	}
+
+	template<typename Key, typename T, typename KC, typename MC, typename Compare,
+		typename Layout>
+	constexpr bool operator!=(const flat_map<Key, T, KC, MC, Compare, Layout>& a,
+		const flat_map<Key, T, KC, MC, Compare, Layout>& b)
+	{
+		return !(a == b);
+	}
+
+	//immutable map of the entries of a
+	template<typename Layout = sorted_layout, typename Key, typename T, std::size_t N,
+		typename Compare = std::less<Key>>
+	constexpr flat_map<Key, T, array<Key, N>, array<T, N>, Compare, Layout> make_flat_map(
+		const array<std::pair<Key, T>, N>& a)
+	{
+		array<Key, N> keys{};
+		array<T, N> values{};
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			keys[i] = a[i].first;
+			values[i] = a[i].second;
+		}
+		return flat_map<Key, T, array<Key, N>, array<T, N>, Compare, Layout>(keys, values);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,288 @@
+/*
+* flat_set.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a sorted set adaptor over contiguous storage
+* - modeled on C++23 flat_set: https://wg21.link/p1222
+* - flat_set<Key, KeyContainer> keeps unique keys sorted in KeyContainer:
+*   array<Key, N> for immutable tables, static_vector<Key, N> for mutable
+* - over array, every operation is constexpr: a table built with make_flat_set
+*   is sorted and checked at compile time; duplicate keys throw
+*   std::invalid_argument, which is a compile error in constant evaluation
+* - over static_vector, insert and erase shift elements; duplicates in an
+*   initial container are dropped
+* - lookups use branchless_lower_bound (see search.h); eytzinger_layout
+*   stores array keys in breadth-first order for faster large lookups, and
+*   then iteration follows that order and lower_bound is not available
+* - Compare must be stateless: it is default-constructed at each use
+*/
+
+#ifndef SIGCPP_FLAT_SET_H
+#define SIGCPP_FLAT_SET_H
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include "throw.h"
+#include "array.h"
+#include "static_vector.h"
+#include "sort.h"
+#include "search.h"
+
+namespace sigcpp
+{
+	//key orders for flat_set and flat_map
+	struct sorted_layout {};
+	struct eytzinger_layout {};
+
+	//tag: the container is already sorted and unique
+	struct sorted_unique_t
+	{
+		explicit sorted_unique_t() = default;
+	};
+
+	inline constexpr sorted_unique_t sorted_unique{};
+
+	//true for containers whose size is fixed
+	template<typename C>
+	inline constexpr bool _is_fixed_size = false;
+
+	template<typename T, std::size_t N>
+	inline constexpr bool _is_fixed_size<array<T, N>> = true;
+
+	//index of the first of the n keys at p not ordered before key; n if none
+	template<typename Layout, typename Compare, typename Key, typename K>
+	constexpr std::size_t _flat_lower_bound(const Key* p, std::size_t n, const K& key)
+	{
+		if constexpr (std::is_same_v<Layout, eytzinger_layout>)
+			return eytzinger_lower_bound(p, n, key, Compare());
+		else
+			return static_cast<std::size_t>(branchless_lower_bound(p, n, key, Compare()) - p);
+	}
+
+	//fixed-size containers: the n sorted keys must be unique
+	template<typename Compare, typename Key>
+	constexpr void _check_unique(const Key* p, std::size_t n, const char* msg)
+	{
+		for (std::size_t i = 1; i < n; ++i)
+			if (!Compare()(p[i - 1], p[i]))
+				_throw_invalid_argument(msg);
+	}
+
+	template<typename Key, typename KeyContainer, typename Compare = std::less<Key>,
+		typename Layout = sorted_layout>
+	class flat_set
+	{
+		static_assert(std::is_same_v<Key, typename KeyContainer::value_type>,
+			"KeyContainer must hold Key");
+		static_assert(std::is_same_v<Layout, sorted_layout> || _is_fixed_size<KeyContainer>,
+			"eytzinger_layout requires fixed-size storage");
+
+		static constexpr bool fixed = _is_fixed_size<KeyContainer>;
+		static constexpr bool sorted = std::is_same_v<Layout, sorted_layout>;
+
+	public:
+		//types
+		using key_type = Key;
+		using value_type = Key;
+		using key_compare = Compare;
+		using value_compare = Compare;
+		using container_type = KeyContainer;
+		using layout_type = Layout;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = const Key&;
+		using const_reference = const Key&;
+
+		//keys are not modifiable in place
+		using iterator = typename KeyContainer::const_iterator;
+		using const_iterator = iterator;
+
+		//ctors
+		//-an empty set only over resizable storage
+		template<typename C = KeyContainer, typename = std::enable_if_t<!_is_fixed_size<C>>>
+		flat_set() noexcept {}
+
+		constexpr explicit flat_set(const KeyContainer& c) : k(c)
+		{
+			_sort();
+			_to_layout();
+		}
+
+		constexpr flat_set(sorted_unique_t, const KeyContainer& c) : k(c) { _to_layout(); }
+
+		template<typename C = KeyContainer, typename = std::enable_if_t<!_is_fixed_size<C>>>
+		flat_set(std::initializer_list<Key> list)
+		{
+			for (const Key& key : list)
+				insert(key);
+		}
+
+		//iterators
+		constexpr const_iterator begin() const noexcept { return k.cbegin(); }
+		constexpr const_iterator end() const noexcept { return k.cend(); }
+		constexpr const_iterator cbegin() const noexcept { return k.cbegin(); }
+		constexpr const_iterator cend() const noexcept { return k.cend(); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return k.size() == 0; }
+		constexpr size_type size() const noexcept { return k.size(); }
+		constexpr size_type max_size() const noexcept { return k.max_size(); }
+
+		//lookup
+		constexpr const_iterator find(const Key& key) const
+		{
+			return begin() + static_cast<difference_type>(_find(key));
+		}
+
+		constexpr bool contains(const Key& key) const { return _find(key) != size(); }
+		constexpr size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+		//ordered lookup: sorted layout only
+		constexpr const_iterator lower_bound(const Key& key) const
+		{
+			static_assert(sorted, "lower_bound requires sorted_layout");
+			return begin() + static_cast<difference_type>(_lower_bound(key));
+		}
+
+		constexpr const_iterator upper_bound(const Key& key) const
+		{
+			static_assert(sorted, "upper_bound requires sorted_layout");
+			const Key* p = k.data();
+			const Key* u = branchless_lower_bound(p, size(), key,
+				[](const Key& e, const Key& v) { return !Compare()(v, e); });
+			return begin() + (u - p);
+		}
+
+		constexpr std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+		{
+			const_iterator first = lower_bound(key);
+			const bool found = first != end() && !Compare()(key, *first);
+			return { first, found ? first + 1 : first };
+		}
+
+		//modifiers: resizable storage only
+		//-insert into a full set throws std::length_error
+		std::pair<iterator, bool> insert(const Key& key) { return _insert(key); }
+		std::pair<iterator, bool> insert(Key&& key) { return _insert(std::move(key)); }
+
+		size_type erase(const Key& key)
+		{
+			const size_type i = _find(key);
+			if (i == size())
+				return 0;
+
+			erase(begin() + static_cast<difference_type>(i));
+			return 1;
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			static_assert(!fixed, "erase requires resizable storage");
+			return k.erase(pos);
+		}
+
+		void clear() noexcept
+		{
+			static_assert(!fixed, "clear requires resizable storage");
+			k.clear();
+		}
+
+		//observers
+		constexpr key_compare key_comp() const { return key_compare(); }
+		constexpr value_compare value_comp() const { return value_compare(); }
+		constexpr const KeyContainer& keys() const noexcept { return k; }
+
+	private:
+		KeyContainer k;
+
+		constexpr size_type _lower_bound(const Key& key) const
+		{
+			return _flat_lower_bound<Layout, Compare>(k.data(), size(), key);
+		}
+
+		//index of key; size() if absent
+		constexpr size_type _find(const Key& key) const
+		{
+			const size_type i = _lower_bound(key);
+			return i != size() && !Compare()(key, k[i]) ? i : size();
+		}
+
+		constexpr void _sort()
+		{
+			if constexpr (fixed)
+			{
+				sigcpp::sort(k, Compare());
+				_check_unique<Compare>(k.data(), k.size(), "flat_set keys not unique");
+			}
+			else
+			{
+				std::sort(k.begin(), k.end(), Compare());
+				k.erase(std::unique(k.begin(), k.end(),
+					[](const Key& a, const Key& b) { return !Compare()(a, b); }), k.end());
+			}
+		}
+
+		constexpr void _to_layout()
+		{
+			if constexpr (!sorted)
+				k = to_eytzinger(k);
+		}
+
+		template<typename K>
+		std::pair<iterator, bool> _insert(K&& key)
+		{
+			static_assert(!fixed, "insert requires resizable storage");
+
+			const size_type i = _lower_bound(key);
+			const_iterator pos = begin() + static_cast<difference_type>(i);
+			if (i != size() && !Compare()(key, k[i]))
+				return { pos, false };
+
+			return { k.insert(pos, std::forward<K>(key)), true };
+		}
+
+	}; //template flat_set
+
+	template<typename Key, typename C, typename Compare, typename Layout>
+	constexpr bool operator==(const flat_set<Key, C, Compare, Layout>& a,
+		const flat_set<Key, C, Compare, Layout>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+
+		for (std::size_t i = 0; i < a.size(); ++i)
+			if (!(a.keys()[i] == b.keys()[i]))
+				return false;
+		return true;
+	}
+
+	template<typename Key, typename C, typename Compare, typename Layout>
+	constexpr bool operator!=(const flat_set<Key, C, Compare, Layout>& a,
+		const flat_set<Key, C, Compare, Layout>& b)
+	{
+		return !(a == b);
+	}
+
+	//immutable set of the keys of a
+	template<typename Layout = sorted_layout, typename Key, std::size_t N,
+		typename Compare = std::less<Key>>
+	constexpr flat_set<Key, array<Key, N>, Compare, Layout> make_flat_set(
+		const array<Key, N>& a)
+	{
+		return flat_set<Key, array<Key, N>, Compare, Layout>(a);
+	}
+
+}	//namespace sigcpp
+
+#endif
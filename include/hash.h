@@ -0,0 +1,206 @@
+/*
+* hash.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define hashing for arrays
+* - sigcpp::hash<T> is a customization point: it is std::hash<T> unless
+*   specialized; std::hash<array<T, N>> is sigcpp::hash<array<T, N>>
+* - arrays of elements compared with memcmp (integral, enum, and pointer
+*   elements, and arrays of them) are hashed as one run of bytes; other
+*   arrays mix the sigcpp::hash of each element, so a specialization for a
+*   class type agrees with that type's operator==
+* - the byte hash is wyhash (Wang Yi, public domain): 64x64->128 multiplies
+*   that fold the high half into the low; the length is a template argument
+*   for arrays, so length tests fold and loops have constant trip counts
+* - hash values depend on the seed and on byte order: do not persist them
+*/
+
+#ifndef SIGCPP_HASH_H
+#define SIGCPP_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include "array.h"
+#include "aligned_array.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace sigcpp
+{
+	//customization point: specialize for types without std::hash
+	template<typename T>
+	struct hash : std::hash<T> {};
+
+	inline constexpr std::uint64_t hash_seed = 0xa0761d6478bd642full;
+
+	//64x64 -> 128-bit multiply: a receives the low half, b the high half
+	inline void _multiply128(std::uint64_t& a, std::uint64_t& b) noexcept
+	{
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128 = unsigned __int128;
+		const uint128 r = static_cast<uint128>(a) * b;
+		a = static_cast<std::uint64_t>(r);
+		b = static_cast<std::uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		a = _umul128(a, b, &b);
+#else
+		//four 32x32 -> 64-bit products
+		const std::uint64_t aHi = a >> 32, aLo = static_cast<std::uint32_t>(a);
+		const std::uint64_t bHi = b >> 32, bLo = static_cast<std::uint32_t>(b);
+		const std::uint64_t hh = aHi * bHi, hl = aHi * bLo, lh = aLo * bHi, ll = aLo * bLo;
+
+		const std::uint64_t mid = (ll >> 32) + static_cast<std::uint32_t>(hl) +
+			static_cast<std::uint32_t>(lh);
+		a = (mid << 32) | static_cast<std::uint32_t>(ll);
+		b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+	}
+
+	inline std::uint64_t _mix(std::uint64_t a, std::uint64_t b) noexcept
+	{
+		_multiply128(a, b);
+		return a ^ b;
+	}
+
+	//unaligned native-order reads
+	inline std::uint64_t _read8(const unsigned char* p) noexcept
+	{
+		std::uint64_t v;
+		std::memcpy(&v, p, 8);
+		return v;
+	}
+
+	inline std::uint64_t _read4(const unsigned char* p) noexcept
+	{
+		std::uint32_t v;
+		std::memcpy(&v, p, 4);
+		return v;
+	}
+
+	//wyhash of len bytes at p
+	inline std::uint64_t _wyhash(const unsigned char* p, std::size_t len,
+		std::uint64_t seed) noexcept
+	{
+		constexpr std::uint64_t s0 = 0xa0761d6478bd642full, s1 = 0xe7037ed1a0b428dbull;
+		constexpr std::uint64_t s2 = 0x8ebc6af09c88c6e3ull, s3 = 0x589965cc75374cc3ull;
+
+		seed ^= _mix(seed ^ s0, s1);
+
+		std::uint64_t a, b;
+		if (len <= 16)
+		{
+			if (len >= 4)
+			{
+				const std::size_t k = (len >> 3) << 2;
+				a = (_read4(p) << 32) | _read4(p + k);
+				b = (_read4(p + len - 4) << 32) | _read4(p + len - 4 - k);
+			}
+			else if (len > 0)
+			{
+				a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[len >> 1]) << 8) |
+					p[len - 1];
+				b = 0;
+			}
+			else
+				a = b = 0;
+		}
+		else
+		{
+			std::size_t i = len;
+			if (i > 48)
+			{
+				//three independent lanes of 16 bytes
+				std::uint64_t see1 = seed, see2 = seed;
+				do
+				{
+					seed = _mix(_read8(p) ^ s1, _read8(p + 8) ^ seed);
+					see1 = _mix(_read8(p + 16) ^ s2, _read8(p + 24) ^ see1);
+					see2 = _mix(_read8(p + 32) ^ s3, _read8(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= see1 ^ see2;
+			}
+
+			while (i > 16)
+			{
+				seed = _mix(_read8(p) ^ s1, _read8(p + 8) ^ seed);
+				p += 16;
+				i -= 16;
+			}
+
+			a = _read8(p + i - 16);
+			b = _read8(p + i - 8);
+		}
+
+		a ^= s1;
+		b ^= seed;
+		_multiply128(a, b);
+		return _mix(a ^ s0 ^ len, b ^ s1);
+	}
+
+	//hash of a run of bytes
+	inline std::uint64_t hash_bytes(const void* p, std::size_t len,
+		std::uint64_t seed = hash_seed) noexcept
+	{
+		return _wyhash(static_cast<const unsigned char*>(p), len, seed);
+	}
+
+	//as above, with the length known at compile time
+	template<std::size_t Len>
+	std::uint64_t hash_bytes(const void* p, std::uint64_t seed = hash_seed) noexcept
+	{
+		return _wyhash(static_cast<const unsigned char*>(p), Len, seed);
+	}
+
+	template<typename T, std::size_t N>
+	struct hash<array<T, N>>
+	{
+		std::size_t operator()(const array<T, N>& a) const
+			noexcept(_is_memcmp_equal<T> ||
+				noexcept(hash<T>()(std::declval<const T&>())))
+		{
+			if constexpr (_is_memcmp_equal<T>)
+				return static_cast<std::size_t>(hash_bytes<sizeof(T) * N>(a.data()));
+			else
+			{
+				//mix each element hash in: a multiply folds all bits of both
+				std::uint64_t h = hash_seed ^ N;
+				hash<T> element;
+				for (const T& e : a)
+					h = _mix(h ^ static_cast<std::uint64_t>(element(e)),
+						0xe7037ed1a0b428dbull);
+				return static_cast<std::size_t>(_mix(h, 0x8ebc6af09c88c6e3ull));
+			}
+		}
+	};
+
+	template<typename T, std::size_t N, std::size_t Align>
+	struct hash<aligned_array<T, N, Align>> : hash<array<T, N>> {};
+
+}	//namespace sigcpp
+
+namespace std
+{
+	template<typename T, std::size_t N>
+	struct hash<sigcpp::array<T, N>> : sigcpp::hash<sigcpp::array<T, N>> {};
+
+	template<typename T, std::size_t N, std::size_t Align>
+	struct hash<sigcpp::aligned_array<T, N, Align>>
+		: sigcpp::hash<sigcpp::array<T, N>> {};
+
+}	//namespace std
+
+#endif
@@ -0,0 +1,255 @@
+/*
+* instrument.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define access instrumentation for arrays and array iterators
+* - enabled with SIGCPP_INSTRUMENT (see config.h); otherwise every hook is an
+*   empty inline function and the query functions report nothing
+* - array::operator[], array::at, and dereference of array_iterator record
+*   an access; iterator arithmetic records a move
+* - stats are kept per range, keyed by the address of its first element: an
+*   array, or the elements of a static_vector, span, ...; ranges created at
+*   the same address, such as successive locals, share stats
+* - per range: counts by kind of access, a histogram of strides (distance in
+*   elements from the previous access) in powers of two, the ratio of
+*   accesses out of order (at a lower index than the previous), and a heat
+*   map of accesses over the range
+* - the report is written to stderr at exit if anything was recorded;
+*   instrument_report writes it on demand
+* - recording takes a lock: instrumented code is thread safe, and slow
+* - accesses during constant evaluation are not recorded
+*/
+
+#ifndef SIGCPP_INSTRUMENT_H
+#define SIGCPP_INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "config.h"
+
+#if SIGCPP_INSTRUMENT
+#include <map>
+#include <mutex>
+#endif
+
+namespace sigcpp
+{
+	enum class access_kind { index, checked, deref, move };
+
+	struct access_stats
+	{
+		//bucket 0 is stride 0, bucket k is strides in [2^(k-1), 2^k), and the
+		//last bucket is all larger strides
+		static constexpr std::size_t stride_buckets = 16;
+		static constexpr std::size_t heat_bins = 32;
+
+		std::size_t element_size{ 0 };
+		std::size_t size{ 0 };
+
+		std::uint64_t indexed{ 0 };
+		std::uint64_t checked{ 0 };
+		std::uint64_t derefs{ 0 };
+		std::uint64_t moves{ 0 };
+
+		std::uint64_t backward{ 0 };
+		std::uint64_t strides[stride_buckets]{};
+		std::uint64_t heat[heat_bins]{};
+
+		std::size_t last{ 0 };
+
+		//element accesses: moves excluded
+		std::uint64_t accesses() const noexcept { return indexed + checked + derefs; }
+
+		//fraction of accesses, after the first, at a lower index than the previous
+		double out_of_order_ratio() const noexcept
+		{
+			const std::uint64_t n = accesses();
+			return n < 2 ? 0.0 : static_cast<double>(backward) / static_cast<double>(n - 1);
+		}
+	};
+
+#if SIGCPP_INSTRUMENT
+
+	class _access_log
+	{
+	public:
+		static _access_log& instance()
+		{
+			static _access_log log;
+			return log;
+		}
+
+		_access_log(const _access_log&) = delete;
+		_access_log& operator=(const _access_log&) = delete;
+
+		~_access_log()
+		{
+			if (!stats.empty())
+				report(stderr);
+		}
+
+		void record(const void* first, std::size_t elementSize, std::size_t size,
+			std::size_t index, access_kind kind)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			access_stats& s = _stats(first, elementSize, size);
+
+			if (kind == access_kind::move)
+			{
+				++s.moves;
+				return;
+			}
+
+			if (s.accesses() != 0)
+			{
+				const std::size_t stride = index < s.last ? s.last - index : index - s.last;
+				s.backward += index < s.last;
+				++s.strides[_stride_bucket(stride)];
+			}
+
+			if (kind == access_kind::index)
+				++s.indexed;
+			else if (kind == access_kind::checked)
+				++s.checked;
+			else
+				++s.derefs;
+
+			if (index < size)
+				++s.heat[index * access_stats::heat_bins / size];
+			s.last = index;
+		}
+
+		access_stats find(const void* first) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = stats.find(first);
+			return it == stats.end() ? access_stats() : it->second;
+		}
+
+		void reset()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.clear();
+		}
+
+		void report(std::FILE* out) const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			std::fprintf(out, "sigcpp access report: %zu ranges\n", stats.size());
+			for (const auto& entry : stats)
+				_report(out, entry.first, entry.second);
+		}
+
+	private:
+		_access_log() = default;
+
+		mutable std::mutex mutex;
+		std::map<const void*, access_stats> stats;
+
+		access_stats& _stats(const void* first, std::size_t elementSize, std::size_t size)
+		{
+			access_stats& s = stats[first];
+			s.element_size = elementSize;
+			s.size = size > s.size ? size : s.size;
+			return s;
+		}
+
+		static std::size_t _stride_bucket(std::size_t stride) noexcept
+		{
+			std::size_t b = 0;
+			for (; stride != 0 && b < access_stats::stride_buckets - 1; stride >>= 1)
+				++b;
+			return b;
+		}
+
+		static void _report(std::FILE* out, const void* first, const access_stats& s)
+		{
+			using ull = unsigned long long;
+
+			std::fprintf(out, "%p: %zu x %zu bytes\n", const_cast<void*>(first), s.size,
+				s.element_size);
+			std::fprintf(out, "  accesses %llu ([] %llu, at %llu, iterator %llu), moves %llu\n",
+				static_cast<ull>(s.accesses()), static_cast<ull>(s.indexed),
+				static_cast<ull>(s.checked), static_cast<ull>(s.derefs),
+				static_cast<ull>(s.moves));
+			std::fprintf(out, "  out of order %.1f%%\n", 100 * s.out_of_order_ratio());
+
+			std::fprintf(out, "  strides");
+			for (std::size_t b = 0; b < access_stats::stride_buckets; ++b)
+			{
+				if (s.strides[b] == 0)
+					continue;
+
+				const ull low = b == 0 ? 0 : 1ull << (b - 1);
+				if (b + 1 == access_stats::stride_buckets)
+					std::fprintf(out, " >=%llu:%llu", low, static_cast<ull>(s.strides[b]));
+				else if (b < 2)
+					std::fprintf(out, " %llu:%llu", low, static_cast<ull>(s.strides[b]));
+				else
+					std::fprintf(out, " %llu-%llu:%llu", low, 2 * low - 1,
+						static_cast<ull>(s.strides[b]));
+			}
+
+			//heat relative to the hottest bin
+			std::uint64_t hottest = 0;
+			for (std::uint64_t h : s.heat)
+				hottest = h > hottest ? h : hottest;
+
+			constexpr char shades[] = " .:-=+*#%@";
+			char map[access_stats::heat_bins + 1]{};
+			for (std::size_t i = 0; i < access_stats::heat_bins; ++i)
+				map[i] = s.heat[i] == 0 ? shades[0] : shades[1 + s.heat[i] * 8 / hottest];
+			std::fprintf(out, "\n  heat [%s]\n", map);
+		}
+
+	}; //class _access_log
+
+#endif
+
+	//hooks: called by array and array_iterator
+	template<typename T>
+	constexpr void _instrument_access([[maybe_unused]] const T* first,
+		[[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t index,
+		[[maybe_unused]] access_kind kind)
+	{
+#if SIGCPP_INSTRUMENT
+		if (!SIGCPP_IS_CONSTANT_EVALUATED())
+			_access_log::instance().record(first, sizeof(T), size, index, kind);
+#endif
+	}
+
+	//stats of the range starting at first; all zero if there are none
+	inline access_stats instrument_stats([[maybe_unused]] const void* first)
+	{
+#if SIGCPP_INSTRUMENT
+		return _access_log::instance().find(first);
+#else
+		return access_stats();
+#endif
+	}
+
+	inline void instrument_report([[maybe_unused]] std::FILE* out = stderr)
+	{
+#if SIGCPP_INSTRUMENT
+		_access_log::instance().report(out);
+#endif
+	}
+
+	inline void instrument_reset()
+	{
+#if SIGCPP_INSTRUMENT
+		_access_log::instance().reset();
+#endif
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,437 @@
+/*
+* linalg.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define small fixed-size vector and matrix operations
+* - vectors are array<T, N>; matrices are basic_mdarray<T, L, R, C> with
+*   layout_right (mdarray) or layout_left
+* - dot, axpy, norm; matmul, matvec, transpose; determinant, inverse, and
+*   try_inverse of 2x2, 3x3, and 4x4 matrices
+* - every loop has a trip count known at compile time and is fully unrolled:
+*   loop bodies are lambdas forced inline (SIGCPP_INLINE_LAMBDA), so nested
+*   unrolls do not become calls
+* - at run time, element types with SIMD arithmetic (see simd.h) use vector
+*   kernels: dot and axpy on whole registers; matmul broadcasts an element of
+*   one operand and multiplies a row (column for layout_left) of the other,
+*   if a row (column) is a whole number of registers
+* - rows too short for the native register use 128-bit registers: a 4x4
+*   float product takes the vector kernel with AVX2 as with SSE2 and NEON
+* - matvec on layout_left uses the matmul kernel; matvec on layout_right
+*   multiplies whole rows of registers by x and adds the lanes of each row
+* - matmul and matvec on layout_left add products in index order, so vector
+*   and scalar results are identical; dot and matvec on layout_right add in
+*   a different order, as reduce does
+* - inverse of a singular matrix (determinant exactly 0) throws
+*   std::invalid_argument; try_inverse returns false instead
+* - all but norm, inverse, and try_inverse are constexpr
+*/
+
+#ifndef SIGCPP_LINALG_H
+#define SIGCPP_LINALG_H
+
+#include <cstddef>
+#include <cmath>
+#include <utility>
+#include <type_traits>
+
+#include "config.h"
+#include "throw.h"
+#include "array.h"
+#include "mdarray.h"
+#include "simd.h"
+#include "algorithm.h"
+
+namespace sigcpp::simd
+{
+	//sum of a[i] * b[i] over the N elements at a and b
+	template<typename T, std::size_t N>
+	T dot(const T* a, const T* b)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		T sum = T();
+
+		if constexpr (body != 0)
+		{
+			constexpr std::size_t U = body / W < 4 ? body / W : 4;
+			typename V::reg acc[U];
+
+			unroll<0>([&](std::size_t u) SIGCPP_INLINE_LAMBDA {
+					acc[u] = V::mul(V::load(a + u * W), V::load(b + u * W));
+				}, std::make_index_sequence<U>{});
+
+			unroll<U>([&](std::size_t r) SIGCPP_INLINE_LAMBDA {
+					const std::size_t i = r * W;
+					acc[r % U] = V::add(acc[r % U], V::mul(V::load(a + i), V::load(b + i)));
+				}, std::make_index_sequence<body / W - U>{});
+
+			unroll<1>([&](std::size_t u) SIGCPP_INLINE_LAMBDA {
+					acc[0] = V::add(acc[0], acc[u]);
+				}, std::make_index_sequence<U - 1>{});
+
+			T lanes[W];
+			V::store(lanes, acc[0]);
+			unroll<0>([&](std::size_t k) SIGCPP_INLINE_LAMBDA { sum += lanes[k]; },
+				std::make_index_sequence<W>{});
+		}
+
+		unroll<body>([&](std::size_t k) SIGCPP_INLINE_LAMBDA { sum += a[k] * b[k]; },
+			std::make_index_sequence<N - body>{});
+
+		return sum;
+	}
+
+	//y[i] += a * x[i] over the N elements at x and y
+	template<typename T, std::size_t N>
+	void axpy(T a, const T* x, T* y)
+	{
+		using V = vector_traits<T>;
+		constexpr std::size_t W = V::width;
+		constexpr std::size_t body = N / W * W;
+
+		if constexpr (body != 0)
+		{
+			const typename V::reg va = V::set1(a);
+			unroll<0>([&](std::size_t r) SIGCPP_INLINE_LAMBDA {
+					const std::size_t i = r * W;
+					V::store(y + i, V::add(V::load(y + i), V::mul(va, V::load(x + i))));
+				}, std::make_index_sequence<body / W>{});
+		}
+
+		unroll<body>([&](std::size_t k) SIGCPP_INLINE_LAMBDA { y[k] += a * x[k]; },
+			std::make_index_sequence<N - body>{});
+	}
+
+	//row-major c (R x C) = a (R x K) * b (K x C) in registers of V; C must be
+	//a multiple of V::width
+	//-row i of c is the sum over k of a(i, k) times row k of b
+	template<typename T, std::size_t R, std::size_t K, std::size_t C,
+		typename V = vector_traits<T>>
+	void matmul(const T* a, const T* b, T* c)
+	{
+		constexpr std::size_t W = V::width;
+		static_assert(C % W == 0, "matmul kernel: rows must be whole registers");
+
+		unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA {
+				unroll<0>([&](std::size_t j) SIGCPP_INLINE_LAMBDA {
+						typename V::reg acc = V::mul(V::set1(a[i * K]), V::load(b + j * W));
+						unroll<1>([&](std::size_t k) SIGCPP_INLINE_LAMBDA {
+								acc = V::add(acc,
+									V::mul(V::set1(a[i * K + k]), V::load(b + k * C + j * W)));
+							}, std::make_index_sequence<K - 1>{});
+						V::store(c + i * C + j * W, acc);
+					}, std::make_index_sequence<C / W>{});
+			}, std::make_index_sequence<R>{});
+	}
+
+	//y (R) = row-major m (R x C) * x in registers of V; C must be a multiple
+	//of V::width
+	//-y[i] is the dot product of row i and x: lanes hold partial sums
+	template<typename T, std::size_t R, std::size_t C, typename V = vector_traits<T>>
+	void matvec(const T* m, const T* x, T* y)
+	{
+		constexpr std::size_t W = V::width;
+		static_assert(C % W == 0, "matvec kernel: rows must be whole registers");
+
+		typename V::reg xs[C / W];
+		unroll<0>([&](std::size_t j) SIGCPP_INLINE_LAMBDA { xs[j] = V::load(x + j * W); },
+			std::make_index_sequence<C / W>{});
+
+		unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA {
+				typename V::reg acc = V::mul(V::load(m + i * C), xs[0]);
+				unroll<1>([&](std::size_t j) SIGCPP_INLINE_LAMBDA {
+						acc = V::add(acc, V::mul(V::load(m + i * C + j * W), xs[j]));
+					}, std::make_index_sequence<C / W - 1>{});
+
+				T lanes[W];
+				V::store(lanes, acc);
+				T sum = lanes[0];
+				unroll<1>([&](std::size_t k) SIGCPP_INLINE_LAMBDA { sum += lanes[k]; },
+					std::make_index_sequence<W - 1>{});
+				y[i] = sum;
+			}, std::make_index_sequence<R>{});
+	}
+
+}	//namespace sigcpp::simd
+
+
+namespace sigcpp
+{
+	//vector kernels apply to T at run time
+	template<typename T>
+	inline constexpr bool _linalg_vectorized = simd::vector_traits<T>::arithmetic;
+
+	//layouts whose rows or columns are contiguous
+	template<typename L>
+	inline constexpr bool _is_dense_layout =
+		std::is_same_v<L, layout_right> || std::is_same_v<L, layout_left>;
+
+	//vector traits for rows of N elements: the native register if a row is a
+	//whole number of them, else a 128-bit register
+	template<typename T, std::size_t N>
+	using _row_traits = std::conditional_t<N % simd::vector_traits<T>::width == 0,
+		simd::vector_traits<T>, simd::narrow_traits<T>>;
+
+	//true if rows of N elements of T are whole registers of _row_traits
+	template<typename T, std::size_t N>
+	constexpr bool _is_row_vectorized()
+	{
+		if constexpr (_linalg_vectorized<T>)
+			return N % _row_traits<T, N>::width == 0;
+		else
+			return false;
+	}
+
+	//row-major c (R x C) = a (R x K) * b (K x C)
+	template<typename T, std::size_t R, std::size_t K, std::size_t C>
+	constexpr void _matmul(const T* a, const T* b, T* c)
+	{
+		static_assert(K != 0, "matmul requires an inner extent");
+
+		if constexpr (_is_row_vectorized<T, C>())
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+			{
+				simd::matmul<T, R, K, C, _row_traits<T, C>>(a, b, c);
+				return;
+			}
+		}
+
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA {
+				simd::unroll<0>([&](std::size_t j) SIGCPP_INLINE_LAMBDA {
+						T sum = a[i * K] * b[j];
+						simd::unroll<1>([&](std::size_t k) SIGCPP_INLINE_LAMBDA {
+								sum += a[i * K + k] * b[k * C + j];
+							}, std::make_index_sequence<K - 1>{});
+						c[i * C + j] = sum;
+					}, std::make_index_sequence<C>{});
+			}, std::make_index_sequence<R>{});
+	}
+
+	//y (R) = row-major m (R x C) * x
+	template<typename T, std::size_t R, std::size_t C>
+	constexpr void _matvec(const T* m, const T* x, T* y)
+	{
+		if constexpr (_is_row_vectorized<T, C>())
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+			{
+				simd::matvec<T, R, C, _row_traits<T, C>>(m, x, y);
+				return;
+			}
+		}
+
+		_matmul<T, R, C, 1>(m, x, y);
+	}
+
+
+	//vectors
+
+	template<typename T, std::size_t N>
+	constexpr T dot(const array<T, N>& a, const array<T, N>& b)
+	{
+		if constexpr (_linalg_vectorized<T>)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				return simd::dot<T, N>(a.data(), b.data());
+		}
+
+		T sum = T();
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA { sum += a[i] * b[i]; },
+			std::make_index_sequence<N>{});
+		return sum;
+	}
+
+	//y += a * x
+	template<typename T, std::size_t N>
+	constexpr void axpy(const T& a, const array<T, N>& x, array<T, N>& y)
+	{
+		if constexpr (_linalg_vectorized<T>)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+			{
+				simd::axpy<T, N>(a, x.data(), y.data());
+				return;
+			}
+		}
+
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA { y[i] += a * x[i]; },
+			std::make_index_sequence<N>{});
+	}
+
+	//Euclidean norm
+	template<typename T, std::size_t N>
+	T norm(const array<T, N>& x)
+	{
+		static_assert(std::is_floating_point_v<T>, "norm requires a floating-point type");
+		return std::sqrt(dot(x, x));
+	}
+
+
+	//matrices
+
+	template<typename T, std::size_t N>
+	constexpr mdarray<T, N, N> identity()
+	{
+		mdarray<T, N, N> m{};
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA { m(i, i) = T(1); },
+			std::make_index_sequence<N>{});
+		return m;
+	}
+
+	//a (R x K) * b (K x C)
+	//-column-major storage of a product is the row-major storage of its
+	//transpose: b' * a' with the operands swapped
+	template<typename T, typename L, std::size_t R, std::size_t K, std::size_t C>
+	constexpr basic_mdarray<T, L, R, C> matmul(const basic_mdarray<T, L, R, K>& a,
+		const basic_mdarray<T, L, K, C>& b)
+	{
+		static_assert(_is_dense_layout<L>, "matmul requires layout_right or layout_left");
+
+		basic_mdarray<T, L, R, C> c{};
+		if constexpr (std::is_same_v<L, layout_right>)
+			_matmul<T, R, K, C>(a.data(), b.data(), c.data());
+		else
+			_matmul<T, C, K, R>(b.data(), a.data(), c.data());
+		return c;
+	}
+
+	//m (R x C) * x
+	template<typename T, typename L, std::size_t R, std::size_t C>
+	constexpr array<T, R> matvec(const basic_mdarray<T, L, R, C>& m, const array<T, C>& x)
+	{
+		static_assert(_is_dense_layout<L>, "matvec requires layout_right or layout_left");
+
+		array<T, R> y{};
+		if constexpr (std::is_same_v<L, layout_right>)
+			_matvec<T, R, C>(m.data(), x.data(), y.data());
+		else
+			_matmul<T, 1, C, R>(x.data(), m.data(), y.data());
+		return y;
+	}
+
+	template<typename T, typename L, std::size_t R, std::size_t C>
+	constexpr basic_mdarray<T, L, C, R> transpose(const basic_mdarray<T, L, R, C>& m)
+	{
+		basic_mdarray<T, L, C, R> t{};
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA {
+				simd::unroll<0>([&](std::size_t j) SIGCPP_INLINE_LAMBDA { t(j, i) = m(i, j); },
+					std::make_index_sequence<C>{});
+			}, std::make_index_sequence<R>{});
+		return t;
+	}
+
+	//determinant of m; adj is the adjugate of m
+	template<typename T, typename L>
+	constexpr T _adjugate(const basic_mdarray<T, L, 2, 2>& m, basic_mdarray<T, L, 2, 2>& adj)
+	{
+		adj(0, 0) = m(1, 1);
+		adj(0, 1) = -m(0, 1);
+		adj(1, 0) = -m(1, 0);
+		adj(1, 1) = m(0, 0);
+		return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+	}
+
+	template<typename T, typename L>
+	constexpr T _adjugate(const basic_mdarray<T, L, 3, 3>& m, basic_mdarray<T, L, 3, 3>& adj)
+	{
+		adj(0, 0) = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+		adj(0, 1) = m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2);
+		adj(0, 2) = m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1);
+		adj(1, 0) = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+		adj(1, 1) = m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0);
+		adj(1, 2) = m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2);
+		adj(2, 0) = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+		adj(2, 1) = m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1);
+		adj(2, 2) = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+		return m(0, 0) * adj(0, 0) + m(0, 1) * adj(1, 0) + m(0, 2) * adj(2, 0);
+	}
+
+	//-from the 2x2 minors of rows 0 and 1 (s) and of rows 2 and 3 (c)
+	template<typename T, typename L>
+	constexpr T _adjugate(const basic_mdarray<T, L, 4, 4>& m, basic_mdarray<T, L, 4, 4>& adj)
+	{
+		const T s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+		const T s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+		const T s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+		const T s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+		const T s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+		const T s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+
+		const T c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+		const T c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+		const T c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+		const T c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+		const T c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+		const T c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+
+		adj(0, 0) = m(1, 1) * c5 - m(1, 2) * c4 + m(1, 3) * c3;
+		adj(0, 1) = -m(0, 1) * c5 + m(0, 2) * c4 - m(0, 3) * c3;
+		adj(0, 2) = m(3, 1) * s5 - m(3, 2) * s4 + m(3, 3) * s3;
+		adj(0, 3) = -m(2, 1) * s5 + m(2, 2) * s4 - m(2, 3) * s3;
+
+		adj(1, 0) = -m(1, 0) * c5 + m(1, 2) * c2 - m(1, 3) * c1;
+		adj(1, 1) = m(0, 0) * c5 - m(0, 2) * c2 + m(0, 3) * c1;
+		adj(1, 2) = -m(3, 0) * s5 + m(3, 2) * s2 - m(3, 3) * s1;
+		adj(1, 3) = m(2, 0) * s5 - m(2, 2) * s2 + m(2, 3) * s1;
+
+		adj(2, 0) = m(1, 0) * c4 - m(1, 1) * c2 + m(1, 3) * c0;
+		adj(2, 1) = -m(0, 0) * c4 + m(0, 1) * c2 - m(0, 3) * c0;
+		adj(2, 2) = m(3, 0) * s4 - m(3, 1) * s2 + m(3, 3) * s0;
+		adj(2, 3) = -m(2, 0) * s4 + m(2, 1) * s2 - m(2, 3) * s0;
+
+		adj(3, 0) = -m(1, 0) * c3 + m(1, 1) * c1 - m(1, 2) * c0;
+		adj(3, 1) = m(0, 0) * c3 - m(0, 1) * c1 + m(0, 2) * c0;
+		adj(3, 2) = -m(3, 0) * s3 + m(3, 1) * s1 - m(3, 2) * s0;
+		adj(3, 3) = m(2, 0) * s3 - m(2, 1) * s1 + m(2, 2) * s0;
+
+		return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	}
+
+	template<typename T, typename L, std::size_t N>
+	constexpr T determinant(const basic_mdarray<T, L, N, N>& m)
+	{
+		static_assert(N >= 2 && N <= 4, "determinant requires a 2x2, 3x3, or 4x4 matrix");
+		basic_mdarray<T, L, N, N> adj{};
+		return _adjugate(m, adj);
+	}
+
+	//false, and inv unchanged, if m is singular
+	template<typename T, typename L, std::size_t N>
+	bool try_inverse(const basic_mdarray<T, L, N, N>& m, basic_mdarray<T, L, N, N>& inv)
+	{
+		static_assert(N >= 2 && N <= 4, "inverse requires a 2x2, 3x3, or 4x4 matrix");
+		static_assert(std::is_floating_point_v<T>, "inverse requires a floating-point type");
+
+		basic_mdarray<T, L, N, N> adj{};
+		const T det = _adjugate(m, adj);
+		if (det == T(0))
+			return false;
+
+		const T r = T(1) / det;
+		simd::unroll<0>([&](std::size_t i) SIGCPP_INLINE_LAMBDA {
+				inv.values[i] = adj.values[i] * r;
+			}, std::make_index_sequence<N * N>{});
+		return true;
+	}
+
+	template<typename T, typename L, std::size_t N>
+	basic_mdarray<T, L, N, N> inverse(const basic_mdarray<T, L, N, N>& m)
+	{
+		basic_mdarray<T, L, N, N> inv{};
+		if (!try_inverse(m, inv))
+			_throw_invalid_argument("inverse of a singular matrix");
+		return inv;
+	}
+
+}	//namespace sigcpp
+
+#endif
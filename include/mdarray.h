@@ -0,0 +1,260 @@
+/*
+* mdarray.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for fixed-size multidimensional arrays
+* - basic_mdarray<T, Layout, Extents...> stores the product of its extents in
+*   one array<T, size>; mdarray<T, Extents...> is row major
+* - m(i, j, ...) is the element at index (i, j, ...): the layout policy maps
+*   indexes to an offset in storage, as mdspan layouts do (C++23)
+* - layout_right is row major and layout_left column major: both have strides
+*   known at compile time, so offsets are a sum of constant multiples
+* - layout_tiled<Tiles...> stores tiles of the given extents contiguously, in
+*   row-major order of tiles and of elements within a tile: a tile is one
+*   run of memory, which helps blocked loops such as convolution and
+*   transpose; each tile extent must divide the corresponding extent
+* - mdarray is an aggregate: initializers and iterators follow storage order
+*/
+
+#ifndef SIGCPP_MDARRAY_H
+#define SIGCPP_MDARRAY_H
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "throw.h"
+#include "array.h"
+
+namespace sigcpp
+{
+	template<std::size_t... E>
+	constexpr array<std::size_t, sizeof...(E)> _right_strides()
+	{
+		constexpr array<std::size_t, sizeof...(E)> extents{ E... };
+		array<std::size_t, sizeof...(E)> strides{};
+		std::size_t stride = 1;
+		for (std::size_t r = sizeof...(E); r-- > 0;)
+		{
+			strides[r] = stride;
+			stride *= extents[r];
+		}
+		return strides;
+	}
+
+	template<std::size_t... E>
+	constexpr array<std::size_t, sizeof...(E)> _left_strides()
+	{
+		constexpr array<std::size_t, sizeof...(E)> extents{ E... };
+		array<std::size_t, sizeof...(E)> strides{};
+		std::size_t stride = 1;
+		for (std::size_t r = 0; r < sizeof...(E); ++r)
+		{
+			strides[r] = stride;
+			stride *= extents[r];
+		}
+		return strides;
+	}
+
+	//offset of an index in a layout with the given strides
+	template<std::size_t Rank, std::size_t... R, typename... I>
+	constexpr std::size_t _strided_offset(const array<std::size_t, Rank>& strides,
+		std::index_sequence<R...>, I... i)
+	{
+		return ((static_cast<std::size_t>(i) * strides[R]) + ... + 0);
+	}
+
+	//a layout policy has mapping<Extents...> with:
+	//-required_size: number of elements in storage
+	//-offset(i...): offset of index (i...) in storage
+	//-is_strided and, if strided, stride(r): offset step of index r
+
+	struct layout_right
+	{
+		template<std::size_t... E>
+		struct mapping
+		{
+			static constexpr std::size_t required_size = (E * ... * std::size_t(1));
+			static constexpr bool is_strided = true;
+			static constexpr array<std::size_t, sizeof...(E)> strides = _right_strides<E...>();
+
+			static constexpr std::size_t stride(std::size_t r) { return strides[r]; }
+
+			template<typename... I>
+			static constexpr std::size_t offset(I... i)
+			{
+				return _strided_offset(strides, std::index_sequence_for<I...>(), i...);
+			}
+		};
+	};
+
+	struct layout_left
+	{
+		template<std::size_t... E>
+		struct mapping
+		{
+			static constexpr std::size_t required_size = (E * ... * std::size_t(1));
+			static constexpr bool is_strided = true;
+			static constexpr array<std::size_t, sizeof...(E)> strides = _left_strides<E...>();
+
+			static constexpr std::size_t stride(std::size_t r) { return strides[r]; }
+
+			template<typename... I>
+			static constexpr std::size_t offset(I... i)
+			{
+				return _strided_offset(strides, std::index_sequence_for<I...>(), i...);
+			}
+		};
+	};
+
+	template<std::size_t... Tiles>
+	struct layout_tiled
+	{
+		template<std::size_t... E>
+		struct mapping
+		{
+			static_assert(sizeof...(Tiles) == sizeof...(E), "one tile extent per extent");
+			static_assert(((Tiles != 0 && E % Tiles == 0) && ...),
+				"tile extents must divide extents");
+
+			static constexpr std::size_t required_size = (E * ... * std::size_t(1));
+			static constexpr bool is_strided = false;
+
+			//tiles, and elements within a tile, in row-major order
+			using grid = layout_right::mapping<(E / Tiles)...>;
+			using tile = layout_right::mapping<Tiles...>;
+
+			template<typename... I>
+			static constexpr std::size_t offset(I... i)
+			{
+				return grid::offset((static_cast<std::size_t>(i) / Tiles)...) *
+					tile::required_size + tile::offset((static_cast<std::size_t>(i) % Tiles)...);
+			}
+		};
+	};
+
+	template<typename T, typename Layout, std::size_t... Extents>
+	struct basic_mdarray
+	{
+		static_assert(sizeof...(Extents) != 0, "mdarray requires at least one extent");
+
+		//types
+		using layout_type = Layout;
+		using mapping_type = typename Layout::template mapping<Extents...>;
+		using storage_type = array<T, mapping_type::required_size>;
+
+		using value_type = T;
+		using element_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using iterator = typename storage_type::iterator;
+		using const_iterator = typename storage_type::const_iterator;
+
+		//elements in storage order: public for aggregate initialization
+		storage_type values;
+
+		//extents and strides
+		static constexpr size_type rank() noexcept { return sizeof...(Extents); }
+
+		static constexpr size_type extent(size_type r) noexcept
+		{
+			constexpr array<size_type, sizeof...(Extents)> extents{ Extents... };
+			return extents[r];
+		}
+
+		static constexpr size_type size() noexcept { return mapping_type::required_size; }
+		static constexpr bool is_strided() noexcept { return mapping_type::is_strided; }
+
+		static constexpr size_type stride(size_type r) noexcept
+		{
+			static_assert(mapping_type::is_strided, "stride requires a strided layout");
+			return mapping_type::stride(r);
+		}
+
+		//offset in storage of an index
+		template<typename... I>
+		static constexpr size_type offset(I... i) noexcept
+		{
+			static_assert(sizeof...(I) == sizeof...(Extents), "one index per extent");
+			return mapping_type::offset(i...);
+		}
+
+		//unchecked element access
+		template<typename... I>
+		constexpr reference operator()(I... i) { return values[offset(i...)]; }
+
+		template<typename... I>
+		constexpr const_reference operator()(I... i) const { return values[offset(i...)]; }
+
+		//checked element access
+		template<typename... I>
+		constexpr reference at(I... i)
+		{
+			_check_index(i...);
+			return values[offset(i...)];
+		}
+
+		template<typename... I>
+		constexpr const_reference at(I... i) const
+		{
+			_check_index(i...);
+			return values[offset(i...)];
+		}
+
+		//storage
+		constexpr storage_type& storage() noexcept { return values; }
+		constexpr const storage_type& storage() const noexcept { return values; }
+		constexpr pointer data() noexcept { return values.data(); }
+		constexpr const_pointer data() const noexcept { return values.data(); }
+
+		//iterators in storage order
+		constexpr iterator begin() noexcept { return values.begin(); }
+		constexpr const_iterator begin() const noexcept { return values.cbegin(); }
+		constexpr iterator end() noexcept { return values.end(); }
+		constexpr const_iterator end() const noexcept { return values.cend(); }
+
+		constexpr void fill(const T& v) { values.fill(v); }
+		constexpr void swap(basic_mdarray& m) { values.swap(m.values); }
+
+	private:
+		template<typename... I>
+		static constexpr void _check_index(I... i)
+		{
+			static_assert(sizeof...(I) == sizeof...(Extents), "one index per extent");
+			if (!((static_cast<size_type>(i) < Extents) && ...))
+				_throw_out_of_range("mdarray index out of range");
+		}
+
+	}; //template basic_mdarray
+
+	//row-major
+	template<typename T, std::size_t... Extents>
+	using mdarray = basic_mdarray<T, layout_right, Extents...>;
+
+	template<typename T, typename L, std::size_t... E>
+	constexpr bool operator==(const basic_mdarray<T, L, E...>& a,
+		const basic_mdarray<T, L, E...>& b)
+	{
+		return a.values == b.values;
+	}
+
+	template<typename T, typename L, std::size_t... E>
+	constexpr bool operator!=(const basic_mdarray<T, L, E...>& a,
+		const basic_mdarray<T, L, E...>& b)
+	{
+		return !(a == b);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,226 @@
+/*
+* mpmc_queue.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for bounded lock-free multi-producer,
+* multi-consumer queues
+* - any number of threads may push and pop concurrently
+* - after D. Vyukov's bounded MPMC queue: each slot carries a sequence
+*   number that tells a producer or consumer whether the slot is ready for
+*   it in the current lap around the ring
+* - slots are an aligned_array: no heap allocation, ever
+* - N must be a power of two: positions are free-running counters, masked
+* - the enqueue and dequeue positions are on separate cache lines
+* - try_push_n and try_pop_n claim a run of slots with a single CAS
+* - not wait-free: a producer stalled between claiming and publishing a slot
+*   makes the queue look empty at that slot until it resumes
+*/
+
+#ifndef SIGCPP_MPMC_QUEUE_H
+#define SIGCPP_MPMC_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "aligned_array.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N>
+	class mpmc_queue
+	{
+		static_assert(N != 0 && (N & (N - 1)) == 0,
+			"mpmc_queue capacity must be a power of two");
+
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		mpmc_queue() noexcept(std::is_nothrow_default_constructible_v<T>)
+		{
+			for (size_type i = 0; i < N; ++i)
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+		//capacity
+		static constexpr size_type capacity() noexcept { return N; }
+
+		//number of elements: exact only if no thread is active
+		size_type size_approx() const noexcept
+		{
+			const size_type d = dequeuePos.value.load(std::memory_order_acquire);
+			const size_type e = enqueuePos.value.load(std::memory_order_acquire);
+			return e > d ? e - d : 0;
+		}
+
+		bool empty_approx() const noexcept { return size_approx() == 0; }
+
+		//false if full
+		bool try_push(const T& v) { return _try_push(v); }
+		bool try_push(T&& v) { return _try_push(std::move(v)); }
+
+		//copy up to n elements from src; number copied
+		size_type try_push_n(const T* src, size_type n)
+		{
+			size_type pos = enqueuePos.value.load(std::memory_order_relaxed);
+			size_type k;
+			for (;;)
+			{
+				//claim the run of slots free for this lap
+				k = 0;
+				while (k < n && _lag(pos + k, 0) == 0)
+					++k;
+
+				if (k != 0)
+				{
+					if (enqueuePos.value.compare_exchange_weak(pos, pos + k,
+						std::memory_order_relaxed))
+						break;
+				}
+				else if (n == 0 || _lag(pos, 0) < 0)
+					return 0; //full
+				else
+					pos = enqueuePos.value.load(std::memory_order_relaxed);
+			}
+
+			for (size_type i = 0; i < k; ++i)
+			{
+				slot& s = slots[(pos + i) & mask];
+				s.value = src[i];
+				s.sequence.store(pos + i + 1, std::memory_order_release);
+			}
+
+			return k;
+		}
+
+		//move the front element to v; false if empty
+		bool try_pop(T& v)
+		{
+			size_type pos = dequeuePos.value.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				const difference_type lag = _lag(pos, 1);
+				if (lag == 0)
+				{
+					if (dequeuePos.value.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed))
+						break;
+				}
+				else if (lag < 0)
+					return false; //empty
+				else
+					pos = dequeuePos.value.load(std::memory_order_relaxed);
+			}
+
+			slot& s = slots[pos & mask];
+			v = std::move(s.value);
+			s.sequence.store(pos + N, std::memory_order_release);
+			return true;
+		}
+
+		//move up to n elements to dst; number moved
+		size_type try_pop_n(T* dst, size_type n)
+		{
+			size_type pos = dequeuePos.value.load(std::memory_order_relaxed);
+			size_type k;
+			for (;;)
+			{
+				//claim the run of slots published for this lap
+				k = 0;
+				while (k < n && _lag(pos + k, 1) == 0)
+					++k;
+
+				if (k != 0)
+				{
+					if (dequeuePos.value.compare_exchange_weak(pos, pos + k,
+						std::memory_order_relaxed))
+						break;
+				}
+				else if (n == 0 || _lag(pos, 1) < 0)
+					return 0; //empty
+				else
+					pos = dequeuePos.value.load(std::memory_order_relaxed);
+			}
+
+			for (size_type i = 0; i < k; ++i)
+			{
+				slot& s = slots[(pos + i) & mask];
+				dst[i] = std::move(s.value);
+				s.sequence.store(pos + i + N, std::memory_order_release);
+			}
+
+			return k;
+		}
+
+	private:
+		static constexpr size_type mask = N - 1;
+
+		//sequence == pos: free for the producer of position pos
+		//sequence == pos + 1: holds the element for the consumer of pos
+		struct slot
+		{
+			std::atomic<size_type> sequence;
+			T value{};
+		};
+
+		struct alignas(cache_line_size) position
+		{
+			std::atomic<size_type> value{ 0 };
+		};
+
+		position enqueuePos;
+		position dequeuePos;
+		aligned_array<slot, N, cache_line_size> slots;
+
+		//signed distance of the sequence of the slot for pos from pos + ahead
+		//-zero if the slot is ready; negative if the slot is a lap behind
+		difference_type _lag(size_type pos, size_type ahead) const noexcept
+		{
+			const size_type seq =
+				slots[pos & mask].sequence.load(std::memory_order_acquire);
+			return static_cast<difference_type>(seq - (pos + ahead));
+		}
+
+		template<typename U>
+		bool _try_push(U&& v)
+		{
+			size_type pos = enqueuePos.value.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				const difference_type lag = _lag(pos, 0);
+				if (lag == 0)
+				{
+					if (enqueuePos.value.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed))
+						break;
+				}
+				else if (lag < 0)
+					return false; //full
+				else
+					pos = enqueuePos.value.load(std::memory_order_relaxed);
+			}
+
+			slot& s = slots[pos & mask];
+			s.value = std::forward<U>(v);
+			s.sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+	}; //template mpmc_queue
+
+}	//namespace sigcpp
+
+#endif
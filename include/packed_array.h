@@ -0,0 +1,570 @@
+/*
+* packed_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for fixed-size arrays of Bits-bit unsigned values
+* - packed_array<Bits, N> stores N values in array<uint64_t, ceil(N*Bits/64)>:
+*   packed_array<1, N> is a bit set in 1/8 the memory of array<bool, N>
+* - values are bool if Bits is 1, else the smallest unsigned type holding
+*   Bits bits; values stored are truncated to Bits bits
+* - values are stored from the least significant bit of word 0 up; a value
+*   may span two words if Bits does not divide 64
+* - elements are not addressable: operator[] and iterators return a proxy
+*   reference (packed_reference) as std::vector<bool> does
+* - popcount, find_first, find_next, fill, and the bitwise operators work a
+*   word at a time; they rely on the unused bits of the last word being 0,
+*   which every member function maintains
+* - packed_array is an aggregate over public words; packed_array<Bits, N> p{}
+*   is all zeros, and is constexpr
+*/
+
+#ifndef SIGCPP_PACKED_ARRAY_H
+#define SIGCPP_PACKED_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "throw.h"
+#include "array.h"
+#include "array_iterator.h"
+#include "bit.h"
+
+namespace sigcpp
+{
+	//type of each value in a packed_array<Bits, N>
+	template<std::size_t Bits>
+	using _packed_value_t = std::conditional_t<Bits == 1, bool,
+		std::conditional_t<Bits <= 8, std::uint8_t,
+		std::conditional_t<Bits <= 16, std::uint16_t,
+		std::conditional_t<Bits <= 32, std::uint32_t, std::uint64_t>>>>;
+
+	//proxy for an element of a non-const Packed
+	template<typename Packed>
+	class packed_reference
+	{
+	public:
+		using value_type = typename Packed::value_type;
+		using size_type = std::size_t;
+
+		constexpr packed_reference(Packed& p, size_type i) noexcept : packed(&p), pos(i) {}
+
+		constexpr packed_reference(const packed_reference&) noexcept = default;
+
+		constexpr operator value_type() const noexcept { return packed->get(pos); }
+
+		constexpr packed_reference& operator=(value_type v) noexcept
+		{
+			packed->set(pos, v);
+			return *this;
+		}
+
+		//assign the referenced value, not the reference
+		constexpr packed_reference& operator=(const packed_reference& r) noexcept
+		{
+			return *this = static_cast<value_type>(r);
+		}
+
+		//invert every bit of the value
+		constexpr void flip() noexcept
+		{
+			const value_type v = *this;
+			if constexpr (std::is_same_v<value_type, bool>)
+				packed->set(pos, !v);
+			else
+				packed->set(pos, static_cast<value_type>(~v));
+		}
+
+		friend constexpr void swap(packed_reference a, packed_reference b) noexcept
+		{
+			const value_type t = a;
+			a = static_cast<value_type>(b);
+			b = t;
+		}
+
+	private:
+		Packed* packed;
+		size_type pos;
+
+	}; //template packed_reference
+
+
+	//random-access iterator over Packed: Packed may be const
+	//-the interface of array_iterator except operator->, as elements are
+	//not addressable; reference is a proxy, or a value if Packed is const
+	template<typename Packed>
+	class packed_array_iterator
+	{
+		using packed_type = std::remove_const_t<Packed>;
+
+	public:
+
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = typename packed_type::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::conditional_t<std::is_const_v<Packed>,
+			value_type, packed_reference<packed_type>>;
+		using size_type = std::size_t;
+
+		//ctors
+		constexpr packed_array_iterator() noexcept = default;
+		constexpr packed_array_iterator(Packed& p, size_type i) noexcept
+			: packed(&p), pos(static_cast<difference_type>(i)) {}
+
+		//conversion from iterator to const_iterator
+		template<typename P,
+			typename = std::enable_if_t<std::is_same_v<const P, Packed>>>
+		constexpr packed_array_iterator(const packed_array_iterator<P>& it) noexcept
+			: packed(it.packed), pos(it.pos) {}
+
+		//index of the element
+		constexpr size_type index() const noexcept { return static_cast<size_type>(pos); }
+
+		//dereference and element access
+		constexpr reference operator*() const
+		{
+			_check_deref(0);
+			return _at(pos);
+		}
+
+		constexpr reference operator[](difference_type n) const
+		{
+			_check_deref(n);
+			return _at(pos + n);
+		}
+
+		//increment and decrement
+		constexpr packed_array_iterator& operator++()
+		{
+			_check_move(1);
+			++pos;
+			return *this;
+		}
+
+		constexpr packed_array_iterator operator++(int)
+		{
+			packed_array_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		constexpr packed_array_iterator& operator--()
+		{
+			_check_move(-1);
+			--pos;
+			return *this;
+		}
+
+		constexpr packed_array_iterator operator--(int)
+		{
+			packed_array_iterator beforeDecrement = *this;
+			--*this;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr packed_array_iterator operator+(difference_type n) const
+		{
+			packed_array_iterator t = *this;
+			t += n;
+			return t;
+		}
+
+		constexpr packed_array_iterator operator-(difference_type n) const
+		{
+			packed_array_iterator t = *this;
+			t -= n;
+			return t;
+		}
+
+		constexpr packed_array_iterator& operator+=(difference_type n)
+		{
+			_check_move(n);
+			pos += n;
+			return *this;
+		}
+
+		constexpr packed_array_iterator& operator-=(difference_type n)
+		{
+			_check_move(-n);
+			pos -= n;
+			return *this;
+		}
+
+		constexpr difference_type operator-(const packed_array_iterator& r) const
+		{
+			_check_same(r);
+			return pos - r.pos;
+		}
+
+		friend constexpr packed_array_iterator operator+(difference_type n,
+			const packed_array_iterator& it)
+		{
+			return it + n;
+		}
+
+		//comparison
+		constexpr bool operator==(const packed_array_iterator& r) const
+		{
+			_check_same(r);
+			return pos == r.pos;
+		}
+
+		constexpr bool operator!=(const packed_array_iterator& r) const
+		{
+			_check_same(r);
+			return pos != r.pos;
+		}
+
+		constexpr bool operator<(const packed_array_iterator& r) const
+		{
+			_check_same(r);
+			return pos < r.pos;
+		}
+
+		constexpr bool operator>(const packed_array_iterator& r) const
+		{
+			_check_same(r);
+			return pos > r.pos;
+		}
+
+		constexpr bool operator<=(const packed_array_iterator& r) const
+		{
+			return !(r < *this);
+		}
+
+		constexpr bool operator>=(const packed_array_iterator& r) const
+		{
+			return !(*this < r);
+		}
+
+	private:
+		template<typename P> friend class packed_array_iterator;
+
+		Packed* packed{ nullptr };
+		difference_type pos{ 0 };
+
+		constexpr reference _at(difference_type i) const
+		{
+			if constexpr (std::is_const_v<Packed>)
+				return packed->get(static_cast<size_type>(i));
+			else
+				return reference(*packed, static_cast<size_type>(i));
+		}
+
+		//checks: no-ops if iterators are unchecked
+
+		//element at offset n from pos must be in range
+		constexpr void _check_deref([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			const difference_type size = static_cast<difference_type>(packed_type::size());
+			if (packed == nullptr || !(-pos <= n && n < size - pos))
+				_iterator_failure("packed_array_iterator: dereference out of range");
+#endif
+		}
+
+		//moving by n must stay within [begin, end]
+		constexpr void _check_move([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			const difference_type size = static_cast<difference_type>(packed_type::size());
+			if (packed != nullptr && !(-pos <= n && n <= size - pos))
+				_iterator_failure("packed_array_iterator: arithmetic out of range");
+#endif
+		}
+
+		//iterators compared or subtracted must share an array
+		constexpr void _check_same([[maybe_unused]] const packed_array_iterator& r) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (packed != r.packed)
+				_iterator_failure("packed_array_iterator: iterators of different arrays");
+#endif
+		}
+
+	}; //template packed_array_iterator
+
+
+	template<std::size_t Bits, std::size_t N>
+	struct packed_array
+	{
+		static_assert(Bits >= 1 && Bits <= 64, "packed_array requires 1 to 64 bits");
+
+		//types
+		using value_type = _packed_value_t<Bits>;
+		using word_type = std::uint64_t;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = packed_reference<packed_array>;
+		using const_reference = value_type;
+
+		using iterator = packed_array_iterator<packed_array>;
+		using const_iterator = packed_array_iterator<const packed_array>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_type bits = Bits;
+		static constexpr size_type word_bits = 64;
+		static constexpr size_type word_count = (N * Bits + word_bits - 1) / word_bits;
+
+		//storage: public for aggregate initialization
+		array<word_type, word_count> words;
+
+		//element access
+		//-get and set are unchecked
+		constexpr value_type get(size_type i) const noexcept
+		{
+			const size_type b = i * Bits;
+			const size_type w = b / word_bits;
+			const size_type s = b % word_bits;
+
+			word_type v = words[w] >> s;
+			//values straddle words only if there is more than one
+			if constexpr (word_bits % Bits != 0 && word_count > 1)
+				if (s + Bits > word_bits)
+					v |= words[w + 1] << (word_bits - s);
+
+			return static_cast<value_type>(v & value_mask);
+		}
+
+		constexpr void set(size_type i, value_type value) noexcept
+		{
+			const size_type b = i * Bits;
+			const size_type w = b / word_bits;
+			const size_type s = b % word_bits;
+			const word_type v = static_cast<word_type>(value) & value_mask;
+
+			words[w] = (words[w] & ~(value_mask << s)) | (v << s);
+			if constexpr (word_bits % Bits != 0 && word_count > 1)
+				if (s + Bits > word_bits)
+				{
+					const size_type spill = word_bits - s;
+					words[w + 1] = (words[w + 1] & ~(value_mask >> spill)) | (v >> spill);
+				}
+		}
+
+		constexpr reference operator[](size_type i) noexcept { return reference(*this, i); }
+		constexpr const_reference operator[](size_type i) const noexcept { return get(i); }
+
+		constexpr reference at(size_type i)
+		{
+			_check_index(i);
+			return reference(*this, i);
+		}
+
+		constexpr const_reference at(size_type i) const
+		{
+			_check_index(i);
+			return get(i);
+		}
+
+		constexpr reference front() noexcept { return reference(*this, 0); }
+		constexpr const_reference front() const noexcept { return get(0); }
+		constexpr reference back() noexcept { return reference(*this, N - 1); }
+		constexpr const_reference back() const noexcept { return get(N - 1); }
+
+		constexpr word_type* data() noexcept { return words.data(); }
+		constexpr const word_type* data() const noexcept { return words.data(); }
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(*this, 0); }
+		constexpr const_iterator begin() const noexcept { return const_iterator(*this, 0); }
+		constexpr iterator end() noexcept { return iterator(*this, N); }
+		constexpr const_iterator end() const noexcept { return const_iterator(*this, N); }
+
+		constexpr const_iterator cbegin() const noexcept { return begin(); }
+		constexpr const_iterator cend() const noexcept { return end(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		//capacity
+		static constexpr size_type size() noexcept { return N; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr bool empty() noexcept { return N == 0; }
+
+		//word-at-a-time operations
+
+		//set every element to value
+		constexpr void fill(value_type value) noexcept
+		{
+			const word_type v = static_cast<word_type>(value) & value_mask;
+			if constexpr (word_bits % Bits == 0)
+			{
+				//the value repeated across a word
+				word_type pattern = 0;
+				for (size_type s = 0; s < word_bits; s += Bits)
+					pattern |= v << s;
+
+				for (size_type w = 0; w < word_count; ++w)
+					words[w] = pattern;
+				_clear_unused();
+			}
+			else
+			{
+				for (size_type i = 0; i < N; ++i)
+					set(i, value);
+			}
+		}
+
+		//number of 1 bits in all elements
+		constexpr size_type popcount() const noexcept
+		{
+			size_type n = 0;
+			for (size_type w = 0; w < word_count; ++w)
+				n += static_cast<size_type>(sigcpp::popcount(words[w]));
+			return n;
+		}
+
+		constexpr bool any() const noexcept
+		{
+			for (size_type w = 0; w < word_count; ++w)
+				if (words[w] != 0)
+					return true;
+			return false;
+		}
+
+		constexpr bool none() const noexcept { return !any(); }
+
+		//index of the first non-zero element; size() if none
+		constexpr size_type find_first() const noexcept { return find_next(0); }
+
+		//index of the first non-zero element at or after pos; size() if none
+		constexpr size_type find_next(size_type pos) const noexcept
+		{
+			if (pos >= N)
+				return N;
+
+			const size_type b = pos * Bits;
+			size_type w = b / word_bits;
+			word_type m = words[w] & (~word_type(0) << (b % word_bits));
+			while (m == 0)
+			{
+				if (++w == word_count)
+					return N;
+				m = words[w];
+			}
+
+			return (w * word_bits + static_cast<size_type>(countr_zero(m))) / Bits;
+		}
+
+		//invert every bit of every element
+		constexpr packed_array& flip() noexcept
+		{
+			for (size_type w = 0; w < word_count; ++w)
+				words[w] = ~words[w];
+			_clear_unused();
+			return *this;
+		}
+
+		constexpr packed_array& operator&=(const packed_array& p) noexcept
+		{
+			for (size_type w = 0; w < word_count; ++w)
+				words[w] &= p.words[w];
+			return *this;
+		}
+
+		constexpr packed_array& operator|=(const packed_array& p) noexcept
+		{
+			for (size_type w = 0; w < word_count; ++w)
+				words[w] |= p.words[w];
+			return *this;
+		}
+
+		constexpr packed_array& operator^=(const packed_array& p) noexcept
+		{
+			for (size_type w = 0; w < word_count; ++w)
+				words[w] ^= p.words[w];
+			return *this;
+		}
+
+		constexpr void swap(packed_array& p) noexcept { words.swap(p.words); }
+
+	private:
+		static constexpr word_type value_mask =
+			Bits == word_bits ? ~word_type(0) : (word_type(1) << Bits) - 1;
+
+		//bits of the last word past the last element
+		static constexpr size_type unused_bits = word_count * word_bits - N * Bits;
+
+		constexpr void _clear_unused() noexcept
+		{
+			if constexpr (unused_bits != 0)
+				words[word_count - 1] &= ~word_type(0) >> unused_bits;
+		}
+
+		static constexpr void _check_index(size_type i)
+		{
+			if (i >= N)
+				_throw_out_of_range("packed_array index out of range");
+		}
+
+	}; //template packed_array
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr packed_array<Bits, N> operator&(packed_array<Bits, N> a,
+		const packed_array<Bits, N>& b) noexcept
+	{
+		return a &= b;
+	}
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr packed_array<Bits, N> operator|(packed_array<Bits, N> a,
+		const packed_array<Bits, N>& b) noexcept
+	{
+		return a |= b;
+	}
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr packed_array<Bits, N> operator^(packed_array<Bits, N> a,
+		const packed_array<Bits, N>& b) noexcept
+	{
+		return a ^= b;
+	}
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr packed_array<Bits, N> operator~(packed_array<Bits, N> a) noexcept
+	{
+		return a.flip();
+	}
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr bool operator==(const packed_array<Bits, N>& a,
+		const packed_array<Bits, N>& b) noexcept
+	{
+		for (std::size_t w = 0; w < a.word_count; ++w)
+			if (a.words[w] != b.words[w])
+				return false;
+		return true;
+	}
+
+	template<std::size_t Bits, std::size_t N>
+	constexpr bool operator!=(const packed_array<Bits, N>& a,
+		const packed_array<Bits, N>& b) noexcept
+	{
+		return !(a == b);
+	}
+
+}	//namespace sigcpp
+
+#endif
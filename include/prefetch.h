@@ -0,0 +1,222 @@
+/*
+* prefetch.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define software prefetching and traversals that prefetch ahead
+* - prefetch(p) asks that the cache line holding p be loaded into all cache
+*   levels; it never faults and has no other effect
+* - prefetch_for_each(a, f, lines) calls f on each element of a, prefetching
+*   the element lines cache lines ahead once per line
+* - prefetch_gather_for_each(indexes, table, f, ahead) calls f on
+*   table[indexes[i]], prefetching the element ahead iterations later:
+*   hardware prefetchers follow strides, not indirection
+* - prefetch_iterator wraps array_iterator and prefetches ahead on each
+*   increment; prefetched(a, lines) is a range of them for range-for
+* - distances are tuning parameters: enough to cover memory latency at the
+*   rate f consumes elements, not so much that lines are evicted before use
+* - prefetching helps only data not already in cache: measure first
+*/
+
+#ifndef SIGCPP_PREFETCH_H
+#define SIGCPP_PREFETCH_H
+
+#include <cstddef>
+#include <iterator>
+
+#include "array.h"
+#include "aligned_array.h"
+#include "array_iterator.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	#if defined(_M_X64) || defined(_M_IX86)
+		#include <xmmintrin.h>
+	#elif defined(_M_ARM64)
+		#include <intrin.h>
+	#endif
+#endif
+
+namespace sigcpp
+{
+	//default distances: cache lines ahead for sequential traversals, and
+	//iterations ahead for indirect ones
+	inline constexpr std::size_t prefetch_distance = 8;
+	inline constexpr std::size_t prefetch_gather_distance = 16;
+
+	template<typename T>
+	inline void prefetch([[maybe_unused]] const T* p) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+		__prefetch(p);
+#endif
+	}
+
+	//elements of T per cache line: at least 1
+	template<typename T>
+	inline constexpr std::size_t _per_line =
+		sizeof(T) < cache_line_size ? cache_line_size / sizeof(T) : 1;
+
+	//call f on each of the n elements at first, in order
+	//-an element is prefetched only if it is in range
+	template<typename T, typename F>
+	void prefetch_for_each(T* first, std::size_t n, F f,
+		std::size_t lines = prefetch_distance)
+	{
+		constexpr std::size_t step = _per_line<T>;
+		const std::size_t ahead = lines * step;
+
+		for (std::size_t i = 0; i < n; i += step)
+		{
+			if (ahead < n - i)
+				prefetch(first + i + ahead);
+
+			const std::size_t last = n - i < step ? n : i + step;
+			for (std::size_t j = i; j < last; ++j)
+				f(first[j]);
+		}
+	}
+
+	template<typename T, std::size_t N, typename F>
+	void prefetch_for_each(array<T, N>& a, F f, std::size_t lines = prefetch_distance)
+	{
+		prefetch_for_each(a.data(), N, f, lines);
+	}
+
+	template<typename T, std::size_t N, typename F>
+	void prefetch_for_each(const array<T, N>& a, F f, std::size_t lines = prefetch_distance)
+	{
+		prefetch_for_each(a.data(), N, f, lines);
+	}
+
+	//call f(table[indexes[i]]) for each i, in order
+	//-Table is any contiguous range: array, std::vector, a C array
+	//-indexes must be in range of table, as f is called with each
+	template<typename I, std::size_t N, typename Table, typename F>
+	void prefetch_gather_for_each(const array<I, N>& indexes, Table& table, F f,
+		std::size_t ahead = prefetch_gather_distance)
+	{
+		const auto base = std::data(table);
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			if (ahead < N - i)
+				prefetch(base + indexes[i + ahead]);
+
+			f(table[indexes[i]]);
+		}
+	}
+
+
+	//forward iterator that prefetches ahead of an array_iterator
+	//-dereference, comparison, and checks are those of the wrapped iterator
+	//-each increment prefetches the element a fixed distance ahead if that
+	//is before the end given at construction
+	template<typename P> //P is a pointer type
+	class prefetch_iterator
+	{
+		using base_iterator = array_iterator<P>;
+
+	public:
+
+		//types
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename base_iterator::value_type;
+		using difference_type = typename base_iterator::difference_type;
+		using pointer = typename base_iterator::pointer;
+		using reference = typename base_iterator::reference;
+
+		//ctors
+		constexpr prefetch_iterator() noexcept = default;
+
+		prefetch_iterator(base_iterator it, base_iterator last,
+			std::size_t lines = prefetch_distance) noexcept
+			: current(it), lastPtr(last.base()),
+			ahead(static_cast<difference_type>(lines * _per_line<value_type>)) {}
+
+		//the wrapped iterator
+		constexpr base_iterator base() const noexcept { return current; }
+
+		//dereference and member access
+		constexpr reference operator*() const { return *current; }
+		constexpr pointer operator->() const { return current.operator->(); }
+
+		//increment
+		prefetch_iterator& operator++()
+		{
+			const P p = current.base();
+			++current;
+			if (ahead < lastPtr - p)
+				prefetch(p + ahead);
+			return *this;
+		}
+
+		prefetch_iterator operator++(int)
+		{
+			prefetch_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		//comparison
+		constexpr bool operator==(const prefetch_iterator& r) const
+		{
+			return current == r.current;
+		}
+
+		constexpr bool operator!=(const prefetch_iterator& r) const
+		{
+			return current != r.current;
+		}
+
+	private:
+		base_iterator current;
+		P lastPtr{ nullptr };
+		difference_type ahead{ 0 };
+
+	}; //template prefetch_iterator
+
+
+	//iterators over a range that prefetch ahead
+	template<typename P>
+	class prefetch_range
+	{
+	public:
+		using iterator = prefetch_iterator<P>;
+
+		prefetch_range(array_iterator<P> first, array_iterator<P> last,
+			std::size_t lines = prefetch_distance) noexcept
+			: firstIt(first, last, lines), lastIt(last, last, lines) {}
+
+		iterator begin() const noexcept { return firstIt; }
+		iterator end() const noexcept { return lastIt; }
+
+	private:
+		iterator firstIt;
+		iterator lastIt;
+
+	}; //template prefetch_range
+
+	template<typename T, std::size_t N>
+	prefetch_range<T*> prefetched(array<T, N>& a, std::size_t lines = prefetch_distance)
+	{
+		return prefetch_range<T*>(a.begin(), a.end(), lines);
+	}
+
+	template<typename T, std::size_t N>
+	prefetch_range<const T*> prefetched(const array<T, N>& a,
+		std::size_t lines = prefetch_distance)
+	{
+		return prefetch_range<const T*>(a.begin(), a.end(), lines);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,274 @@
+/*
+* ring_buffer.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for FIFO ring buffers of fixed capacity
+* - elements live in an array<T, N>: no heap allocation, ever
+* - N must be a power of two: positions are masked, not reduced modulo N
+* - head and tail are free-running counters: size is tail - head, and all
+*   N slots are usable
+* - slots are array elements: they are default constructed up front, and a
+*   popped slot keeps its (moved-from) value until it is overwritten
+* - push_n and pop_n copy as at most two contiguous spans
+* - not thread safe: see spsc_queue.h and mpmc_queue.h for concurrent use
+*/
+
+#ifndef SIGCPP_RING_BUFFER_H
+#define SIGCPP_RING_BUFFER_H
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "throw.h"
+#include "array.h"
+#include "ring_iterator.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N>
+	class ring_buffer
+	{
+		static_assert(N != 0 && (N & (N - 1)) == 0,
+			"ring_buffer capacity must be a power of two");
+
+	public:
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = ring_iterator<pointer, N>;
+		using const_iterator = ring_iterator<const_pointer, N>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//iterators: front to back
+		constexpr iterator begin() noexcept
+		{
+			return iterator(slots.data(), head, head, tail);
+		}
+
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+
+		constexpr iterator end() noexcept
+		{
+			return iterator(slots.data(), tail, head, tail);
+		}
+
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return crbegin();
+		}
+
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_iterator cbegin() const noexcept
+		{
+			return const_iterator(slots.data(), head, head, tail);
+		}
+
+		constexpr const_iterator cend() const noexcept
+		{
+			return const_iterator(slots.data(), tail, head, tail);
+		}
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(cend());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(cbegin());
+		}
+
+		//capacity
+		constexpr bool empty() const noexcept { return head == tail; }
+		constexpr bool full() const noexcept { return size() == N; }
+		constexpr size_type size() const noexcept { return tail - head; }
+		static constexpr size_type capacity() noexcept { return N; }
+		static constexpr size_type max_size() noexcept { return N; }
+
+		//unchecked element access: pos is relative to the front
+		constexpr reference operator[](size_type pos)
+		{
+			return slots[(head + pos) & mask];
+		}
+
+		constexpr const_reference operator[](size_type pos) const
+		{
+			return slots[(head + pos) & mask];
+		}
+
+		//checked element access
+		constexpr reference at(size_type pos)
+		{
+			return const_cast<reference>(std::as_const(*this).at(pos));
+		}
+
+		constexpr const_reference at(size_type pos) const
+		{
+			if (pos >= size())
+				_throw_out_of_range("ring_buffer index out of range");
+
+			return (*this)[pos];
+		}
+
+		constexpr reference front() { return slots[head & mask]; }
+		constexpr const_reference front() const { return slots[head & mask]; }
+		constexpr reference back() { return slots[(tail - 1) & mask]; }
+		constexpr const_reference back() const { return slots[(tail - 1) & mask]; }
+
+		//modifiers: push throws std::length_error if full; try_push returns
+		//false instead
+		constexpr void push_back(const T& v)
+		{
+			if (full())
+				_throw_length_error("ring_buffer is full");
+
+			slots[tail++ & mask] = v;
+		}
+
+		constexpr void push_back(T&& v)
+		{
+			if (full())
+				_throw_length_error("ring_buffer is full");
+
+			slots[tail++ & mask] = std::move(v);
+		}
+
+		constexpr bool try_push_back(const T& v)
+		{
+			if (full())
+				return false;
+
+			slots[tail++ & mask] = v;
+			return true;
+		}
+
+		constexpr bool try_push_back(T&& v)
+		{
+			if (full())
+				return false;
+
+			slots[tail++ & mask] = std::move(v);
+			return true;
+		}
+
+		//remove the front element: the buffer must not be empty
+		constexpr void pop_front() noexcept { ++head; }
+
+		//move the front element to v: false if empty
+		constexpr bool try_pop_front(T& v)
+		{
+			if (empty())
+				return false;
+
+			v = std::move(slots[head++ & mask]);
+			return true;
+		}
+
+		//copy up to n elements from src to the back: number copied
+		constexpr size_type push_n(const T* src, size_type n)
+		{
+			n = std::min(n, N - size());
+			_spans(tail, n, [&src](pointer slot, size_type count) {
+				_copy(src, count, slot);
+				src += count;
+			});
+			tail += n;
+			return n;
+		}
+
+		//move up to n elements from the front to dst: number moved
+		constexpr size_type pop_n(T* dst, size_type n)
+		{
+			n = std::min(n, size());
+			_spans(head, n, [&dst](pointer slot, size_type count) {
+				_move(slot, count, dst);
+				dst += count;
+			});
+			head += n;
+			return n;
+		}
+
+		//remove all elements: slots retain their values
+		constexpr void clear() noexcept { head = tail; }
+
+		constexpr void swap(ring_buffer& r) noexcept(std::is_nothrow_swappable_v<T>)
+		{
+			slots.swap(r.slots);
+			std::swap(head, r.head);
+			std::swap(tail, r.tail);
+		}
+
+	private:
+		static constexpr size_type mask = N - 1;
+
+		array<T, N> slots{};
+		size_type head{ 0 };
+		size_type tail{ 0 };
+
+		//call f(slot, count) for the one or two contiguous spans of n slots
+		//starting at position pos
+		template<typename F>
+		constexpr void _spans(size_type pos, size_type n, F f)
+		{
+			const size_type first = pos & mask;
+			const size_type firstCount = std::min(n, N - first);
+
+			if (firstCount != 0)
+				f(slots.data() + first, firstCount);
+
+			if (n != firstCount)
+				f(slots.data(), n - firstCount);
+		}
+
+		//loops rather than std::copy_n: that algorithm is constexpr from C++20
+		//-at run time, std::copy_n uses memmove for trivially-copyable T
+		static constexpr void _copy(const T* src, size_type n, T* dst)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				std::copy_n(src, n, dst);
+			else
+			{
+				for (size_type i = 0; i < n; ++i)
+					dst[i] = src[i];
+			}
+		}
+
+		static constexpr void _move(T* src, size_type n, T* dst)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED())
+				std::move(src, src + n, dst);
+			else
+			{
+				for (size_type i = 0; i < n; ++i)
+					dst[i] = std::move(src[i]);
+			}
+		}
+
+	}; //template ring_buffer
+
+}	//namespace sigcpp
+
+#endif
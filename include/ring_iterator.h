@@ -0,0 +1,258 @@
+/*
+* ring_iterator.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a template for random-access iterators that wrap around a raw array
+* - modeled on array_iterator: see array_iterator.h
+* - the position is a free-running counter: the element is base[pos & (N-1)]
+* - N must be a power of two; counters wrap modulo 2^bits with no error
+*/
+
+#ifndef SIGCPP_RING_ITERATOR_H
+#define SIGCPP_RING_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	template<typename P, std::size_t N> //P is a pointer type
+	class ring_iterator
+	{
+		static_assert(N != 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+	public:
+
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = typename std::iterator_traits<P>::value_type;
+		using difference_type = typename std::iterator_traits<P>::difference_type;
+		using pointer = typename std::iterator_traits<P>::pointer;
+		using reference = typename std::iterator_traits<P>::reference;
+		using size_type = std::size_t;
+
+		//ctors
+		//-an iterator made from just a base and position is never checked
+		//-the range [first, last) of positions is retained only if iterators
+		//are checked
+		constexpr ring_iterator() noexcept = default;
+		constexpr ring_iterator(P base, size_type p) noexcept
+			: basePtr(base), pos(p) {}
+
+#if SIGCPP_ITERATOR_DEBUG
+		constexpr ring_iterator(P base, size_type p, size_type first,
+			size_type last) noexcept
+			: basePtr(base), pos(p), rangeFirst(first), rangeLast(last),
+			checked(true) {}
+#else
+		constexpr ring_iterator(P base, size_type p, size_type, size_type) noexcept
+			: basePtr(base), pos(p) {}
+#endif
+
+		//conversion from iterator to const_iterator
+		template<typename Q,
+			typename = std::enable_if_t<std::is_convertible_v<Q, P>>>
+		constexpr ring_iterator(const ring_iterator<Q, N>& it) noexcept
+#if SIGCPP_ITERATOR_DEBUG
+			: basePtr(it.basePtr), pos(it.pos), rangeFirst(it.rangeFirst),
+			rangeLast(it.rangeLast), checked(it.checked) {}
+#else
+			: basePtr(it.basePtr), pos(it.pos) {}
+#endif
+
+		//the wrapped array and the unmasked position
+		constexpr P base() const noexcept { return basePtr; }
+		constexpr size_type position() const noexcept { return pos; }
+
+		//dereference and member access
+		constexpr reference operator*() const
+		{
+			_check_deref(0);
+			return basePtr[pos & mask];
+		}
+
+		constexpr pointer operator->() const noexcept(!SIGCPP_ITERATOR_DEBUG)
+		{
+			_check_deref(0);
+			return basePtr + (pos & mask);
+		}
+
+		//element access
+		constexpr reference operator[](difference_type n) const
+		{
+			_check_deref(n);
+			return basePtr[(pos + static_cast<size_type>(n)) & mask];
+		}
+
+		//increment and decrement
+		constexpr ring_iterator& operator++()
+		{
+			_check_move(1);
+			++pos;
+			return *this;
+		}
+
+		constexpr ring_iterator operator++(int)
+		{
+			ring_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		constexpr ring_iterator& operator--()
+		{
+			_check_move(-1);
+			--pos;
+			return *this;
+		}
+
+		constexpr ring_iterator operator--(int)
+		{
+			ring_iterator beforeDecrement = *this;
+			--*this;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr ring_iterator operator+(difference_type n) const
+		{
+			ring_iterator t = *this;
+			t += n;
+			return t;
+		}
+
+		constexpr ring_iterator operator-(difference_type n) const
+		{
+			ring_iterator t = *this;
+			t -= n;
+			return t;
+		}
+
+		constexpr ring_iterator& operator+=(difference_type n)
+		{
+			_check_move(n);
+			pos += static_cast<size_type>(n);
+			return *this;
+		}
+
+		constexpr ring_iterator& operator-=(difference_type n)
+		{
+			_check_move(-n);
+			pos -= static_cast<size_type>(n);
+			return *this;
+		}
+
+		constexpr difference_type operator-(const ring_iterator& r) const
+		{
+			_check_same(r);
+			return _distance(r.pos, pos);
+		}
+
+		friend constexpr ring_iterator operator+(difference_type n,
+			const ring_iterator& it)
+		{
+			return it + n;
+		}
+
+		//comparison: by distance, so that order survives counter wrap-around
+		constexpr bool operator==(const ring_iterator& r) const
+		{
+			_check_same(r);
+			return pos == r.pos;
+		}
+
+		constexpr bool operator!=(const ring_iterator& r) const
+		{
+			_check_same(r);
+			return pos != r.pos;
+		}
+
+		constexpr bool operator<(const ring_iterator& r) const
+		{
+			_check_same(r);
+			return _distance(r.pos, pos) < 0;
+		}
+
+		constexpr bool operator>(const ring_iterator& r) const
+		{
+			_check_same(r);
+			return _distance(r.pos, pos) > 0;
+		}
+
+		constexpr bool operator<=(const ring_iterator& r) const
+		{
+			return !(r < *this);
+		}
+
+		constexpr bool operator>=(const ring_iterator& r) const
+		{
+			return !(*this < r);
+		}
+
+	private:
+		template<typename Q, std::size_t M> friend class ring_iterator;
+
+		static constexpr size_type mask = N - 1;
+
+		P basePtr{ nullptr };
+		size_type pos{ 0 };
+
+#if SIGCPP_ITERATOR_DEBUG
+		size_type rangeFirst{ 0 };
+		size_type rangeLast{ 0 };
+		bool checked{ false };
+#endif
+
+		//signed distance from position a to position b
+		static constexpr difference_type _distance(size_type a, size_type b) noexcept
+		{
+			return static_cast<difference_type>(b - a);
+		}
+
+		//checks: no-ops if iterators are unchecked or the range is unknown
+
+		//element at offset n from pos must be in range
+		constexpr void _check_deref([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (checked && !(_distance(pos, rangeFirst) <= n &&
+				n < _distance(pos, rangeLast)))
+				_iterator_failure("ring_iterator: dereference out of range");
+#endif
+		}
+
+		//moving by n must stay within [first, last]
+		constexpr void _check_move([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (checked && !(_distance(pos, rangeFirst) <= n &&
+				n <= _distance(pos, rangeLast)))
+				_iterator_failure("ring_iterator: arithmetic out of range");
+#endif
+		}
+
+		//iterators compared or subtracted must share a range
+		constexpr void _check_same([[maybe_unused]] const ring_iterator& r) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (basePtr != r.basePtr || rangeFirst != r.rangeFirst ||
+				rangeLast != r.rangeLast)
+				_iterator_failure("ring_iterator: iterators of different ranges");
+#endif
+		}
+
+	}; //template ring_iterator
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,115 @@
+/*
+* search.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define searches of sorted ranges for lookup tables
+* - branchless_lower_bound is std::lower_bound with a conditional move in
+*   place of the branch: no mispredictions, a fixed number of steps for n
+* - the Eytzinger layout stores a sorted range in breadth-first order of its
+*   implicit binary search tree: node k has children 2k and 2k + 1, so the
+*   first levels share cache lines and later levels are prefetched
+* - eytzinger_order<N> is the sorted rank of each slot of the layout;
+*   eytzinger_lower_bound searches a range stored in that order
+* - Khuong and Morin, "Array Layouts for Comparison-Based Searching", 2017
+* - all functions are constexpr: tables can be searched at compile time
+*/
+
+#ifndef SIGCPP_SEARCH_H
+#define SIGCPP_SEARCH_H
+
+#include <cstddef>
+
+#include "config.h"
+#include "bit.h"
+#include "array.h"
+#include "aligned_array.h"
+#include "prefetch.h"
+
+namespace sigcpp
+{
+	//first of the n elements at first not ordered before value; first + n if none
+	template<typename T, typename V, typename Compare>
+	constexpr const T* branchless_lower_bound(const T* first, std::size_t n,
+		const V& value, Compare comp)
+	{
+		if (n == 0)
+			return first;
+
+		//the answer is in [first, first + n]: halve n keeping that true
+		while (n > 1)
+		{
+			const std::size_t half = n / 2;
+			first = comp(first[half], value) ? first + half : first;
+			n -= half;
+		}
+		return first + static_cast<std::size_t>(comp(*first, value));
+	}
+
+	//breadth-first slot k (0-based) holds the element of sorted rank order[k]
+	template<std::size_t N>
+	constexpr array<std::size_t, N> _make_eytzinger_order()
+	{
+		array<std::size_t, N> order{};
+
+		//in-order walk of the implicit tree (root 1) visits ranks in order
+		std::size_t rank = 0, k = 1;
+		while (rank < N)
+		{
+			while (k <= N)
+				k *= 2;
+
+			//k is past a leaf: climb while coming from a right child
+			k >>= countr_zero(~k) + 1;
+			order[k - 1] = rank++;
+			k = 2 * k + 1;
+		}
+		return order;
+	}
+
+	template<std::size_t N>
+	inline constexpr array<std::size_t, N> eytzinger_order = _make_eytzinger_order<N>();
+
+	//slot of the first element in the Eytzinger-ordered range at b not ordered
+	//before value; n if none
+	template<typename T, typename V, typename Compare>
+	constexpr std::size_t eytzinger_lower_bound(const T* b, std::size_t n,
+		const V& value, Compare comp)
+	{
+		//children four levels down share a cache line for 4-byte elements
+		constexpr std::size_t ahead = sizeof(T) < cache_line_size ?
+			cache_line_size / sizeof(T) : 1;
+
+		std::size_t k = 1;
+		while (k <= n)
+		{
+			if (!SIGCPP_IS_CONSTANT_EVALUATED() && k * ahead <= n)
+				prefetch(b + (k * ahead - 1));
+
+			k = 2 * k + static_cast<std::size_t>(comp(b[k - 1], value));
+		}
+
+		//the answer is the last node left by its left child: drop the trailing
+		//right turns and that left turn
+		k >>= countr_zero(~k) + 1;
+		return k == 0 ? n : k - 1;
+	}
+
+	//a sorted array in Eytzinger order
+	template<typename T, std::size_t N>
+	constexpr array<T, N> to_eytzinger(const array<T, N>& sorted)
+	{
+		array<T, N> b{};
+		for (std::size_t k = 0; k < N; ++k)
+			b[k] = sorted[eytzinger_order<N>[k]];
+		return b;
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,566 @@
+/*
+* simd.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define thin wrappers over SIMD registers for use in bulk algorithms
+* - one register width per build: AVX2 if enabled, else SSE2 or NEON
+* - define SIGCPP_NO_SIMD to disable all SIMD paths
+*
+* vector_traits<T> describes the native vector of T:
+* - supported: false if T has no vector type; no other members exist then
+* - arithmetic: true if add, mul, min, and max are available
+* - reg: register type; width: number of lanes
+* - load/load_aligned/store/set1: move data in and out of registers
+* - eq_mask(a, b): one bit per lane, bit i set if lane i of a equals that of b
+*
+* narrow_traits<T> has the same members for a 128-bit vector of T, for data
+* too short to fill a native register: it differs from vector_traits<T> only
+* for float and double with AVX2
+*/
+
+#ifndef SIGCPP_SIMD_H
+#define SIGCPP_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(SIGCPP_NO_SIMD)
+	#if defined(__AVX2__)
+		#define SIGCPP_SIMD_AVX2 1
+		#include <immintrin.h>
+	#elif defined(__SSE2__) || defined(_M_X64) || \
+		(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define SIGCPP_SIMD_SSE2 1
+		#include <emmintrin.h>
+		#if defined(__SSE4_1__)
+			#include <smmintrin.h>
+		#endif
+	#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+		#define SIGCPP_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+namespace sigcpp::simd
+{
+	//bytes in the widest register available; 0 without SIMD
+#if defined(SIGCPP_SIMD_AVX2)
+	inline constexpr std::size_t register_size = 32;
+#elif defined(SIGCPP_SIMD_SSE2) || defined(SIGCPP_SIMD_NEON)
+	inline constexpr std::size_t register_size = 16;
+#else
+	inline constexpr std::size_t register_size = 0;
+#endif
+
+	template<typename T>
+	struct vector_traits
+	{
+		static constexpr bool supported = false;
+		static constexpr bool arithmetic = false;
+	};
+
+	//mask with the low n bits set
+	constexpr unsigned lane_mask(std::size_t n) noexcept
+	{
+		return n >= 32 ? ~0u : (1u << n) - 1;
+	}
+
+
+#if defined(SIGCPP_SIMD_AVX2)
+
+	template<>
+	struct vector_traits<float>
+	{
+		using reg = __m256;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 8;
+
+		static reg load(const float* p) { return _mm256_loadu_ps(p); }
+		static reg load_aligned(const float* p) { return _mm256_load_ps(p); }
+		static void store(float* p, reg a) { _mm256_storeu_ps(p, a); }
+		static reg set1(float v) { return _mm256_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+		static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(
+				_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+		}
+	};
+
+	template<>
+	struct vector_traits<double>
+	{
+		using reg = __m256d;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const double* p) { return _mm256_loadu_pd(p); }
+		static reg load_aligned(const double* p) { return _mm256_load_pd(p); }
+		static void store(double* p, reg a) { _mm256_storeu_pd(p, a); }
+		static reg set1(double v) { return _mm256_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(
+				_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+		}
+	};
+
+	//integer lanes share loads, stores, and comparison
+	template<typename T, std::size_t W>
+	struct integer_traits
+	{
+		using reg = __m256i;
+		static constexpr bool supported = true;
+		static constexpr std::size_t width = W;
+
+		static reg load(const T* p)
+		{
+			return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		}
+
+		static reg load_aligned(const T* p)
+		{
+			return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+		}
+
+		static void store(T* p, reg a)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a);
+		}
+	};
+
+	template<>
+	struct vector_traits<std::int32_t> : integer_traits<std::int32_t, 8>
+	{
+		static constexpr bool arithmetic = true;
+
+		static reg set1(std::int32_t v) { return _mm256_set1_epi32(v); }
+		static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+		static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm256_movemask_ps(
+				_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+		}
+	};
+
+	template<>
+	struct vector_traits<std::uint32_t> : integer_traits<std::uint32_t, 8>
+	{
+		static constexpr bool arithmetic = true;
+
+		static reg set1(std::uint32_t v)
+		{
+			return _mm256_set1_epi32(static_cast<int>(v));
+		}
+
+		static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+		static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+		static reg min(reg a, reg b) { return _mm256_min_epu32(a, b); }
+		static reg max(reg a, reg b) { return _mm256_max_epu32(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm256_movemask_ps(
+				_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+		}
+	};
+
+	//byte lanes: equality only
+	template<typename T>
+	struct byte_traits : integer_traits<T, 32>
+	{
+		using reg = __m256i;
+		static constexpr bool arithmetic = false;
+
+		static reg set1(T v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(
+				_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+		}
+	};
+
+#elif defined(SIGCPP_SIMD_SSE2)
+
+	template<>
+	struct vector_traits<float>
+	{
+		using reg = __m128;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const float* p) { return _mm_loadu_ps(p); }
+		static reg load_aligned(const float* p) { return _mm_load_ps(p); }
+		static void store(float* p, reg a) { _mm_storeu_ps(p, a); }
+		static reg set1(float v) { return _mm_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+		}
+	};
+
+	template<>
+	struct vector_traits<double>
+	{
+		using reg = __m128d;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 2;
+
+		static reg load(const double* p) { return _mm_loadu_pd(p); }
+		static reg load_aligned(const double* p) { return _mm_load_pd(p); }
+		static void store(double* p, reg a) { _mm_storeu_pd(p, a); }
+		static reg set1(double v) { return _mm_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+		}
+	};
+
+	template<typename T, std::size_t W>
+	struct integer_traits
+	{
+		using reg = __m128i;
+		static constexpr bool supported = true;
+		static constexpr std::size_t width = W;
+
+		static reg load(const T* p)
+		{
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		}
+
+		static reg load_aligned(const T* p)
+		{
+			return _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+		}
+
+		static void store(T* p, reg a)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), a);
+		}
+
+		//select a where m is set, b elsewhere
+		static reg select(reg m, reg a, reg b)
+		{
+			return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+		}
+	};
+
+	template<>
+	struct vector_traits<std::int32_t> : integer_traits<std::int32_t, 4>
+	{
+		static constexpr bool arithmetic = true;
+
+		static reg set1(std::int32_t v) { return _mm_set1_epi32(v); }
+		static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+
+	#if defined(__SSE4_1__)
+		static reg mul(reg a, reg b) { return _mm_mullo_epi32(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_epi32(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_epi32(a, b); }
+	#else
+		//SSE2 has no 32-bit multiply-low: multiply even and odd lanes
+		static reg mul(reg a, reg b)
+		{
+			reg even = _mm_mul_epu32(a, b);
+			reg odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+			return _mm_unpacklo_epi32(
+				_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+				_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+
+		static reg min(reg a, reg b)
+		{
+			return select(_mm_cmpgt_epi32(a, b), b, a);
+		}
+
+		static reg max(reg a, reg b)
+		{
+			return select(_mm_cmpgt_epi32(a, b), a, b);
+		}
+	#endif
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(
+				_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+		}
+	};
+
+	template<>
+	struct vector_traits<std::uint32_t> : integer_traits<std::uint32_t, 4>
+	{
+		static constexpr bool arithmetic = true;
+
+		static reg set1(std::uint32_t v)
+		{
+			return _mm_set1_epi32(static_cast<int>(v));
+		}
+
+		static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+
+		static reg mul(reg a, reg b)
+		{
+			return vector_traits<std::int32_t>::mul(a, b);
+		}
+
+	#if defined(__SSE4_1__)
+		static reg min(reg a, reg b) { return _mm_min_epu32(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_epu32(a, b); }
+	#else
+		//unsigned compare: flip the sign bits and compare signed
+		static reg greater(reg a, reg b)
+		{
+			const reg bias = _mm_set1_epi32(INT32_MIN);
+			return _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+		}
+
+		static reg min(reg a, reg b) { return select(greater(a, b), b, a); }
+		static reg max(reg a, reg b) { return select(greater(a, b), a, b); }
+	#endif
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(
+				_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+		}
+	};
+
+	template<typename T>
+	struct byte_traits : integer_traits<T, 16>
+	{
+		using reg = __m128i;
+		static constexpr bool arithmetic = false;
+
+		static reg set1(T v) { return _mm_set1_epi8(static_cast<char>(v)); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+		}
+	};
+
+#elif defined(SIGCPP_SIMD_NEON)
+
+	//NEON has no movemask: weight each lane by its bit and add across lanes
+	inline unsigned lane_bits(uint32x4_t m)
+	{
+		const uint32x4_t bits = { 1, 2, 4, 8 };
+		return vaddvq_u32(vandq_u32(m, bits));
+	}
+
+	inline unsigned lane_bits(uint64x2_t m)
+	{
+		const uint64x2_t bits = { 1, 2 };
+		return static_cast<unsigned>(vaddvq_u64(vandq_u64(m, bits)));
+	}
+
+	inline unsigned lane_bits(uint8x16_t m)
+	{
+		const uint8x16_t bits = { 1, 2, 4, 8, 16, 32, 64, 128,
+		                          1, 2, 4, 8, 16, 32, 64, 128 };
+		uint8x16_t b = vandq_u8(m, bits);
+		return vaddv_u8(vget_low_u8(b)) |
+			(static_cast<unsigned>(vaddv_u8(vget_high_u8(b))) << 8);
+	}
+
+	template<>
+	struct vector_traits<float>
+	{
+		using reg = float32x4_t;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const float* p) { return vld1q_f32(p); }
+		static reg load_aligned(const float* p) { return vld1q_f32(p); }
+		static void store(float* p, reg a) { vst1q_f32(p, a); }
+		static reg set1(float v) { return vdupq_n_f32(v); }
+		static reg add(reg a, reg b) { return vaddq_f32(a, b); }
+		static reg mul(reg a, reg b) { return vmulq_f32(a, b); }
+		static reg min(reg a, reg b) { return vminq_f32(a, b); }
+		static reg max(reg a, reg b) { return vmaxq_f32(a, b); }
+		static unsigned eq_mask(reg a, reg b) { return lane_bits(vceqq_f32(a, b)); }
+	};
+
+	template<>
+	struct vector_traits<double>
+	{
+		using reg = float64x2_t;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 2;
+
+		static reg load(const double* p) { return vld1q_f64(p); }
+		static reg load_aligned(const double* p) { return vld1q_f64(p); }
+		static void store(double* p, reg a) { vst1q_f64(p, a); }
+		static reg set1(double v) { return vdupq_n_f64(v); }
+		static reg add(reg a, reg b) { return vaddq_f64(a, b); }
+		static reg mul(reg a, reg b) { return vmulq_f64(a, b); }
+		static reg min(reg a, reg b) { return vminq_f64(a, b); }
+		static reg max(reg a, reg b) { return vmaxq_f64(a, b); }
+		static unsigned eq_mask(reg a, reg b) { return lane_bits(vceqq_f64(a, b)); }
+	};
+
+	template<>
+	struct vector_traits<std::int32_t>
+	{
+		using reg = int32x4_t;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const std::int32_t* p) { return vld1q_s32(p); }
+		static reg load_aligned(const std::int32_t* p) { return vld1q_s32(p); }
+		static void store(std::int32_t* p, reg a) { vst1q_s32(p, a); }
+		static reg set1(std::int32_t v) { return vdupq_n_s32(v); }
+		static reg add(reg a, reg b) { return vaddq_s32(a, b); }
+		static reg mul(reg a, reg b) { return vmulq_s32(a, b); }
+		static reg min(reg a, reg b) { return vminq_s32(a, b); }
+		static reg max(reg a, reg b) { return vmaxq_s32(a, b); }
+		static unsigned eq_mask(reg a, reg b) { return lane_bits(vceqq_s32(a, b)); }
+	};
+
+	template<>
+	struct vector_traits<std::uint32_t>
+	{
+		using reg = uint32x4_t;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const std::uint32_t* p) { return vld1q_u32(p); }
+		static reg load_aligned(const std::uint32_t* p) { return vld1q_u32(p); }
+		static void store(std::uint32_t* p, reg a) { vst1q_u32(p, a); }
+		static reg set1(std::uint32_t v) { return vdupq_n_u32(v); }
+		static reg add(reg a, reg b) { return vaddq_u32(a, b); }
+		static reg mul(reg a, reg b) { return vmulq_u32(a, b); }
+		static reg min(reg a, reg b) { return vminq_u32(a, b); }
+		static reg max(reg a, reg b) { return vmaxq_u32(a, b); }
+		static unsigned eq_mask(reg a, reg b) { return lane_bits(vceqq_u32(a, b)); }
+	};
+
+	//byte lanes: equality only; all byte types are handled as uint8_t
+	template<typename T>
+	struct byte_traits
+	{
+		using reg = uint8x16_t;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = false;
+		static constexpr std::size_t width = 16;
+
+		static reg load(const T* p)
+		{
+			return vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+		}
+
+		static reg load_aligned(const T* p) { return load(p); }
+
+		static void store(T* p, reg a)
+		{
+			vst1q_u8(reinterpret_cast<std::uint8_t*>(p), a);
+		}
+
+		static reg set1(T v) { return vdupq_n_u8(static_cast<std::uint8_t>(v)); }
+		static unsigned eq_mask(reg a, reg b) { return lane_bits(vceqq_u8(a, b)); }
+	};
+
+#endif
+
+#if defined(SIGCPP_SIMD_AVX2) || defined(SIGCPP_SIMD_SSE2) || \
+	defined(SIGCPP_SIMD_NEON)
+	template<> struct vector_traits<char> : byte_traits<char> {};
+	template<> struct vector_traits<signed char> : byte_traits<signed char> {};
+	template<> struct vector_traits<unsigned char> : byte_traits<unsigned char> {};
+#endif
+
+	//128-bit vector of T: the native vector, except float and double with AVX2
+	template<typename T>
+	struct narrow_traits : vector_traits<T> {};
+
+#if defined(SIGCPP_SIMD_AVX2)
+
+	template<>
+	struct narrow_traits<float>
+	{
+		using reg = __m128;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 4;
+
+		static reg load(const float* p) { return _mm_loadu_ps(p); }
+		static reg load_aligned(const float* p) { return _mm_load_ps(p); }
+		static void store(float* p, reg a) { _mm_storeu_ps(p, a); }
+		static reg set1(float v) { return _mm_set1_ps(v); }
+		static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b)));
+		}
+	};
+
+	template<>
+	struct narrow_traits<double>
+	{
+		using reg = __m128d;
+		static constexpr bool supported = true;
+		static constexpr bool arithmetic = true;
+		static constexpr std::size_t width = 2;
+
+		static reg load(const double* p) { return _mm_loadu_pd(p); }
+		static reg load_aligned(const double* p) { return _mm_load_pd(p); }
+		static void store(double* p, reg a) { _mm_storeu_pd(p, a); }
+		static reg set1(double v) { return _mm_set1_pd(v); }
+		static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+		static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+		static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+		static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+
+		static unsigned eq_mask(reg a, reg b)
+		{
+			return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+		}
+	};
+
+#endif
+
+}	//namespace sigcpp::simd
+
+#endif
@@ -0,0 +1,553 @@
+/*
+* small_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for vectors with inline capacity
+* - up to N elements live in the object itself; more spill to the heap
+* - once spilled, elements stay on the heap until the vector is destroyed,
+*   moved from, or shrunk to fit in inline storage
+* - moving a spilled vector steals its heap buffer; moving an inline vector
+*   moves its elements; either way the source is left empty
+* - iterators are array_iterator: they are invalidated on spill and growth,
+*   as with std::vector reallocation
+*/
+
+#ifndef SIGCPP_SMALL_VECTOR_H
+#define SIGCPP_SMALL_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+#include "config.h"
+#include "throw.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N>
+	class small_vector
+	{
+	public:
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = array_iterator<pointer>;
+		using const_iterator = array_iterator<const_pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static_assert(N != 0, "small_vector requires inline capacity");
+
+		//ctors
+		small_vector() noexcept : first(_inline_data()) {}
+
+		explicit small_vector(size_type n) : small_vector()
+		{
+			resize(n);
+		}
+
+		small_vector(size_type n, const T& v) : small_vector()
+		{
+			resize(n, v);
+		}
+
+		template<typename InputIt,
+			typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+		small_vector(InputIt first, InputIt last) : small_vector()
+		{
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+
+		small_vector(std::initializer_list<T> list) : small_vector()
+		{
+			reserve(list.size());
+			std::uninitialized_copy(list.begin(), list.end(), first);
+			count = list.size();
+		}
+
+		small_vector(const small_vector& v) : small_vector()
+		{
+			reserve(v.size());
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				if (!v.empty())
+					std::memcpy(first, v.first, v.size() * sizeof(T));
+			}
+			else
+				std::uninitialized_copy_n(v.first, v.size(), first);
+
+			count = v.count;
+		}
+
+		small_vector(small_vector&& v)
+			noexcept(std::is_nothrow_move_constructible_v<T>) : small_vector()
+		{
+			_take(v);
+		}
+
+		~small_vector()
+		{
+			_destroy(first, _end());
+			_deallocate();
+		}
+
+		small_vector& operator=(const small_vector& v)
+		{
+			if (this != &v)
+			{
+				reserve(v.size());
+
+				const size_type common = std::min(size(), v.size());
+				std::copy_n(v.first, common, first);
+
+				if (v.size() < size())
+					_destroy(first + v.size(), _end());
+				else
+					std::uninitialized_copy(v.data() + common, v._end(), _end());
+
+				count = v.count;
+			}
+			return *this;
+		}
+
+		small_vector& operator=(small_vector&& v)
+			noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			if (this != &v)
+			{
+				clear();
+				_deallocate();
+				first = _inline_data();
+				capacityAvailable = N;
+				_take(v);
+			}
+			return *this;
+		}
+
+		small_vector& operator=(std::initializer_list<T> list)
+		{
+			clear();
+			reserve(list.size());
+			std::uninitialized_copy(list.begin(), list.end(), first);
+			count = list.size();
+			return *this;
+		}
+
+		//iterators
+		iterator begin() noexcept { return iterator(first, first, _end()); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(_end(), first, _end()); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return crbegin();
+		}
+
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept
+		{
+			return const_iterator(first, first, _end());
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return const_iterator(_end(), first, _end());
+		}
+
+		const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(cend());
+		}
+
+		const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(cbegin());
+		}
+
+		//capacity
+		bool empty() const noexcept { return count == 0; }
+		size_type size() const noexcept { return count; }
+		size_type capacity() const noexcept { return capacityAvailable; }
+		static constexpr size_type inline_capacity() noexcept { return N; }
+
+		size_type max_size() const noexcept
+		{
+			return std::allocator_traits<std::allocator<T>>::max_size(
+				std::allocator<T>());
+		}
+
+		//true if elements are in inline storage
+		bool is_inline() const noexcept { return first == _inline_data(); }
+
+		void reserve(size_type n)
+		{
+			if (n > capacityAvailable)
+				_reallocate(n);
+		}
+
+		//return to inline storage if the elements fit, else trim heap storage
+		void shrink_to_fit()
+		{
+			if (!is_inline() && count < capacityAvailable)
+				_reallocate(count);
+		}
+
+		void resize(size_type n) { _resize(n, [](pointer p) { ::new (p) T(); }); }
+
+		void resize(size_type n, const T& v)
+		{
+			//copy first: v may be an element that is relocated on growth
+			T copy(v);
+			_resize(n, [&copy](pointer p) { ::new (p) T(copy); });
+		}
+
+		//unchecked element access
+		reference operator[](size_type pos) { return first[pos]; }
+		const_reference operator[](size_type pos) const { return first[pos]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			return const_cast<reference>(std::as_const(*this).at(pos));
+		}
+
+		const_reference at(size_type pos) const
+		{
+			if (pos >= size())
+				_throw_out_of_range("small_vector index out of range");
+
+			return first[pos];
+		}
+
+		pointer try_at(size_type pos) noexcept
+		{
+			return pos < size() ? first + pos : nullptr;
+		}
+
+		const_pointer try_at(size_type pos) const noexcept
+		{
+			return pos < size() ? first + pos : nullptr;
+		}
+
+		reference front() { return first[0]; }
+		const_reference front() const { return first[0]; }
+		reference back() { return first[count - 1]; }
+		const_reference back() const { return first[count - 1]; }
+
+		//underlying raw data
+		pointer data() noexcept { return first; }
+		const_pointer data() const noexcept { return first; }
+
+		//modifiers
+		template<typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			if (count == capacityAvailable)
+				return _grow_emplace_back(std::forward<Args>(args)...);
+
+			pointer p = ::new (_end()) T(std::forward<Args>(args)...);
+			++count;
+			return *p;
+		}
+
+		void push_back(const T& v) { emplace_back(v); }
+		void push_back(T&& v) { emplace_back(std::move(v)); }
+
+		void pop_back()
+		{
+			--count;
+			_destroy(_end(), _end() + 1);
+		}
+
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args)
+		{
+			const size_type index = _index(pos);
+
+			if (index == size())
+				emplace_back(std::forward<Args>(args)...);
+			else
+			{
+				//construct first: args may refer to an element being moved
+				T v(std::forward<Args>(args)...);
+				if (count == capacityAvailable)
+					reserve(_next_capacity(count + 1));
+
+				pointer p = first + index;
+				if constexpr (std::is_trivially_copyable_v<T>)
+				{
+					std::memmove(p + 1, p, (size() - index) * sizeof(T));
+					::new (p) T(v);
+					++count;
+				}
+				else
+				{
+					::new (_end()) T(std::move(*(_end() - 1)));
+					++count;
+					std::move_backward(p, _end() - 2, _end() - 1);
+					*p = std::move(v);
+				}
+			}
+
+			return begin() + static_cast<difference_type>(index);
+		}
+
+		iterator insert(const_iterator pos, const T& v) { return emplace(pos, v); }
+
+		iterator insert(const_iterator pos, T&& v)
+		{
+			return emplace(pos, std::move(v));
+		}
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		iterator erase(const_iterator from, const_iterator to)
+		{
+			const size_type index = _index(from);
+			const size_type n = _index(to) - index;
+
+			if (n != 0)
+			{
+				pointer p = first + index;
+				const size_type tail = size() - index - n;
+				if constexpr (std::is_trivially_copyable_v<T>)
+				{
+					if (tail != 0)
+						std::memmove(p, p + n, tail * sizeof(T));
+				}
+				else
+					std::move(p + n, _end(), p);
+
+				_destroy(_end() - n, _end());
+				count -= n;
+			}
+
+			return begin() + static_cast<difference_type>(index);
+		}
+
+		void clear() noexcept
+		{
+			_destroy(first, _end());
+			count = 0;
+		}
+
+		void swap(small_vector& v)
+			noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			if (this == &v)
+				return;
+
+			if (!is_inline() && !v.is_inline())
+			{
+				std::swap(first, v.first);
+				std::swap(count, v.count);
+				std::swap(capacityAvailable, v.capacityAvailable);
+			}
+			else
+			{
+				small_vector t(std::move(v));
+				v = std::move(*this);
+				*this = std::move(t);
+			}
+		}
+
+	private:
+		//first element: inline storage or heap buffer
+		pointer first;
+		size_type count{ 0 };
+		size_type capacityAvailable{ N };
+
+		//uninitialized storage for N elements, laid out as array::values
+		alignas(T) unsigned char storage[N * sizeof(T)];
+
+		pointer _inline_data() noexcept { return reinterpret_cast<pointer>(storage); }
+
+		const_pointer _inline_data() const noexcept
+		{
+			return reinterpret_cast<const_pointer>(storage);
+		}
+
+		pointer _end() noexcept { return first + count; }
+		const_pointer _end() const noexcept { return first + count; }
+
+		size_type _index(const_iterator pos) const noexcept
+		{
+			return static_cast<size_type>(pos.base() - first);
+		}
+
+		//grow geometrically so that n push_backs cost O(n) moves
+		size_type _next_capacity(size_type needed) const noexcept
+		{
+			return std::max(needed, 2 * capacityAvailable);
+		}
+
+		static void _destroy([[maybe_unused]] pointer from,
+			[[maybe_unused]] pointer to) noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				std::destroy(from, to);
+		}
+
+		void _deallocate() noexcept
+		{
+			if (!is_inline())
+				std::allocator<T>().deallocate(first, capacityAvailable);
+		}
+
+		//move count elements from src to uninitialized dst
+		static void _relocate(pointer src, size_type n, pointer dst)
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				if (n != 0)
+					std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+			}
+			else
+			{
+				if constexpr (std::is_nothrow_move_constructible_v<T> ||
+						!std::is_copy_constructible_v<T>)
+					std::uninitialized_move_n(src, n, dst);
+				else
+					std::uninitialized_copy_n(src, n, dst);
+				_destroy(src, src + n);
+			}
+		}
+
+		//move elements to storage for n elements: inline if they fit
+		void _reallocate(size_type n)
+		{
+			pointer buffer = n <= N ? _inline_data() : std::allocator<T>().allocate(n);
+			if (buffer == first)
+				return;
+
+			//a throwing copy leaves the elements in place: free the buffer
+			try
+			{
+				_relocate(first, count, buffer);
+			}
+			catch (...)
+			{
+				if (n > N)
+					std::allocator<T>().deallocate(buffer, n);
+				throw;
+			}
+
+			_deallocate();
+			first = buffer;
+			capacityAvailable = n <= N ? N : n;
+		}
+
+		//construct the new element before relocating: args may refer to an
+		//existing element
+		template<typename... Args>
+		reference _grow_emplace_back(Args&&... args)
+		{
+			const size_type n = _next_capacity(count + 1);
+			pointer buffer = std::allocator<T>().allocate(n);
+
+			try
+			{
+				::new (buffer + count) T(std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				std::allocator<T>().deallocate(buffer, n);
+				throw;
+			}
+
+			try
+			{
+				_relocate(first, count, buffer);
+			}
+			catch (...)
+			{
+				_destroy(buffer + count, buffer + count + 1);
+				std::allocator<T>().deallocate(buffer, n);
+				throw;
+			}
+
+			_deallocate();
+			first = buffer;
+			capacityAvailable = n;
+			return first[count++];
+		}
+
+		//take the elements of v, leaving v empty and inline
+		void _take(small_vector& v)
+		{
+			if (!v.is_inline())
+			{
+				first = v.first;
+				count = v.count;
+				capacityAvailable = v.capacityAvailable;
+				v.first = v._inline_data();
+				v.capacityAvailable = N;
+			}
+			else
+			{
+				_relocate(v._inline_data(), std::min(v.count, N), first);
+				count = v.count;
+			}
+
+			v.count = 0;
+		}
+
+		template<typename Construct>
+		void _resize(size_type n, Construct construct)
+		{
+			if (n < size())
+			{
+				_destroy(first + n, _end());
+				count = n;
+			}
+			else
+			{
+				reserve(n);
+				for (; count < n; ++count)
+					construct(_end());
+			}
+		}
+
+	}; //template small_vector
+
+	template<typename T, std::size_t N>
+	bool operator==(const small_vector<T, N>& a, const small_vector<T, N>& b)
+	{
+		return a.size() == b.size() &&
+			std::equal(a.data(), a.data() + a.size(), b.data());
+	}
+
+	template<typename T, std::size_t N>
+	bool operator!=(const small_vector<T, N>& a, const small_vector<T, N>& b)
+	{
+		return !(a == b);
+	}
+
+}	//namespace sigcpp
+
+#endif
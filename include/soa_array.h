@@ -0,0 +1,442 @@
+/*
+* soa_array.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for fixed-size structure-of-arrays
+* - soa_array<N, Ts...> holds N records of fields Ts..., each field in its
+*   own column array<T_i, N>: a scan of one field reads only that field
+* - column<I>() is the column of field I: pass it to array algorithms
+* - soa[i] is a proxy for record i: soa[i].get<I>() is field I of record i
+* - iterators are random access and yield proxies, as vector<bool> does;
+*   value_type is std::tuple<Ts...>, and proxies convert to and from it
+* - checked iterators (SIGCPP_ITERATOR_DEBUG) trap on out-of-range access and
+*   on comparison of iterators of different containers
+*/
+
+#ifndef SIGCPP_SOA_ARRAY_H
+#define SIGCPP_SOA_ARRAY_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "throw.h"
+#include "array.h"
+
+namespace sigcpp
+{
+	template<std::size_t N, typename... Ts>
+	class soa_array;
+
+	//proxy for one record: Soa is soa_array or const soa_array
+	template<typename Soa>
+	class soa_reference
+	{
+	public:
+		using size_type = std::size_t;
+		using value_type = typename std::remove_const_t<Soa>::value_type;
+
+		constexpr soa_reference(Soa& s, size_type i) noexcept : soa(&s), pos(i) {}
+
+		//field I of the record
+		template<std::size_t I>
+		constexpr decltype(auto) get() const
+		{
+			return soa->template column<I>()[pos];
+		}
+
+		constexpr size_type index() const noexcept { return pos; }
+
+		//copy of the record
+		constexpr operator value_type() const
+		{
+			return _values(std::make_index_sequence<fields>());
+		}
+
+		//assign all fields: from another record or from a tuple
+		constexpr const soa_reference& operator=(const soa_reference& r) const
+		{
+			_assign(r, std::make_index_sequence<fields>());
+			return *this;
+		}
+
+		template<typename S>
+		constexpr const soa_reference& operator=(const soa_reference<S>& r) const
+		{
+			_assign(r, std::make_index_sequence<fields>());
+			return *this;
+		}
+
+		constexpr const soa_reference& operator=(const value_type& v) const
+		{
+			_assign_tuple(v, std::make_index_sequence<fields>());
+			return *this;
+		}
+
+		constexpr const soa_reference& operator=(value_type&& v) const
+		{
+			_assign_tuple(std::move(v), std::make_index_sequence<fields>());
+			return *this;
+		}
+
+		//exchange all fields of two records
+		friend void swap(const soa_reference& a, const soa_reference& b)
+		{
+			a._swap(b, std::make_index_sequence<fields>());
+		}
+
+	private:
+		template<typename S> friend class soa_reference;
+
+		static constexpr std::size_t fields = std::tuple_size_v<value_type>;
+
+		Soa* soa;
+		size_type pos;
+
+		template<std::size_t... I>
+		constexpr value_type _values(std::index_sequence<I...>) const
+		{
+			return value_type(get<I>()...);
+		}
+
+		template<typename R, std::size_t... I>
+		constexpr void _assign(const R& r, std::index_sequence<I...>) const
+		{
+			((get<I>() = r.template get<I>()), ...);
+		}
+
+		template<typename V, std::size_t... I>
+		constexpr void _assign_tuple(V&& v, std::index_sequence<I...>) const
+		{
+			((get<I>() = std::get<I>(std::forward<V>(v))), ...);
+		}
+
+		template<std::size_t... I>
+		void _swap(const soa_reference& r, std::index_sequence<I...>) const
+		{
+			using std::swap;
+			(swap(get<I>(), r.template get<I>()), ...);
+		}
+
+	}; //template soa_reference
+
+
+	//random-access iterator over the records of Soa
+	template<typename Soa>
+	class soa_iterator
+	{
+	public:
+
+		//types
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = typename std::remove_const_t<Soa>::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = soa_reference<Soa>;
+		using pointer = void;
+
+		//ctors
+		constexpr soa_iterator() noexcept = default;
+		constexpr soa_iterator(Soa& s, difference_type i) noexcept : soa(&s), pos(i) {}
+
+		//conversion from iterator to const_iterator
+		template<typename S,
+			typename = std::enable_if_t<std::is_same_v<const S, Soa>>>
+		constexpr soa_iterator(const soa_iterator<S>& it) noexcept
+			: soa(it.soa), pos(it.pos) {}
+
+		constexpr difference_type index() const noexcept { return pos; }
+
+		//dereference and element access
+		constexpr reference operator*() const
+		{
+			_check_deref(0);
+			return reference(*soa, static_cast<std::size_t>(pos));
+		}
+
+		constexpr reference operator[](difference_type n) const
+		{
+			_check_deref(n);
+			return reference(*soa, static_cast<std::size_t>(pos + n));
+		}
+
+		//increment and decrement
+		constexpr soa_iterator& operator++()
+		{
+			_check_move(1);
+			++pos;
+			return *this;
+		}
+
+		constexpr soa_iterator operator++(int)
+		{
+			soa_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		constexpr soa_iterator& operator--()
+		{
+			_check_move(-1);
+			--pos;
+			return *this;
+		}
+
+		constexpr soa_iterator operator--(int)
+		{
+			soa_iterator beforeDecrement = *this;
+			--*this;
+			return beforeDecrement;
+		}
+
+		//arithmetic
+		constexpr soa_iterator operator+(difference_type n) const
+		{
+			soa_iterator t = *this;
+			t += n;
+			return t;
+		}
+
+		constexpr soa_iterator operator-(difference_type n) const
+		{
+			soa_iterator t = *this;
+			t -= n;
+			return t;
+		}
+
+		constexpr soa_iterator& operator+=(difference_type n)
+		{
+			_check_move(n);
+			pos += n;
+			return *this;
+		}
+
+		constexpr soa_iterator& operator-=(difference_type n)
+		{
+			_check_move(-n);
+			pos -= n;
+			return *this;
+		}
+
+		constexpr difference_type operator-(const soa_iterator& r) const
+		{
+			_check_same(r);
+			return pos - r.pos;
+		}
+
+		friend constexpr soa_iterator operator+(difference_type n,
+			const soa_iterator& it)
+		{
+			return it + n;
+		}
+
+		//comparison
+		constexpr bool operator==(const soa_iterator& r) const
+		{
+			_check_same(r);
+			return pos == r.pos;
+		}
+
+		constexpr bool operator!=(const soa_iterator& r) const
+		{
+			_check_same(r);
+			return pos != r.pos;
+		}
+
+		constexpr bool operator<(const soa_iterator& r) const
+		{
+			_check_same(r);
+			return pos < r.pos;
+		}
+
+		constexpr bool operator>(const soa_iterator& r) const
+		{
+			_check_same(r);
+			return pos > r.pos;
+		}
+
+		constexpr bool operator<=(const soa_iterator& r) const
+		{
+			return !(r < *this);
+		}
+
+		constexpr bool operator>=(const soa_iterator& r) const
+		{
+			return !(*this < r);
+		}
+
+	private:
+		template<typename S> friend class soa_iterator;
+
+		static constexpr difference_type size =
+			static_cast<difference_type>(std::remove_const_t<Soa>::size());
+
+		Soa* soa{ nullptr };
+		difference_type pos{ 0 };
+
+		//checks: no-ops if iterators are unchecked
+
+		constexpr void _check_deref([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (soa != nullptr && !(0 <= pos + n && pos + n < size))
+				_iterator_failure("soa_iterator: dereference out of range");
+#endif
+		}
+
+		constexpr void _check_move([[maybe_unused]] difference_type n) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (soa != nullptr && !(0 <= pos + n && pos + n <= size))
+				_iterator_failure("soa_iterator: arithmetic out of range");
+#endif
+		}
+
+		constexpr void _check_same([[maybe_unused]] const soa_iterator& r) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (soa != r.soa)
+				_iterator_failure("soa_iterator: iterators of different ranges");
+#endif
+		}
+
+	}; //template soa_iterator
+
+
+	template<std::size_t N, typename... Ts>
+	class soa_array
+	{
+		static_assert(sizeof...(Ts) != 0, "soa_array requires at least one field");
+
+	public:
+		//types
+		using value_type = std::tuple<Ts...>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using reference = soa_reference<soa_array>;
+		using const_reference = soa_reference<const soa_array>;
+		using iterator = soa_iterator<soa_array>;
+		using const_iterator = soa_iterator<const soa_array>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//type of field I
+		template<std::size_t I>
+		using field_type = std::tuple_element_t<I, value_type>;
+
+		//column of field I
+		template<std::size_t I>
+		constexpr array<field_type<I>, N>& column() noexcept
+		{
+			return std::get<I>(columns);
+		}
+
+		template<std::size_t I>
+		constexpr const array<field_type<I>, N>& column() const noexcept
+		{
+			return std::get<I>(columns);
+		}
+
+		//iterators
+		constexpr iterator begin() noexcept { return iterator(*this, 0); }
+		constexpr const_iterator begin() const noexcept { return cbegin(); }
+		constexpr iterator end() noexcept { return iterator(*this, N); }
+		constexpr const_iterator end() const noexcept { return cend(); }
+
+		constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+		constexpr const_reverse_iterator rbegin() const noexcept
+		{
+			return crbegin();
+		}
+
+		constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		constexpr const_reverse_iterator rend() const noexcept { return crend(); }
+
+		constexpr const_iterator cbegin() const noexcept { return const_iterator(*this, 0); }
+		constexpr const_iterator cend() const noexcept { return const_iterator(*this, N); }
+
+		constexpr const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(cend());
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(cbegin());
+		}
+
+		//capacity
+		constexpr bool empty() const noexcept { return N == 0; }
+		static constexpr size_type size() noexcept { return N; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type field_count() noexcept { return sizeof...(Ts); }
+
+		//unchecked record access
+		constexpr reference operator[](size_type pos) { return reference(*this, pos); }
+
+		constexpr const_reference operator[](size_type pos) const
+		{
+			return const_reference(*this, pos);
+		}
+
+		//checked record access
+		constexpr reference at(size_type pos)
+		{
+			_check_index(pos);
+			return reference(*this, pos);
+		}
+
+		constexpr const_reference at(size_type pos) const
+		{
+			_check_index(pos);
+			return const_reference(*this, pos);
+		}
+
+		//set every record to the same field values
+		constexpr void fill(const Ts&... values)
+		{
+			_fill(std::index_sequence_for<Ts...>(), values...);
+		}
+
+		constexpr void swap(soa_array& s)
+			noexcept((std::is_nothrow_swappable_v<Ts> && ...))
+		{
+			_swap(s, std::index_sequence_for<Ts...>());
+		}
+
+	private:
+		std::tuple<array<Ts, N>...> columns{};
+
+		static constexpr void _check_index(size_type pos)
+		{
+			if (pos >= N)
+				_throw_out_of_range("soa_array index out of range");
+		}
+
+		template<std::size_t... I>
+		constexpr void _fill(std::index_sequence<I...>, const Ts&... values)
+		{
+			(column<I>().fill(values), ...);
+		}
+
+		template<std::size_t... I>
+		constexpr void _swap(soa_array& s, std::index_sequence<I...>)
+		{
+			(column<I>().swap(s.template column<I>()), ...);
+		}
+
+	}; //template soa_array
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,265 @@
+/*
+* sort.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define sort for arrays
+* - arrays of up to sorting_network_max elements are sorted with a sorting
+*   network generated at compile time: a fixed sequence of compare-exchange
+*   operations with no data-dependent branches
+* - the network is Batcher's merge exchange (Knuth, TAOCP 5.2.2, algorithm
+*   M), which works for any N: e.g., 63 comparators for N = 16 (optimal: 60)
+* - compare-exchange is min/max for arithmetic types with std::less; selects
+*   for other trivially-copyable types; swap otherwise
+* - larger arrays use introsort: std::sort at run time, a constexpr introsort
+*   during constant evaluation
+* - sort is not stable
+*/
+
+#ifndef SIGCPP_SORT_H
+#define SIGCPP_SORT_H
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "config.h"
+#include "array.h"
+
+namespace sigcpp
+{
+	//largest array sorted with a network
+	inline constexpr std::size_t sorting_network_max = 32;
+
+	//one compare-exchange: afterwards, element i is not greater than element j
+	struct _comparator
+	{
+		unsigned char i, j;
+	};
+
+	//visit the comparators of the merge exchange network for n elements
+	template<typename F>
+	constexpr void _merge_exchange(std::size_t n, F f)
+	{
+		if (n < 2)
+			return;
+
+		std::size_t t = 0;
+		while ((std::size_t(1) << t) < n)
+			++t;
+
+		for (std::size_t p = std::size_t(1) << (t - 1); p > 0; p /= 2)
+		{
+			std::size_t q = std::size_t(1) << (t - 1), r = 0, d = p;
+			for (;;)
+			{
+				for (std::size_t i = 0; i + d < n; ++i)
+					if ((i & p) == r)
+						f(i, i + d);
+
+				if (q == p)
+					break;
+
+				d = q - p;
+				q /= 2;
+				r = p;
+			}
+		}
+	}
+
+	template<std::size_t N>
+	constexpr std::size_t _network_size()
+	{
+		std::size_t count = 0;
+		_merge_exchange(N, [&count](std::size_t, std::size_t) { ++count; });
+		return count;
+	}
+
+	template<std::size_t N>
+	constexpr array<_comparator, _network_size<N>()> _make_network()
+	{
+		array<_comparator, _network_size<N>()> network{};
+		std::size_t k = 0;
+		_merge_exchange(N, [&](std::size_t i, std::size_t j) {
+			network[k].i = static_cast<unsigned char>(i);
+			network[k].j = static_cast<unsigned char>(j);
+			++k;
+		});
+		return network;
+	}
+
+	//comparators of the network for N elements
+	template<std::size_t N>
+	inline constexpr auto sorting_network = _make_network<N>();
+
+	template<typename T, typename Compare>
+	inline constexpr bool _is_min_max = std::is_arithmetic_v<T> &&
+		(std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+
+	template<typename T, typename Compare>
+	constexpr void _compare_exchange(T& x, T& y, Compare& comp)
+	{
+		if constexpr (_is_min_max<T, Compare>)
+		{
+			//by value: compilers emit minss/maxss-style selects for
+			//floating-point values, and cmov for integers
+			//-both results select on the same comparison, so elements that
+			//compare equal (0.0 and -0.0) are kept, not duplicated
+			const T a = x, b = y;
+			x = b < a ? b : a;
+			y = b < a ? a : b;
+		}
+		else if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			const T a = x, b = y;
+			const bool swap = comp(b, a);
+			x = swap ? b : a;
+			y = swap ? a : b;
+		}
+		else if (comp(y, x))
+		{
+			using std::swap;
+			swap(x, y);
+		}
+	}
+
+	template<std::size_t N, typename T, typename Compare, std::size_t... K>
+	constexpr void _sort_network(T* v, Compare& comp, std::index_sequence<K...>)
+	{
+		constexpr auto& network = sorting_network<N>;
+		(_compare_exchange(v[network[K].i], v[network[K].j], comp), ...);
+	}
+
+	//std::swap is not constexpr in C++17
+	template<typename T>
+	constexpr void _exchange(T& x, T& y)
+	{
+		T t = std::move(x);
+		x = std::move(y);
+		y = std::move(t);
+	}
+
+	//constexpr introsort: quicksort on median of three, heapsort past the
+	//depth limit, insertion sort for short ranges
+	template<typename T, typename Compare>
+	constexpr void _insertion_sort(T* first, T* last, Compare& comp)
+	{
+		for (T* i = first + 1; i < last; ++i)
+		{
+			T v = std::move(*i);
+			T* j = i;
+			for (; j != first && comp(v, *(j - 1)); --j)
+				*j = std::move(*(j - 1));
+			*j = std::move(v);
+		}
+	}
+
+	template<typename T, typename Compare>
+	constexpr void _sift_down(T* heap, std::size_t root, std::size_t n, Compare& comp)
+	{
+		for (std::size_t child; (child = 2 * root + 1) < n; root = child)
+		{
+			if (child + 1 < n && comp(heap[child], heap[child + 1]))
+				++child;
+
+			if (!comp(heap[root], heap[child]))
+				return;
+
+			_exchange(heap[root], heap[child]);
+		}
+	}
+
+	template<typename T, typename Compare>
+	constexpr void _heap_sort(T* first, T* last, Compare& comp)
+	{
+		const std::size_t n = static_cast<std::size_t>(last - first);
+		for (std::size_t i = n / 2; i-- > 0;)
+			_sift_down(first, i, n, comp);
+
+		for (std::size_t i = n; i-- > 1;)
+		{
+			_exchange(first[0], first[i]);
+			_sift_down(first, 0, i, comp);
+		}
+	}
+
+	template<typename T, typename Compare>
+	constexpr void _introsort(T* first, T* last, std::size_t depth, Compare& comp)
+	{
+		while (last - first > 16)
+		{
+			if (depth-- == 0)
+			{
+				_heap_sort(first, last, comp);
+				return;
+			}
+
+			//median of three to the front, then Hoare partition around it
+			T* mid = first + (last - first) / 2;
+			if (comp(*mid, *first))
+				_exchange(*mid, *first);
+			if (comp(*(last - 1), *mid))
+			{
+				_exchange(*(last - 1), *mid);
+				if (comp(*mid, *first))
+					_exchange(*mid, *first);
+			}
+			_exchange(*first, *mid);
+
+			T* i = first;
+			T* j = last;
+			for (;;)
+			{
+				while (comp(*++i, *first)) {}
+				while (comp(*first, *--j)) {}
+				if (i >= j)
+					break;
+				_exchange(*i, *j);
+			}
+			_exchange(*first, *j);
+
+			//recurse on the shorter side to bound the stack
+			if (j - first < last - (j + 1))
+			{
+				_introsort(first, j, depth, comp);
+				first = j + 1;
+			}
+			else
+			{
+				_introsort(j + 1, last, depth, comp);
+				last = j;
+			}
+		}
+
+		_insertion_sort(first, last, comp);
+	}
+
+	template<typename T, std::size_t N, typename Compare = std::less<>>
+	constexpr void sort(array<T, N>& a, Compare comp = Compare())
+	{
+		if constexpr (N < 2)
+			return;
+		else if constexpr (N <= sorting_network_max)
+			_sort_network<N>(a.data(), comp,
+				std::make_index_sequence<sorting_network<N>.size()>());
+		else if (!SIGCPP_IS_CONSTANT_EVALUATED())
+			std::sort(a.begin(), a.end(), comp);
+		else
+		{
+			std::size_t depth = 0;
+			for (std::size_t n = N; n > 1; n /= 2)
+				depth += 2;
+			_introsort(a.data(), a.data() + N, depth, comp);
+		}
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,316 @@
+/*
+* span.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for views of contiguous elements
+* - modeled on C++20 span: https://timsong-cpp.github.io/cppwp/n4861/views.span
+* - span<T, N> has a static extent: it is one pointer, and algorithms on it
+*   are specialized on N as they are for array<T, N>
+* - span<T> has a dynamic extent: one function taking span<const float> takes
+*   arrays of any size, where a template on N would be instantiated per size
+* - iterators are array_iterator<T*>, checked with SIGCPP_ITERATOR_DEBUG
+* - first, last, and subspan with template arguments keep a static extent;
+*   with function arguments the extent is dynamic, and arguments out of range
+*   throw std::out_of_range
+*/
+
+#ifndef SIGCPP_SPAN_H
+#define SIGCPP_SPAN_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "config.h"
+#include "throw.h"
+#include "array.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	inline constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+	template<typename T, std::size_t Extent = dynamic_extent>
+	class span;
+
+	//pointer and size of a span: no size is stored for a static extent
+	template<typename T, std::size_t Extent>
+	struct _span_storage
+	{
+		constexpr _span_storage(T* p, std::size_t) noexcept : ptr(p) {}
+		static constexpr std::size_t size() noexcept { return Extent; }
+
+		T* ptr;
+	};
+
+	template<typename T>
+	struct _span_storage<T, dynamic_extent>
+	{
+		constexpr _span_storage(T* p, std::size_t n) noexcept : ptr(p), count(n) {}
+		constexpr std::size_t size() const noexcept { return count; }
+
+		T* ptr;
+		std::size_t count;
+	};
+
+	template<typename T>
+	inline constexpr bool _is_span = false;
+
+	template<typename T, std::size_t E>
+	inline constexpr bool _is_span<span<T, E>> = true;
+
+	template<typename T>
+	inline constexpr bool _is_array = std::is_array_v<T>;
+
+	template<typename T, std::size_t N>
+	inline constexpr bool _is_array<array<T, N>> = true;
+
+	//U elements may be viewed as T elements: only qualifications added
+	template<typename U, typename T>
+	inline constexpr bool _is_span_convertible = std::is_convertible_v<U(*)[], T(*)[]>;
+
+	//containers with data() and size() other than spans and arrays
+	template<typename C, typename T, typename = void>
+	inline constexpr bool _is_span_container = false;
+
+	template<typename C, typename T>
+	inline constexpr bool _is_span_container<C, T, std::void_t<
+		decltype(std::declval<C&>().data()), decltype(std::declval<C&>().size())>> =
+		!_is_span<std::remove_cv_t<C>> && !_is_array<std::remove_cv_t<C>> &&
+		_is_span_convertible<std::remove_pointer_t<decltype(std::declval<C&>().data())>, T>;
+
+	template<typename T, std::size_t Extent>
+	class span
+	{
+		//a source of N elements fits this extent
+		template<std::size_t N>
+		static constexpr bool _fits = Extent == dynamic_extent || N == Extent;
+
+	public:
+		//types
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+		using iterator = array_iterator<pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+
+		static constexpr size_type extent = Extent;
+
+		//ctors
+		//-of a static extent, explicit unless the extent is known to agree
+		template<std::size_t E = Extent,
+			typename = std::enable_if_t<E == 0 || E == dynamic_extent>>
+		constexpr span() noexcept : storage(nullptr, 0) {}
+
+		constexpr span(pointer p, size_type n) : storage(p, n) { _check_extent(n); }
+
+		constexpr span(pointer first, pointer last)
+			: span(first, static_cast<size_type>(last - first)) {}
+
+		template<std::size_t N, typename = std::enable_if_t<_fits<N>>>
+		constexpr span(element_type (&a)[N]) noexcept : storage(a, N) {}
+
+		template<typename U, std::size_t N,
+			typename = std::enable_if_t<_fits<N> && _is_span_convertible<U, T>>>
+		constexpr span(array<U, N>& a) noexcept : storage(a.data(), N) {}
+
+		template<typename U, std::size_t N,
+			typename = std::enable_if_t<_fits<N> && _is_span_convertible<const U, T>>>
+		constexpr span(const array<U, N>& a) noexcept : storage(a.data(), N) {}
+
+		//static_vector, std::vector, std::string, ...
+		template<typename C, std::size_t E = Extent,
+			typename = std::enable_if_t<_is_span_container<C, T> && E == dynamic_extent>>
+		constexpr span(C& c) : storage(c.data(), c.size()) {}
+
+		template<typename C, std::size_t E = Extent,
+			typename = std::enable_if_t<_is_span_container<C, T> && E != dynamic_extent>,
+			typename = void>
+		constexpr explicit span(C& c) : storage(c.data(), c.size())
+		{
+			_check_extent(c.size());
+		}
+
+		//conversion to fewer qualifications or to a dynamic extent
+		template<typename U, std::size_t N,
+			typename = std::enable_if_t<_fits<N> && _is_span_convertible<U, T>>>
+		constexpr span(const span<U, N>& s) noexcept : storage(s.data(), s.size()) {}
+
+		template<typename U, std::size_t E = Extent,
+			typename = std::enable_if_t<E != dynamic_extent && _is_span_convertible<U, T>>,
+			typename = void>
+		constexpr explicit span(const span<U, dynamic_extent>& s)
+			: storage(s.data(), s.size())
+		{
+			_check_extent(s.size());
+		}
+
+		constexpr span(const span&) noexcept = default;
+		constexpr span& operator=(const span&) noexcept = default;
+
+		//iterators
+		constexpr iterator begin() const noexcept
+		{
+			return iterator(storage.ptr, storage.ptr, storage.ptr + size());
+		}
+
+		constexpr iterator end() const noexcept
+		{
+			return iterator(storage.ptr + size(), storage.ptr, storage.ptr + size());
+		}
+
+		constexpr reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+		constexpr reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+		//observers
+		constexpr size_type size() const noexcept { return storage.size(); }
+		constexpr size_type size_bytes() const noexcept { return size() * sizeof(T); }
+		constexpr bool empty() const noexcept { return size() == 0; }
+
+		//unchecked element access
+		constexpr reference operator[](size_type pos) const { return storage.ptr[pos]; }
+		constexpr reference front() const { return storage.ptr[0]; }
+		constexpr reference back() const { return storage.ptr[size() - 1]; }
+		constexpr pointer data() const noexcept { return storage.ptr; }
+
+		//checked element access
+		constexpr reference at(size_type pos) const
+		{
+			if (pos >= size())
+				_throw_out_of_range("span index out of range");
+			return storage.ptr[pos];
+		}
+
+		//subviews with a static extent
+		template<std::size_t Count>
+		constexpr span<T, Count> first() const
+		{
+			static_assert(Extent == dynamic_extent || Count <= Extent,
+				"first: count exceeds extent");
+			_check_count(Count);
+			return span<T, Count>(storage.ptr, Count);
+		}
+
+		template<std::size_t Count>
+		constexpr span<T, Count> last() const
+		{
+			static_assert(Extent == dynamic_extent || Count <= Extent,
+				"last: count exceeds extent");
+			_check_count(Count);
+			return span<T, Count>(storage.ptr + (size() - Count), Count);
+		}
+
+		template<std::size_t Offset, std::size_t Count = dynamic_extent>
+		constexpr auto subspan() const
+		{
+			static_assert(Extent == dynamic_extent || (Offset <= Extent &&
+				(Count == dynamic_extent || Count <= Extent - Offset)),
+				"subspan: offset or count exceeds extent");
+
+			constexpr std::size_t E = Count != dynamic_extent ? Count :
+				(Extent != dynamic_extent ? Extent - Offset : dynamic_extent);
+
+			_check_subspan(Offset, Count);
+			const size_type n = Count != dynamic_extent ? Count : size() - Offset;
+			return span<T, E>(storage.ptr + Offset, n);
+		}
+
+		//subviews with a dynamic extent
+		constexpr span<T> first(size_type count) const
+		{
+			_check_count(count);
+			return span<T>(storage.ptr, count);
+		}
+
+		constexpr span<T> last(size_type count) const
+		{
+			_check_count(count);
+			return span<T>(storage.ptr + (size() - count), count);
+		}
+
+		constexpr span<T> subspan(size_type offset, size_type count = dynamic_extent) const
+		{
+			_check_subspan(offset, count);
+			const size_type n = count != dynamic_extent ? count : size() - offset;
+			return span<T>(storage.ptr + offset, n);
+		}
+
+	private:
+		template<typename U, std::size_t E> friend class span;
+
+		_span_storage<T, Extent> storage;
+
+		//a static extent must match the number of elements given
+		static constexpr void _check_extent([[maybe_unused]] size_type n)
+		{
+			if constexpr (Extent != dynamic_extent)
+				if (n != Extent)
+					_throw_out_of_range("span size does not match extent");
+		}
+
+		constexpr void _check_count(size_type n) const
+		{
+			if (n > size())
+				_throw_out_of_range("span subview out of range");
+		}
+
+		//compare count with the elements left: offset + count may wrap
+		constexpr void _check_subspan(size_type offset, size_type count) const
+		{
+			_check_count(offset);
+			if (count != dynamic_extent && count > size() - offset)
+				_throw_out_of_range("span subview out of range");
+		}
+
+	}; //template span
+
+	//deduction guides
+	template<typename T, std::size_t N>
+	span(T (&)[N]) -> span<T, N>;
+
+	template<typename T, std::size_t N>
+	span(array<T, N>&) -> span<T, N>;
+
+	template<typename T, std::size_t N>
+	span(const array<T, N>&) -> span<const T, N>;
+
+	template<typename T>
+	span(T*, std::size_t) -> span<T>;
+
+	template<typename C>
+	span(C&) -> span<std::remove_pointer_t<decltype(std::declval<C&>().data())>>;
+
+	//view the bytes of a span
+	template<typename T, std::size_t N>
+	span<const std::byte, N == dynamic_extent ? dynamic_extent : N * sizeof(T)>
+		as_bytes(span<T, N> s) noexcept
+	{
+		using result = span<const std::byte,
+			N == dynamic_extent ? dynamic_extent : N * sizeof(T)>;
+		return result(reinterpret_cast<const std::byte*>(s.data()), s.size_bytes());
+	}
+
+	template<typename T, std::size_t N, typename = std::enable_if_t<!std::is_const_v<T>>>
+	span<std::byte, N == dynamic_extent ? dynamic_extent : N * sizeof(T)>
+		as_writable_bytes(span<T, N> s) noexcept
+	{
+		using result = span<std::byte,
+			N == dynamic_extent ? dynamic_extent : N * sizeof(T)>;
+		return result(reinterpret_cast<std::byte*>(s.data()), s.size_bytes());
+	}
+
+}	//namespace sigcpp
+
+#endif
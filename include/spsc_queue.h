@@ -0,0 +1,174 @@
+/*
+* spsc_queue.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for bounded lock-free single-producer,
+* single-consumer queues
+* - one thread may push and one other thread may pop concurrently
+* - slots are an aligned_array<T, N>: no heap allocation, ever
+* - N must be a power of two: positions are free-running counters, masked
+* - the producer's and consumer's indices are on separate cache lines, each
+*   with a cached copy of the other side's index: the other side's line is
+*   read only when the queue looks full (producer) or empty (consumer)
+* - a pushed element is published with a release store that the consumer
+*   reads with acquire, and vice versa for freed slots
+* - try_push_n and try_pop_n move many elements per atomic store
+*/
+
+#ifndef SIGCPP_SPSC_QUEUE_H
+#define SIGCPP_SPSC_QUEUE_H
+
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "aligned_array.h"
+
+namespace sigcpp
+{
+	template<typename T, std::size_t N>
+	class spsc_queue
+	{
+		static_assert(N != 0 && (N & (N - 1)) == 0,
+			"spsc_queue capacity must be a power of two");
+
+	public:
+		//types
+		using value_type = T;
+		using size_type = std::size_t;
+
+		spsc_queue() = default;
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		//capacity
+		static constexpr size_type capacity() noexcept { return N; }
+
+		//number of elements: exact only if neither side is active
+		size_type size_approx() const noexcept
+		{
+			//read head first: tail cannot then be behind it
+			const size_type h = consumer.head.load(std::memory_order_acquire);
+			return producer.tail.load(std::memory_order_acquire) - h;
+		}
+
+		bool empty_approx() const noexcept { return size_approx() == 0; }
+
+		//producer: false if full
+		bool try_push(const T& v) { return _try_push(v); }
+		bool try_push(T&& v) { return _try_push(std::move(v)); }
+
+		//producer: copy up to n elements from src; number copied
+		size_type try_push_n(const T* src, size_type n)
+		{
+			const size_type t = producer.tail.load(std::memory_order_relaxed);
+			if (N - (t - producer.cachedHead) < n)
+				producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+
+			n = std::min(n, N - (t - producer.cachedHead));
+			_spans(t, n, [&src](T* slot, size_type count) {
+				std::copy_n(src, count, slot);
+				src += count;
+			});
+
+			producer.tail.store(t + n, std::memory_order_release);
+			return n;
+		}
+
+		//consumer: move the front element to v; false if empty
+		bool try_pop(T& v)
+		{
+			const size_type h = consumer.head.load(std::memory_order_relaxed);
+			if (h == consumer.cachedTail)
+			{
+				consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+				if (h == consumer.cachedTail)
+					return false;
+			}
+
+			v = std::move(slots[h & mask]);
+			consumer.head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+		//consumer: move up to n elements to dst; number moved
+		size_type try_pop_n(T* dst, size_type n)
+		{
+			const size_type h = consumer.head.load(std::memory_order_relaxed);
+			if (consumer.cachedTail - h < n)
+				consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+
+			n = std::min(n, consumer.cachedTail - h);
+			_spans(h, n, [&dst](T* slot, size_type count) {
+				dst = std::move(slot, slot + count, dst);
+			});
+
+			consumer.head.store(h + n, std::memory_order_release);
+			return n;
+		}
+
+	private:
+		static constexpr size_type mask = N - 1;
+
+		//written by the producer
+		struct alignas(cache_line_size) producer_state
+		{
+			std::atomic<size_type> tail{ 0 };
+			size_type cachedHead{ 0 };
+		};
+
+		//written by the consumer
+		struct alignas(cache_line_size) consumer_state
+		{
+			std::atomic<size_type> head{ 0 };
+			size_type cachedTail{ 0 };
+		};
+
+		producer_state producer;
+		consumer_state consumer;
+		aligned_array<T, N, cache_line_size> slots{};
+
+		template<typename U>
+		bool _try_push(U&& v)
+		{
+			const size_type t = producer.tail.load(std::memory_order_relaxed);
+			if (t - producer.cachedHead == N)
+			{
+				producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+				if (t - producer.cachedHead == N)
+					return false;
+			}
+
+			slots[t & mask] = std::forward<U>(v);
+			producer.tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		//call f(slot, count) for the one or two contiguous spans of n slots
+		//starting at position pos
+		template<typename F>
+		void _spans(size_type pos, size_type n, F f)
+		{
+			const size_type first = pos & mask;
+			const size_type firstCount = std::min(n, N - first);
+
+			if (firstCount != 0)
+				f(slots.data() + first, firstCount);
+
+			if (n != firstCount)
+				f(slots.data(), n - firstCount);
+		}
+
+	}; //template spsc_queue
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,676 @@
+/*
+* static_flat_map.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for hash maps of fixed capacity
+* - open addressing in the style of SwissTable (Abseil): one control byte per
+*   slot holds 7 bits of the hash, or marks the slot empty or deleted
+* - slots are probed in groups of 16: one SSE2 compare matches a hash
+*   fragment against a whole group; other targets match bytes in a loop
+* - slots and control bytes live in the object itself: no heap allocation
+* - static_flat_map<K, V, N> holds up to N entries in slot_count() slots, a
+*   power of two at least 8/7 of N; inserting past N throws
+*   std::length_error
+* - erase leaves a tombstone only if the slot's group has no empty slot;
+*   tombstones are dropped in place when they crowd out empty slots
+* - iterators are forward iterators over the occupied slots; insert and
+*   erase invalidate them, as do rehashes in unordered_map
+* - checked iterators (SIGCPP_ITERATOR_DEBUG) trap on dereference of end and
+*   on comparison of iterators of different maps
+*/
+
+#ifndef SIGCPP_STATIC_FLAT_MAP_H
+#define SIGCPP_STATIC_FLAT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <tuple>
+#include <initializer_list>
+
+#include "config.h"
+#include "throw.h"
+#include "bit.h"
+#include "simd.h"
+#include "hash.h"
+#include "array.h"
+#include "array_iterator.h"
+#include "static_vector.h"
+
+namespace sigcpp
+{
+	//control bytes: a full slot holds the low 7 bits of its hash
+	inline constexpr std::int8_t _ctrl_empty = -128;
+	inline constexpr std::int8_t _ctrl_deleted = -2;
+
+	//slots probed together
+	inline constexpr std::size_t _group_width = 16;
+
+	//group masks: bit i for control byte i of the group at g
+#if defined(SIGCPP_SIMD_SSE2) || defined(SIGCPP_SIMD_AVX2)
+
+	//slots whose control byte is b
+	inline unsigned _group_match(const std::int8_t* g, std::int8_t b) noexcept
+	{
+		const __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(g));
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(b))));
+	}
+
+	//slots not full: empty and deleted control bytes are negative
+	inline unsigned _group_match_free(const std::int8_t* g) noexcept
+	{
+		const __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(g));
+		return static_cast<unsigned>(_mm_movemask_epi8(ctrl));
+	}
+
+#else
+
+	inline unsigned _group_match(const std::int8_t* g, std::int8_t b) noexcept
+	{
+		unsigned mask = 0;
+		for (std::size_t i = 0; i < _group_width; ++i)
+			mask |= unsigned(g[i] == b) << i;
+		return mask;
+	}
+
+	inline unsigned _group_match_free(const std::int8_t* g) noexcept
+	{
+		unsigned mask = 0;
+		for (std::size_t i = 0; i < _group_width; ++i)
+			mask |= unsigned(g[i] < 0) << i;
+		return mask;
+	}
+
+#endif
+
+	inline unsigned _group_match_full(const std::int8_t* g) noexcept
+	{
+		return ~_group_match_free(g) & 0xFFFFu;
+	}
+
+	//forward iterator over the occupied slots of Map: Map may be const
+	template<typename Map>
+	class static_flat_map_iterator
+	{
+		using map_type = std::remove_const_t<Map>;
+
+	public:
+
+		//types
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename map_type::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<std::is_const_v<Map>,
+			const value_type*, value_type*>;
+		using reference = std::conditional_t<std::is_const_v<Map>,
+			const value_type&, value_type&>;
+		using size_type = std::size_t;
+
+		//ctors
+		static_flat_map_iterator() noexcept = default;
+		static_flat_map_iterator(Map& m, size_type slot) noexcept : map(&m), pos(slot) {}
+
+		//conversion from iterator to const_iterator
+		template<typename M,
+			typename = std::enable_if_t<std::is_same_v<const M, Map>>>
+		static_flat_map_iterator(const static_flat_map_iterator<M>& it) noexcept
+			: map(it.map), pos(it.pos) {}
+
+		//slot index of the entry
+		size_type index() const noexcept { return pos; }
+
+		//dereference
+		reference operator*() const
+		{
+			_check_deref();
+			return map->_slot(pos);
+		}
+
+		pointer operator->() const
+		{
+			_check_deref();
+			return &map->_slot(pos);
+		}
+
+		//increment
+		static_flat_map_iterator& operator++()
+		{
+			_check_deref();
+			pos = map->_next_full(pos + 1);
+			return *this;
+		}
+
+		static_flat_map_iterator operator++(int)
+		{
+			static_flat_map_iterator beforeIncrement = *this;
+			++*this;
+			return beforeIncrement;
+		}
+
+		//comparison
+		bool operator==(const static_flat_map_iterator& r) const
+		{
+			_check_same(r);
+			return pos == r.pos;
+		}
+
+		bool operator!=(const static_flat_map_iterator& r) const
+		{
+			_check_same(r);
+			return pos != r.pos;
+		}
+
+	private:
+		template<typename M> friend class static_flat_map_iterator;
+
+		Map* map{ nullptr };
+		size_type pos{ 0 };
+
+		//checks: no-ops if iterators are unchecked
+
+		void _check_deref() const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (map == nullptr || pos >= map_type::slot_count())
+				_iterator_failure("static_flat_map_iterator: dereference out of range");
+#endif
+		}
+
+		void _check_same([[maybe_unused]] const static_flat_map_iterator& r) const
+		{
+#if SIGCPP_ITERATOR_DEBUG
+			if (map != r.map)
+				_iterator_failure("static_flat_map_iterator: iterators of different maps");
+#endif
+		}
+
+	}; //template static_flat_map_iterator
+
+
+	template<typename K, typename V, std::size_t N,
+		typename Hash = hash<K>, typename KeyEqual = std::equal_to<K>>
+	class static_flat_map
+	{
+		static_assert(N != 0, "static_flat_map requires a capacity");
+
+		//slots: a power of two with at most 7/8 of them full, at least a group
+		static constexpr std::size_t _slots()
+		{
+			std::size_t s = _group_width;
+			while (s - s / 8 < N)
+				s *= 2;
+			return s;
+		}
+
+	public:
+		//types
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<const K, V>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+
+		using iterator = static_flat_map_iterator<static_flat_map>;
+		using const_iterator = static_flat_map_iterator<const static_flat_map>;
+
+		//ctors
+		static_flat_map() noexcept { control.fill(_ctrl_empty); }
+
+		static_flat_map(std::initializer_list<value_type> list) : static_flat_map()
+		{
+			insert(list);
+		}
+
+		static_flat_map(const static_flat_map& m) : static_flat_map() { _copy(m); }
+
+		static_flat_map(static_flat_map&& m)
+			noexcept(std::is_nothrow_move_constructible_v<value_type>)
+			: static_flat_map()
+		{
+			_move(m);
+		}
+
+		~static_flat_map() { _destroy_all(); }
+
+		static_flat_map& operator=(const static_flat_map& m)
+		{
+			if (this != &m)
+			{
+				clear();
+				_copy(m);
+			}
+			return *this;
+		}
+
+		static_flat_map& operator=(static_flat_map&& m)
+			noexcept(std::is_nothrow_move_constructible_v<value_type>)
+		{
+			if (this != &m)
+			{
+				clear();
+				_move(m);
+			}
+			return *this;
+		}
+
+		//iterators
+		iterator begin() noexcept { return iterator(*this, _next_full(0)); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(*this, slot_count()); }
+		const_iterator end() const noexcept { return cend(); }
+
+		const_iterator cbegin() const noexcept { return const_iterator(*this, _next_full(0)); }
+		const_iterator cend() const noexcept { return const_iterator(*this, slot_count()); }
+
+		//capacity
+		bool empty() const noexcept { return used == 0; }
+		size_type size() const noexcept { return used; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type capacity() noexcept { return N; }
+		static constexpr size_type slot_count() noexcept { return _slots(); }
+
+		//lookup
+		iterator find(const K& key) { return iterator(*this, _find(key)); }
+
+		const_iterator find(const K& key) const
+		{
+			return const_iterator(*this, _find(key));
+		}
+
+		bool contains(const K& key) const { return _find(key) != slot_count(); }
+		size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+		V& at(const K& key)
+		{
+			const size_type i = _find(key);
+			if (i == slot_count())
+				_throw_out_of_range("static_flat_map key not found");
+			return _slot(i).second;
+		}
+
+		const V& at(const K& key) const
+		{
+			const size_type i = _find(key);
+			if (i == slot_count())
+				_throw_out_of_range("static_flat_map key not found");
+			return _slot(i).second;
+		}
+
+		V& operator[](const K& key) { return try_emplace(key).first->second; }
+		V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+		//modifiers: a new key when the map is full throws std::length_error
+
+		std::pair<iterator, bool> insert(const value_type& v)
+		{
+			return try_emplace(v.first, v.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& v)
+		{
+			return try_emplace(v.first, std::move(v.second));
+		}
+
+		void insert(std::initializer_list<value_type> list)
+		{
+			for (const value_type& v : list)
+				insert(v);
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			value_type v(std::forward<Args>(args)...);
+			return try_emplace(v.first, std::move(v.second));
+		}
+
+		//insert only if key is absent; args are not used otherwise
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+		{
+			return _try_emplace(key, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+		{
+			return _try_emplace(std::move(key), std::forward<Args>(args)...);
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const K& key, M&& m)
+		{
+			std::pair<iterator, bool> r = try_emplace(key, std::forward<M>(m));
+			if (!r.second)
+				r.first->second = std::forward<M>(m);
+			return r;
+		}
+
+		size_type erase(const K& key)
+		{
+			const size_type i = _find(key);
+			if (i == slot_count())
+				return 0;
+
+			_erase(i);
+			return 1;
+		}
+
+		//erase the entry at pos: returns the iterator to the next entry
+		iterator erase(const_iterator pos)
+		{
+			const size_type i = pos.index();
+			_erase(i);
+			return iterator(*this, _next_full(i + 1));
+		}
+
+		iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+		void clear() noexcept
+		{
+			_destroy_all();
+			control.fill(_ctrl_empty);
+			used = 0;
+			tombstones = 0;
+		}
+
+		void swap(static_flat_map& m)
+		{
+			static_flat_map t(std::move(m));
+			m = std::move(*this);
+			*this = std::move(t);
+		}
+
+		//observers
+		hasher hash_function() const { return hasher(); }
+		key_equal key_eq() const { return key_equal(); }
+
+	private:
+		template<typename M> friend class static_flat_map_iterator;
+
+		static constexpr size_type groups = _slots() / _group_width;
+		//full and deleted slots allowed before tombstones are dropped: at least
+		//N + 1/16 of the slots, so drops are amortized over many erases
+		static constexpr size_type maxNonEmpty = _slots() - _slots() / 16;
+
+		//uninitialized storage for a value
+		struct slot
+		{
+			alignas(value_type) unsigned char bytes[sizeof(value_type)];
+		};
+
+		//group loads are aligned
+		alignas(_group_width) array<std::int8_t, _slots()> control;
+		array<slot, _slots()> slots;
+		_size_type_for<N> used{ 0 };
+		_size_type_for<_slots()> tombstones{ 0 };
+
+		value_type& _slot(size_type i) noexcept
+		{
+			return *reinterpret_cast<value_type*>(slots[i].bytes);
+		}
+
+		const value_type& _slot(size_type i) const noexcept
+		{
+			return *reinterpret_cast<const value_type*>(slots[i].bytes);
+		}
+
+		//hashers such as std::hash<int> can be identity: mix so both the
+		//group (high bits) and the control byte (low 7 bits) see all bits
+		static std::uint64_t _hash(const K& key)
+		{
+			return _mix(static_cast<std::uint64_t>(hasher()(key)), 0x9e3779b97f4a7c15ull);
+		}
+
+		static std::int8_t _fragment(std::uint64_t h) noexcept
+		{
+			return static_cast<std::int8_t>(h & 0x7F);
+		}
+
+		//the k-th group probed for h: triangular steps visit every group
+		static size_type _group(std::uint64_t h, size_type k) noexcept
+		{
+			return static_cast<size_type>(((h >> 7) + k * (k + 1) / 2) & (groups - 1));
+		}
+
+		size_type _find(const K& key) const { return _find(key, _hash(key)); }
+
+		template<typename Key, typename... Args>
+		std::pair<iterator, bool> _try_emplace(Key&& key, Args&&... args)
+		{
+			const std::uint64_t h = _hash(key);
+			const size_type found = _find(key, h);
+			if (found != slot_count())
+				return { iterator(*this, found), false };
+
+			const size_type i = _claim(h);
+			::new (&slots[i]) value_type(std::piecewise_construct,
+				std::forward_as_tuple(std::forward<Key>(key)),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+			_set_full(i, h);
+			return { iterator(*this, i), true };
+		}
+
+		//slot holding key; slot_count() if key is absent
+		size_type _find(const K& key, std::uint64_t h) const
+		{
+			const std::int8_t fragment = _fragment(h);
+			for (size_type k = 0; k < groups; ++k)
+			{
+				const size_type g = _group(h, k) * _group_width;
+				for (unsigned m = _group_match(&control[g], fragment); m != 0; m &= m - 1)
+				{
+					const size_type i = g + static_cast<size_type>(countr_zero(m));
+					if (key_equal()(_slot(i).first, key))
+						return i;
+				}
+
+				//a key is never placed past a group with an empty slot
+				if (_group_match(&control[g], _ctrl_empty) != 0)
+					break;
+			}
+			return slot_count();
+		}
+
+		//first empty or deleted slot in the probe sequence of h
+		size_type _find_free(std::uint64_t h) const noexcept
+		{
+			for (size_type k = 0;; ++k)
+			{
+				const size_type g = _group(h, k) * _group_width;
+				const unsigned m = _group_match_free(&control[g]);
+				if (m != 0)
+					return g + static_cast<size_type>(countr_zero(m));
+			}
+		}
+
+		//slot for a new entry of hash h
+		size_type _claim(std::uint64_t h)
+		{
+			if (used == N)
+				_throw_length_error("static_flat_map capacity exceeded");
+
+			size_type i = _find_free(h);
+			if (control[i] == _ctrl_deleted)
+				--tombstones;
+			else if constexpr (groups > 1)
+			{
+				//no empty slot to spare: drop tombstones, then look again
+				//-one group always has an empty slot, so never has tombstones
+				if (used + tombstones >= maxNonEmpty)
+				{
+					_drop_tombstones();
+					i = _find_free(h);
+				}
+			}
+			return i;
+		}
+
+		void _set_full(size_type i, std::uint64_t h) noexcept
+		{
+			control[i] = _fragment(h);
+			++used;
+		}
+
+		void _erase(size_type i)
+		{
+			_slot(i).~value_type();
+
+			//probes stop at a group with an empty slot: only a full group
+			//needs a tombstone to keep later keys reachable
+			const size_type g = i & ~(_group_width - 1);
+			if (_group_match(&control[g], _ctrl_empty) != 0)
+				control[i] = _ctrl_empty;
+			else
+			{
+				control[i] = _ctrl_deleted;
+				++tombstones;
+			}
+			--used;
+		}
+
+		//rehash in place without tombstones (Abseil's drop_deletes_without_resize):
+		//mark each entry deleted, then place each at the first free slot of its
+		//probe sequence, swapping with entries not yet placed
+		void _drop_tombstones()
+		{
+			for (std::int8_t& c : control)
+				c = c < 0 ? _ctrl_empty : _ctrl_deleted;
+
+			for (size_type i = 0; i < slot_count(); ++i)
+			{
+				while (control[i] == _ctrl_deleted)
+				{
+					const std::uint64_t h = _hash(_slot(i).first);
+					const size_type target = _find_free(h);
+
+					//already in the first group with room: stays
+					if (target / _group_width == i / _group_width)
+					{
+						control[i] = _fragment(h);
+						break;
+					}
+
+					if (control[target] == _ctrl_empty)
+					{
+						::new (&slots[target]) value_type(std::move(_slot(i)));
+						_slot(i).~value_type();
+						control[i] = _ctrl_empty;
+						control[target] = _fragment(h);
+						break;
+					}
+
+					//target holds an entry not yet placed: exchange and place it next
+					_swap_slots(i, target);
+					control[target] = _fragment(h);
+				}
+			}
+			tombstones = 0;
+		}
+
+		void _swap_slots(size_type i, size_type j)
+		{
+			value_type t(std::move(_slot(i)));
+			_slot(i).~value_type();
+			::new (&slots[i]) value_type(std::move(_slot(j)));
+			_slot(j).~value_type();
+			::new (&slots[j]) value_type(std::move(t));
+		}
+
+		//first full slot at or after pos; slot_count() if none
+		size_type _next_full(size_type pos) const noexcept
+		{
+			while (pos < slot_count())
+			{
+				const size_type g = pos & ~(_group_width - 1);
+				const unsigned m = _group_match_full(&control[g]) >> (pos - g);
+				if (m != 0)
+					return pos + static_cast<size_type>(countr_zero(m));
+				pos = g + _group_width;
+			}
+			return slot_count();
+		}
+
+		void _destroy_all() noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<value_type>)
+				for (size_type i = _next_full(0); i < slot_count(); i = _next_full(i + 1))
+					_slot(i).~value_type();
+		}
+
+		//the layout of m is kept: same slots, same tombstones
+		void _copy(const static_flat_map& m)
+		{
+			for (size_type i = m._next_full(0); i < slot_count(); i = m._next_full(i + 1))
+			{
+				::new (&slots[i]) value_type(m._slot(i));
+				control[i] = m.control[i];
+				++used;
+			}
+			_copy_tombstones(m);
+		}
+
+		void _move(static_flat_map& m)
+		{
+			for (size_type i = m._next_full(0); i < slot_count(); i = m._next_full(i + 1))
+			{
+				::new (&slots[i]) value_type(std::move(m._slot(i)));
+				control[i] = m.control[i];
+				++used;
+			}
+			_copy_tombstones(m);
+			m.clear();
+		}
+
+		void _copy_tombstones(const static_flat_map& m) noexcept
+		{
+			for (size_type i = 0; i < slot_count(); ++i)
+				if (m.control[i] == _ctrl_deleted)
+					control[i] = _ctrl_deleted;
+			tombstones = m.tombstones;
+		}
+
+	}; //template static_flat_map
+
+	template<typename K, typename V, std::size_t N, typename H, typename E>
+	bool operator==(const static_flat_map<K, V, N, H, E>& a,
+		const static_flat_map<K, V, N, H, E>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+
+		for (const auto& e : a)
+		{
+			auto it = b.find(e.first);
+			if (it == b.end() || !(it->second == e.second))
+				return false;
+		}
+		return true;
+	}
+
+	template<typename K, typename V, std::size_t N, typename H, typename E>
+	bool operator!=(const static_flat_map<K, V, N, H, E>& a,
+		const static_flat_map<K, V, N, H, E>& b)
+	{
+		return !(a == b);
+	}
+
+}	//namespace sigcpp
+
+#endif
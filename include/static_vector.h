@@ -0,0 +1,455 @@
+/*
+* static_vector.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a class template for vectors of fixed capacity
+* - modeled on C++26 inplace_vector: https://wg21.link/p0843
+* - elements live in the object itself: no heap allocation, ever
+* - exceeding capacity throws std::length_error, except in try_ functions
+* - trivially-copyable elements are copied and shifted with memcpy/memmove;
+*   trivially-destructible elements are not destroyed one at a time
+* - checked iterators (SIGCPP_ITERATOR_DEBUG) are bounded by the size at
+*   the time the iterator is obtained
+*/
+
+#ifndef SIGCPP_STATIC_VECTOR_H
+#define SIGCPP_STATIC_VECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <climits>
+#include <new>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+#include "config.h"
+#include "throw.h"
+#include "array_iterator.h"
+
+namespace sigcpp
+{
+	//smallest unsigned type that can count to N
+	template<std::size_t N>
+	using _size_type_for = std::conditional_t<N <= UCHAR_MAX, unsigned char,
+		std::conditional_t<N <= USHRT_MAX, unsigned short,
+		std::conditional_t<N <= UINT_MAX, unsigned, std::size_t>>>;
+
+	template<typename T, std::size_t N>
+	class static_vector
+	{
+	public:
+		//types
+		using value_type = T;
+		using pointer = value_type*;
+		using const_pointer = const value_type*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using iterator = array_iterator<pointer>;
+		using const_iterator = array_iterator<const_pointer>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		//ctors
+		static_vector() noexcept {}
+
+		explicit static_vector(size_type n)
+		{
+			_check_capacity(n);
+			std::uninitialized_value_construct_n(data(), n);
+			count = static_cast<_size_type_for<N>>(n);
+		}
+
+		static_vector(size_type n, const T& v)
+		{
+			_check_capacity(n);
+			std::uninitialized_fill_n(data(), n, v);
+			count = static_cast<_size_type_for<N>>(n);
+		}
+
+		//delegates so that the destructor destroys elements already built if
+		//an element's construction or the capacity check throws
+		//-forward ranges are checked against capacity before any element is built
+		template<typename InputIt,
+			typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+		static_vector(InputIt first, InputIt last) : static_vector()
+		{
+			using category = typename std::iterator_traits<InputIt>::iterator_category;
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+			{
+				const auto n = std::distance(first, last);
+				_check_capacity(static_cast<size_type>(n < 0 ? 0 : n));
+				for (; first != last; ++first)
+					_unchecked_emplace_back(*first);
+			}
+			else
+			{
+				for (; first != last; ++first)
+					emplace_back(*first);
+			}
+		}
+
+		static_vector(std::initializer_list<T> list)
+			: static_vector(list.begin(), list.end()) {}
+
+		static_vector(const static_vector& v)
+		{
+			_copy_construct(v.data(), v.size());
+		}
+
+		static_vector(static_vector&& v)
+			noexcept(std::is_nothrow_move_constructible_v<T>)
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+				_copy_construct(v.data(), v.size());
+			else
+			{
+				std::uninitialized_move_n(v.data(), v.size(), data());
+				count = v.count;
+			}
+		}
+
+		~static_vector() { _destroy(data(), data() + size()); }
+
+		static_vector& operator=(const static_vector& v)
+		{
+			if (this != &v)
+				_assign(v.data(), v.size(), [](const T& e) -> const T& { return e; });
+			return *this;
+		}
+
+		static_vector& operator=(static_vector&& v)
+			noexcept(std::is_nothrow_move_assignable_v<T> &&
+				std::is_nothrow_move_constructible_v<T>)
+		{
+			if (this != &v)
+				_assign(v.data(), v.size(), [](T& e) -> T&& { return std::move(e); });
+			return *this;
+		}
+
+		static_vector& operator=(std::initializer_list<T> list)
+		{
+			_assign(list.begin(), list.size(),
+				[](const T& e) -> const T& { return e; });
+			return *this;
+		}
+
+		//iterators
+		iterator begin() noexcept { return iterator(data(), data(), _end()); }
+		const_iterator begin() const noexcept { return cbegin(); }
+		iterator end() noexcept { return iterator(_end(), data(), _end()); }
+		const_iterator end() const noexcept { return cend(); }
+
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return crbegin();
+		}
+
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return crend(); }
+
+		const_iterator cbegin() const noexcept
+		{
+			return const_iterator(data(), data(), _end());
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return const_iterator(_end(), data(), _end());
+		}
+
+		const_reverse_iterator crbegin() const noexcept
+		{
+			return const_reverse_iterator(cend());
+		}
+
+		const_reverse_iterator crend() const noexcept
+		{
+			return const_reverse_iterator(cbegin());
+		}
+
+		//capacity
+		bool empty() const noexcept { return count == 0; }
+		bool full() const noexcept { return count == N; }
+		size_type size() const noexcept { return count; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type capacity() noexcept { return N; }
+
+		void resize(size_type n) { _resize(n, [](pointer p) { ::new (p) T(); }); }
+
+		void resize(size_type n, const T& v)
+		{
+			_resize(n, [&v](pointer p) { ::new (p) T(v); });
+		}
+
+		//unchecked element access
+		reference operator[](size_type pos) { return data()[pos]; }
+		const_reference operator[](size_type pos) const { return data()[pos]; }
+
+		//checked element access
+		reference at(size_type pos)
+		{
+			return const_cast<reference>(std::as_const(*this).at(pos));
+		}
+
+		const_reference at(size_type pos) const
+		{
+			if (pos >= size())
+				_throw_out_of_range("static_vector index out of range");
+
+			return data()[pos];
+		}
+
+		pointer try_at(size_type pos) noexcept
+		{
+			return pos < size() ? data() + pos : nullptr;
+		}
+
+		const_pointer try_at(size_type pos) const noexcept
+		{
+			return pos < size() ? data() + pos : nullptr;
+		}
+
+		reference front() { return data()[0]; }
+		const_reference front() const { return data()[0]; }
+		reference back() { return data()[count - 1]; }
+		const_reference back() const { return data()[count - 1]; }
+
+		//underlying raw data
+		pointer data() noexcept { return reinterpret_cast<pointer>(storage); }
+
+		const_pointer data() const noexcept
+		{
+			return reinterpret_cast<const_pointer>(storage);
+		}
+
+		//modifiers
+		template<typename... Args>
+		reference emplace_back(Args&&... args)
+		{
+			_check_capacity(size() + 1);
+			return _unchecked_emplace_back(std::forward<Args>(args)...);
+		}
+
+		void push_back(const T& v) { emplace_back(v); }
+		void push_back(T&& v) { emplace_back(std::move(v)); }
+
+		//as emplace_back/push_back, but nullptr instead of throwing if full
+		template<typename... Args>
+		pointer try_emplace_back(Args&&... args)
+		{
+			if (full())
+				return nullptr;
+
+			return &_unchecked_emplace_back(std::forward<Args>(args)...);
+		}
+
+		pointer try_push_back(const T& v) { return try_emplace_back(v); }
+		pointer try_push_back(T&& v) { return try_emplace_back(std::move(v)); }
+
+		void pop_back()
+		{
+			--count;
+			_destroy(_end(), _end() + 1);
+		}
+
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args)
+		{
+			const size_type index = _index(pos);
+			_check_capacity(size() + 1);
+
+			if (index == size())
+				_unchecked_emplace_back(std::forward<Args>(args)...);
+			else if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				//construct first: args may refer to an element being shifted
+				T v(std::forward<Args>(args)...);
+				pointer p = data() + index;
+				std::memmove(p + 1, p, (size() - index) * sizeof(T));
+				::new (p) T(v);
+				++count;
+			}
+			else
+			{
+				T v(std::forward<Args>(args)...);
+				pointer p = data() + index;
+				::new (_end()) T(std::move(*(_end() - 1)));
+				++count;
+				std::move_backward(p, _end() - 2, _end() - 1);
+				*p = std::move(v);
+			}
+
+			return begin() + static_cast<difference_type>(index);
+		}
+
+		iterator insert(const_iterator pos, const T& v) { return emplace(pos, v); }
+
+		iterator insert(const_iterator pos, T&& v)
+		{
+			return emplace(pos, std::move(v));
+		}
+
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			const size_type index = _index(first);
+			const size_type n = _index(last) - index;
+
+			if (n != 0)
+			{
+				pointer p = data() + index;
+				if constexpr (std::is_trivially_copyable_v<T>)
+					std::memmove(p, p + n, (size() - index - n) * sizeof(T));
+				else
+					std::move(p + n, _end(), p);
+
+				_destroy(_end() - n, _end());
+				count = static_cast<_size_type_for<N>>(count - n);
+			}
+
+			return begin() + static_cast<difference_type>(index);
+		}
+
+		void clear() noexcept
+		{
+			_destroy(data(), _end());
+			count = 0;
+		}
+
+		void swap(static_vector& v)
+			noexcept(std::is_nothrow_swappable_v<T> &&
+				std::is_nothrow_move_constructible_v<T>)
+		{
+			static_vector& shorter = size() < v.size() ? *this : v;
+			static_vector& longer = size() < v.size() ? v : *this;
+
+			using std::swap;
+			for (size_type i = 0; i < shorter.size(); ++i)
+				swap(shorter[i], longer[i]);
+
+			const size_type n = shorter.size();
+			for (size_type i = n; i < longer.size(); ++i)
+				shorter._unchecked_emplace_back(std::move(longer[i]));
+
+			longer._destroy(longer.data() + n, longer._end());
+			longer.count = static_cast<_size_type_for<N>>(n);
+		}
+
+	private:
+		//uninitialized storage for N elements; one byte if N is 0
+		alignas(T) unsigned char storage[N == 0 ? 1 : N * sizeof(T)];
+		_size_type_for<N> count{ 0 };
+
+		pointer _end() noexcept { return data() + count; }
+		const_pointer _end() const noexcept { return data() + count; }
+
+		size_type _index(const_iterator pos) const noexcept
+		{
+			return static_cast<size_type>(pos.base() - data());
+		}
+
+		static void _check_capacity(size_type n)
+		{
+			if (n > N)
+				_throw_length_error("static_vector capacity exceeded");
+		}
+
+		template<typename... Args>
+		reference _unchecked_emplace_back(Args&&... args)
+		{
+			pointer p = ::new (_end()) T(std::forward<Args>(args)...);
+			++count;
+			return *p;
+		}
+
+		static void _destroy([[maybe_unused]] pointer first,
+			[[maybe_unused]] pointer last) noexcept
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				std::destroy(first, last);
+		}
+
+		//construct from n elements at p into empty storage
+		void _copy_construct(const_pointer p, size_type n)
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				if (n != 0)
+					std::memcpy(storage, p, n * sizeof(T));
+			}
+			else
+				std::uninitialized_copy_n(p, n, data());
+
+			count = static_cast<_size_type_for<N>>(n);
+		}
+
+		//replace contents with n elements at p, each passed through get
+		//-get yields an lvalue to copy or an xvalue to move
+		template<typename P, typename Get>
+		void _assign(P p, size_type n, Get get)
+		{
+			_check_capacity(n);
+
+			const size_type common = std::min(size(), n);
+			for (size_type i = 0; i < common; ++i)
+				data()[i] = get(p[i]);
+
+			//count each new element as it is built: a throwing copy
+			//leaves only complete elements for the destructor
+			if (n < size())
+				_destroy(data() + n, _end());
+			else
+				for (; count < n; ++count)
+					::new (_end()) T(get(p[count]));
+
+			count = static_cast<_size_type_for<N>>(n);
+		}
+
+		template<typename Construct>
+		void _resize(size_type n, Construct construct)
+		{
+			_check_capacity(n);
+
+			if (n < size())
+				_destroy(data() + n, _end());
+			else
+				for (; count < n; ++count)
+					construct(_end());
+
+			count = static_cast<_size_type_for<N>>(n);
+		}
+
+	}; //template static_vector
+
+	template<typename T, std::size_t N>
+	bool operator==(const static_vector<T, N>& a, const static_vector<T, N>& b)
+	{
+		return a.size() == b.size() &&
+			std::equal(a.data(), a.data() + a.size(), b.data());
+	}
+
+	template<typename T, std::size_t N>
+	bool operator!=(const static_vector<T, N>& a, const static_vector<T, N>& b)
+	{
+		return !(a == b);
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,209 @@
+/*
+* stream.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define fill and copy with non-temporal (streaming) stores
+* - stream_fill and stream_copy write with non-temporal stores if the data
+*   is at least stream_threshold bytes (SIGCPP_STREAM_THRESHOLD, see
+*   config.h), else they are fill and copy
+* - non-temporal stores bypass the cache: filling a buffer larger than the
+*   last-level cache does not evict data other code will read, and lines
+*   are not read in just to be overwritten
+* - use them for data not read again soon, such as buffers reset each frame;
+*   the next read of the data comes from memory
+* - each call ends with a store fence (sfence): the stores are visible to
+*   other threads in order with later stores, as with ordinary stores
+* - x86 only (SSE2 or AVX2); elsewhere, or with SIGCPP_NO_SIMD, they are
+*   always fill and copy
+* - stream_fill streams trivially-copyable T whose size divides the register
+*   size; stream_copy streams any trivially-copyable T; other types use
+*   std::fill_n and std::copy_n
+* - the source and destination of stream_copy must not overlap
+*/
+
+#ifndef SIGCPP_STREAM_H
+#define SIGCPP_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include "config.h"
+#include "array.h"
+#include "simd.h"
+
+namespace sigcpp::simd
+{
+#if defined(SIGCPP_SIMD_AVX2)
+
+	//bytes written by one non-temporal store; 0 if there are none
+	inline constexpr std::size_t stream_size = 32;
+
+	inline __m256i _stream_load(const unsigned char* p) noexcept
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	}
+
+	inline void _stream_store(unsigned char* p, __m256i r) noexcept
+	{
+		_mm256_stream_si256(reinterpret_cast<__m256i*>(p), r);
+	}
+
+#elif defined(SIGCPP_SIMD_SSE2)
+
+	inline constexpr std::size_t stream_size = 16;
+
+	inline __m128i _stream_load(const unsigned char* p) noexcept
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	}
+
+	inline void _stream_store(unsigned char* p, __m128i r) noexcept
+	{
+		_mm_stream_si128(reinterpret_cast<__m128i*>(p), r);
+	}
+
+#else
+
+	inline constexpr std::size_t stream_size = 0;
+
+#endif
+
+#if defined(SIGCPP_SIMD_AVX2) || defined(SIGCPP_SIMD_SSE2)
+
+	//bytes from p to the next stream_size boundary, at most n
+	inline std::size_t _stream_head(const unsigned char* p, std::size_t n) noexcept
+	{
+		const std::size_t misalign = reinterpret_cast<std::uintptr_t>(p) % stream_size;
+		const std::size_t head = misalign == 0 ? 0 : stream_size - misalign;
+		return head < n ? head : n;
+	}
+
+	//byte k of the n bytes at p becomes pattern[k % stream_size]
+	//-stores before the first and after the last register boundary are ordinary
+	inline void stream_fill(unsigned char* p, std::size_t n, const unsigned char* pattern) noexcept
+	{
+		const std::size_t head = _stream_head(p, n);
+		for (std::size_t k = 0; k < head; ++k)
+			p[k] = pattern[k];
+
+		//the pattern as seen from the first boundary
+		unsigned char rotated[stream_size];
+		for (std::size_t j = 0; j < stream_size; ++j)
+			rotated[j] = pattern[(head + j) % stream_size];
+		const auto r = _stream_load(rotated);
+
+		std::size_t k = head;
+		for (; k + stream_size <= n; k += stream_size)
+			_stream_store(p + k, r);
+
+		for (; k < n; ++k)
+			p[k] = pattern[k % stream_size];
+
+		_mm_sfence();
+	}
+
+	//copy the n bytes at from to to
+	inline void stream_copy(const unsigned char* from, std::size_t n, unsigned char* to) noexcept
+	{
+		const std::size_t head = _stream_head(to, n);
+		std::memcpy(to, from, head);
+
+		std::size_t k = head;
+		for (; k + stream_size <= n; k += stream_size)
+			_stream_store(to + k, _stream_load(from + k));
+
+		std::memcpy(to + k, from + k, n - k);
+
+		_mm_sfence();
+	}
+
+#endif
+
+}	//namespace sigcpp::simd
+
+
+namespace sigcpp
+{
+	inline constexpr std::size_t stream_threshold = SIGCPP_STREAM_THRESHOLD;
+
+	//T is written as bytes in non-temporal stores
+	template<typename T>
+	inline constexpr bool _is_stream_copyable =
+		simd::stream_size != 0 && std::is_trivially_copyable_v<T>;
+
+	//-and the bytes of a T repeat within a register
+	template<typename T>
+	inline constexpr bool _is_stream_fillable =
+		_is_stream_copyable<T> && simd::stream_size % sizeof(T) == 0;
+
+	//assign value to the n elements at first
+	template<typename T>
+	void stream_fill(T* first, std::size_t n, const T& value)
+	{
+#if defined(SIGCPP_SIMD_AVX2) || defined(SIGCPP_SIMD_SSE2)
+		if constexpr (_is_stream_fillable<T>)
+		{
+			if (n * sizeof(T) >= stream_threshold)
+			{
+				unsigned char pattern[simd::stream_size];
+				for (std::size_t i = 0; i < simd::stream_size; i += sizeof(T))
+					std::memcpy(pattern + i, &value, sizeof(T));
+
+				simd::stream_fill(reinterpret_cast<unsigned char*>(first), n * sizeof(T), pattern);
+				return;
+			}
+		}
+#endif
+		std::fill_n(first, n, value);
+	}
+
+	//copy the n elements at first to out
+	template<typename T>
+	void stream_copy(const T* first, std::size_t n, T* out)
+	{
+#if defined(SIGCPP_SIMD_AVX2) || defined(SIGCPP_SIMD_SSE2)
+		if constexpr (_is_stream_copyable<T>)
+		{
+			if (n * sizeof(T) >= stream_threshold)
+			{
+				simd::stream_copy(reinterpret_cast<const unsigned char*>(first), n * sizeof(T),
+					reinterpret_cast<unsigned char*>(out));
+				return;
+			}
+		}
+#endif
+		std::copy_n(first, n, out);
+	}
+
+	//arrays: the size is known, so is the choice of stores
+	//-aligned_array converts to array: these overloads accept it
+	template<typename T, std::size_t N>
+	void stream_fill(array<T, N>& a, const T& value)
+	{
+		if constexpr (N * sizeof(T) >= stream_threshold)
+			stream_fill(a.data(), N, value);
+		else
+			a.fill(value);
+	}
+
+	template<typename T, std::size_t N>
+	void stream_copy(const array<T, N>& from, array<T, N>& to)
+	{
+		if constexpr (N * sizeof(T) >= stream_threshold)
+			stream_copy(from.data(), N, to.data());
+		else
+			to = from;
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,223 @@
+/*
+* thread_pool.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define a small work-stealing thread pool for fork-join loops
+* - parallel_for(n, f) calls f(i) for each i in [0, n) and returns when all
+*   calls are done; the calling thread takes part
+* - indices are dealt to per-thread queues in contiguous blocks; a thread
+*   takes from the front of its own queue and steals from the back of others
+* - a parallel_for inside f, or with a one-thread pool, runs sequentially
+* - as with the std parallel algorithms, an exception escaping f calls
+*   std::terminate
+*/
+
+#ifndef SIGCPP_THREAD_POOL_H
+#define SIGCPP_THREAD_POOL_H
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <type_traits>
+
+#include "aligned_array.h"
+
+namespace sigcpp
+{
+	class thread_pool
+	{
+	public:
+		//threads includes the calling thread: threads - 1 workers are started
+		explicit thread_pool(unsigned threads = std::thread::hardware_concurrency())
+			: threadCount(threads == 0 ? 1 : threads),
+			queues(new queue[threadCount])
+		{
+			workers.reserve(threadCount - 1);
+			for (unsigned id = 1; id < threadCount; ++id)
+				workers.emplace_back([this, id] { _worker(id); });
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				stopping = true;
+			}
+			wake.notify_all();
+
+			for (auto& t : workers)
+				t.join();
+		}
+
+		//number of threads, including the calling thread
+		unsigned size() const noexcept { return threadCount; }
+
+		//pool shared by the parallel algorithms: one thread per core
+		static thread_pool& instance()
+		{
+			static thread_pool pool;
+			return pool;
+		}
+
+		template<typename F>
+		void parallel_for(std::size_t n, F&& f)
+		{
+			if (n == 0)
+				return;
+
+			if (n == 1 || threadCount == 1 || current == this)
+			{
+				for (std::size_t i = 0; i < n; ++i)
+					f(i);
+				return;
+			}
+
+			//queue 0 belongs to the calling thread: one caller at a time
+			std::lock_guard<std::mutex> submit(submitMutex);
+
+			job j{ &_invoke<std::remove_reference_t<F>>, &f, { n } };
+			for (unsigned q = 0; q < threadCount; ++q)
+			{
+				const std::size_t first = n * q / threadCount;
+				const std::size_t last = n * (q + 1) / threadCount;
+
+				std::lock_guard<std::mutex> lock(queues[q].mutex);
+				for (std::size_t i = first; i < last; ++i)
+					queues[q].tasks.push_back(task{ &j, i });
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				queued.fetch_add(n, std::memory_order_relaxed);
+			}
+			wake.notify_all();
+
+			//work, then wait for tasks other threads have taken
+			//-tasks run here see this pool as current so that nested calls
+			//are sequential instead of waiting on submitMutex
+			thread_pool* const outer = current;
+			current = this;
+			_work(0);
+			current = outer;
+			while (j.remaining.load(std::memory_order_acquire) != 0)
+				std::this_thread::yield();
+		}
+
+	private:
+		//one parallel_for call: tasks refer to it by address
+		struct job
+		{
+			void (*invoke)(void* f, std::size_t i) noexcept;
+			void* f;
+			std::atomic<std::size_t> remaining;
+		};
+
+		struct task
+		{
+			job* j;
+			std::size_t index;
+		};
+
+		//each queue on its own cache lines: owners and thieves lock it
+		struct alignas(cache_line_size) queue
+		{
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+		unsigned threadCount;
+		std::unique_ptr<queue[]> queues;
+		std::vector<std::thread> workers;
+
+		std::mutex submitMutex;
+		std::mutex wakeMutex;
+		std::condition_variable wake;
+		std::atomic<std::size_t> queued{ 0 };
+		bool stopping{ false };
+
+		//pool whose worker is running on this thread, if any
+		inline static thread_local thread_pool* current = nullptr;
+
+		template<typename F>
+		static void _invoke(void* f, std::size_t i) noexcept
+		{
+			(*static_cast<F*>(f))(i);
+		}
+
+		bool _pop(unsigned id, task& t)
+		{
+			std::lock_guard<std::mutex> lock(queues[id].mutex);
+			if (queues[id].tasks.empty())
+				return false;
+
+			t = queues[id].tasks.front();
+			queues[id].tasks.pop_front();
+			queued.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+
+		bool _steal(unsigned id, task& t)
+		{
+			for (unsigned k = 1; k < threadCount; ++k)
+			{
+				queue& victim = queues[(id + k) % threadCount];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.tasks.empty())
+				{
+					t = victim.tasks.back();
+					victim.tasks.pop_back();
+					queued.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//run tasks until no queue has any
+		void _work(unsigned id)
+		{
+			task t;
+			while (_pop(id, t) || _steal(id, t))
+			{
+				t.j->invoke(t.j->f, t.index);
+				t.j->remaining.fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		void _worker(unsigned id)
+		{
+			current = this;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(wakeMutex);
+					wake.wait(lock, [this] {
+						return stopping || queued.load(std::memory_order_relaxed) != 0;
+					});
+
+					if (stopping)
+						return;
+				}
+				_work(id);
+			}
+		}
+
+	}; //class thread_pool
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,53 @@
+/*
+* throw.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define helpers that throw standard exceptions
+* - helpers are never inlined and are marked cold: a checked operation
+*   compiles to a compare and a branch to a call, keeping its hot path small
+* - exceptions are thrown by value, to be caught by reference
+*/
+
+#ifndef SIGCPP_THROW_H
+#define SIGCPP_THROW_H
+
+#include <new>
+#include <stdexcept>
+
+#include "config.h"
+
+namespace sigcpp
+{
+	[[noreturn]] SIGCPP_NOINLINE SIGCPP_COLD
+	inline void _throw_out_of_range(const char* msg)
+	{
+		throw std::out_of_range(msg);
+	}
+
+	[[noreturn]] SIGCPP_NOINLINE SIGCPP_COLD
+	inline void _throw_length_error(const char* msg)
+	{
+		throw std::length_error(msg);
+	}
+
+	[[noreturn]] SIGCPP_NOINLINE SIGCPP_COLD
+	inline void _throw_invalid_argument(const char* msg)
+	{
+		throw std::invalid_argument(msg);
+	}
+
+	[[noreturn]] SIGCPP_NOINLINE SIGCPP_COLD
+	inline void _throw_bad_alloc()
+	{
+		throw std::bad_alloc();
+	}
+
+}	//namespace sigcpp
+
+#endif
@@ -0,0 +1,177 @@
+/*
+* algorithm-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test bulk algorithms on array
+* - compare each algorithm with the corresponding std algorithm
+* - sizes are chosen to exercise kernels with and without a tail, and arrays
+*   smaller than one register
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <string>
+#include <cstdint>
+
+#include "../include/algorithm.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+
+//deterministic values with repeats: small integers keep float sums exact
+template<typename T, std::size_t N>
+static array<T, N> makeArray(unsigned seed)
+{
+   array<T, N> a{};
+   unsigned x = seed;
+   for (auto& e : a)
+   {
+      x = x * 1103515245u + 12345u;
+      e = static_cast<T>((x >> 16) % 23);
+   }
+   return a;
+}
+
+template<typename T, std::size_t N>
+static void testArithmetic(const std::string& name)
+{
+   auto a = makeArray<T, N>(N);
+
+   T expected = std::accumulate(a.begin(), a.end(), T(3));
+   verify(sigcpp::reduce(a, T(3)) == expected, (name + " reduce").c_str());
+
+   auto mm = std::minmax_element(a.begin(), a.end());
+   auto r = sigcpp::minmax(a);
+   verify(r.first == *mm.first && r.second == *mm.second,
+          (name + " minmax").c_str());
+
+   //place the extremes in the tail
+   a.back() = static_cast<T>(-1);
+   a.front() = static_cast<T>(100);
+   mm = std::minmax_element(a.begin(), a.end());
+   r = sigcpp::minmax(a);
+   verify(r.first == *mm.first && r.second == *mm.second,
+          (name + " minmax extremes").c_str());
+}
+
+template<typename T, std::size_t N>
+static void testSearch(const std::string& name)
+{
+   auto a = makeArray<T, N>(N + 1);
+   const auto& c = a;
+
+   bool findTest = true;
+   for (unsigned v = 0; v < 24 && findTest; ++v)
+   {
+      T value = static_cast<T>(v);
+      findTest = sigcpp::find(a, value) == std::find(a.begin(), a.end(), value)
+         && sigcpp::find(c, value) == std::find(c.begin(), c.end(), value);
+   }
+   verify(findTest, (name + " find").c_str());
+
+   bool countTest = true;
+   for (unsigned v = 0; v < 24 && countTest; ++v)
+   {
+      T value = static_cast<T>(v);
+      countTest = sigcpp::count(a, value) ==
+         static_cast<std::size_t>(std::count(a.begin(), a.end(), value));
+   }
+   verify(countTest, (name + " count").c_str());
+
+   auto b = a;
+   verify(sigcpp::equal(a, b), (name + " equal").c_str());
+   verify(!sigcpp::lexicographical_compare(a, b),
+          (name + " lexicographical_compare equal").c_str());
+
+   //a single difference at each position
+   bool compareTest = true;
+   for (std::size_t i = 0; i < N && compareTest; ++i)
+   {
+      b = a;
+      b[i] = static_cast<T>(b[i] + 1);
+      compareTest = !sigcpp::equal(a, b) && !sigcpp::equal(b, a)
+         && sigcpp::lexicographical_compare(a, b)
+         && !sigcpp::lexicographical_compare(b, a);
+   }
+   verify(compareTest, (name + " compare single difference").c_str());
+
+   //two differences: the first decides the order
+   if constexpr (N > 1)
+   {
+      b = a;
+      b[N / 2] = static_cast<T>(b[N / 2] + 1);
+      b[N - 1] = static_cast<T>(b[N - 1] - 1);
+      compareTest = sigcpp::lexicographical_compare(a, b) ==
+         std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+      verify(compareTest, (name + " compare two differences").c_str());
+   }
+}
+
+template<typename T, std::size_t N>
+static void testAll(const char* type)
+{
+   std::string name = std::string(type) + "[" + std::to_string(N) + "]";
+   testArithmetic<T, N>(name);
+   testSearch<T, N>(name);
+}
+
+template<typename T>
+static void testSizes(const char* type)
+{
+   testAll<T, 1>(type);
+   testAll<T, 3>(type);
+   testAll<T, 4>(type);
+   testAll<T, 7>(type);
+   testAll<T, 8>(type);
+   testAll<T, 9>(type);
+   testAll<T, 33>(type);
+   testAll<T, 64>(type);
+   testAll<T, 67>(type);
+}
+
+TEST_CASE(algorithm)
+{
+   testSizes<float>("float");
+   testSizes<double>("double");
+   testSizes<int>("int");
+   testSizes<unsigned>("unsigned");
+   testSizes<long long>("long long");
+   testSizes<unsigned char>("unsigned char");
+   testSizes<char>("char");
+
+   //empty array
+   array<int, 0> e;
+   verify(sigcpp::reduce(e, 5) == 5, "reduce on empty array");
+   verify(sigcpp::find(e, 1) == e.end(), "find on empty array");
+   verify(sigcpp::count(e, 1) == 0, "count on empty array");
+   verify(sigcpp::equal(e, e), "equal on empty array");
+
+   //NaN is unequal to itself but does not order
+   const float nan = std::numeric_limits<float>::quiet_NaN();
+   array<float, 9> f1{ 1, 2, 3, nan, 5, 6, 7, 8, 9 };
+   array<float, 9> f2{ 1, 2, 3, nan, 5, 6, 7, 8, 10 };
+   verify(!sigcpp::equal(f1, f1), "equal with NaN");
+   verify(sigcpp::lexicographical_compare(f1, f2), "f1 < f2 with NaN");
+   verify(!sigcpp::lexicographical_compare(f2, f1), "!(f2 < f1) with NaN");
+   verify(sigcpp::find(f1, nan) == f1.end(), "find NaN");
+
+   //non-arithmetic elements use std algorithms
+   array<std::string, 3> s{ "beta", "alpha", "beta" };
+   array<std::string, 3> t{ "beta", "alpha", "gamma" };
+   verify(sigcpp::find(s, std::string("alpha")) == s.begin() + 1,
+          "find std::string");
+   verify(sigcpp::count(s, std::string("beta")) == 2, "count std::string");
+   verify(!sigcpp::equal(s, t), "equal std::string");
+   verify(sigcpp::lexicographical_compare(s, t),
+          "lexicographical_compare std::string");
+   verify(sigcpp::minmax(s).first == "alpha", "minmax std::string");
+   verify(sigcpp::reduce(s) == "betaalphabeta", "reduce std::string");
+}
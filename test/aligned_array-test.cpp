@@ -0,0 +1,98 @@
+/*
+* aligned_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test aligned_array template
+*/
+
+#include <cstdint>
+#include <numeric>
+
+#include "../include/aligned_array.h"
+#include "../include/algorithm.h"
+
+#include "tester.h"
+
+using sigcpp::aligned_array;
+using sigcpp::cache_line_size;
+
+//alignment and size are compile-time properties
+static_assert(aligned_array<float, 3, 16>::alignment == 16);
+static_assert(alignof(aligned_array<char, 5, 32>) == 32);
+static_assert(sizeof(aligned_array<char, 5, 32>) == 32);
+static_assert(sizeof(aligned_array<int, 1, cache_line_size>) == cache_line_size);
+
+//aggregate initialization and constant evaluation are retained
+constexpr aligned_array<short, 3, 16> cs{ 8, -2, 7 };
+static_assert(cs[0] == 8 && cs.back() == 7 && cs.size() == 3);
+
+template<typename T>
+static bool isAligned(const T* p, std::size_t alignment)
+{
+   return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+TEST_CASE(aligned_array)
+{
+   //non-empty array with full init and partial init
+   aligned_array<short, 3, 16> s{ 8, -2, 7 };
+   aligned_array<short, 5, 32> p{ 8, -2, 7 };
+
+   verify(s[0] == 8 && s[1] == -2 && s[2] == 7, "s{ 8, -2, 7 }");
+   verify(p[2] == 7 && p[4] == 0, "p{ 8, -2, 7 }");
+   verify(isAligned(s.data(), 16), "s.data() aligned to 16");
+   verify(isAligned(p.data(), 32), "p.data() aligned to 32");
+
+   //each element of an array of aligned arrays is aligned
+   //-e.g., per-thread counters that must not share a cache line
+   sigcpp::array<aligned_array<unsigned, 1, cache_line_size>, 4> counters{};
+   bool alignTest = true;
+   for (const auto& c : counters)
+      alignTest = alignTest && isAligned(c.data(), cache_line_size);
+   verify(alignTest, "counters aligned to cache line");
+
+   verify(reinterpret_cast<const char*>(counters[1].data()) -
+          reinterpret_cast<const char*>(counters[0].data()) ==
+          static_cast<std::ptrdiff_t>(cache_line_size),
+          "counters one cache line apart");
+
+   //members of array are available
+   aligned_array<int, 3, 64> m{ 8, 5, 4 };
+   aligned_array<int, 3, 64> n{ 10, -2, 7 };
+   m.swap(n);
+   verify(m[0] == 10 && m[2] == 7 && n[0] == 8 && n[2] == 4, "m.swap(n)");
+
+   m.fill(3);
+   verify(std::accumulate(m.begin(), m.end(), 0) == 9, "m.fill(3)");
+
+   //converts to array
+   sigcpp::array<int, 3>& base = m;
+   verify(base.data() == m.data(), "conversion to array&");
+
+   //algorithms use aligned loads
+   aligned_array<float, 67, 32> f{};
+   for (std::size_t i = 0; i < f.size(); ++i)
+      f[i] = static_cast<float>(i % 10);
+
+   verify(sigcpp::reduce(f) == 291.0f, "reduce(f)");
+   verify(sigcpp::minmax(f).second == 9.0f, "minmax(f)");
+   verify(sigcpp::find(f, 9.0f) == f.begin() + 9, "find(f, 9)");
+   verify(sigcpp::count(f, 9.0f) == 6, "count(f, 9)");
+
+   aligned_array<float, 67, 32> g = f;
+   verify(sigcpp::equal(f, g), "equal(f, g)");
+   g[66] = 10;
+   verify(sigcpp::lexicographical_compare(f, g), "lexicographical_compare(f, g)");
+
+   //tuple interface of the base array
+   sigcpp::aligned_array<float, 4, 16> v{ 1.0f, 2.0f, 3.0f, 4.0f };
+   auto [x, y, z, w] = v;
+   verify(x + y + z + w == 10.0f && std::tuple_size_v<decltype(v)> == 4,
+          "structured bindings");
+}
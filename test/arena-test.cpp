@@ -0,0 +1,149 @@
+/*
+* arena-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test monotonic_arena, static_arena, and block_pool
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <new>
+
+#include "../include/arena.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+
+namespace
+{
+   bool inside(const void* p, const void* first, std::size_t size)
+   {
+      const std::byte* b = static_cast<const std::byte*>(p);
+      const std::byte* f = static_cast<const std::byte*>(first);
+      return f <= b && b < f + size;
+   }
+
+   bool aligned(const void* p, std::size_t alignment)
+   {
+      return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+   }
+}
+
+TEST_CASE(arena)
+{
+   //containers allocate from a caller-supplied array
+   alignas(std::max_align_t) array<std::byte, 4096> buffer;
+   sigcpp::monotonic_arena arena(buffer);
+   {
+      sigcpp::pmr::vector<int> v(&arena);
+      v.reserve(100);
+      for (int i = 0; i < 100; ++i)
+         v.push_back(i);
+
+      sigcpp::pmr::string s("a string too long for the small-string buffer", &arena);
+
+      verify(inside(v.data(), buffer.data(), buffer.size()) &&
+             inside(s.data(), buffer.data(), buffer.size()), "allocations in buffer");
+      verify(arena.allocation_count() == 2 && arena.bytes_used() >= 400 + s.size(),
+             "arena stats");
+   }
+
+   //deallocation frees nothing; release frees everything
+   const std::size_t used = arena.bytes_used();
+   verify(used != 0 && arena.high_water() == used, "high water");
+
+   arena.release();
+   verify(arena.bytes_used() == 0 && arena.high_water() == used, "release keeps high water");
+
+   void* a = arena.allocate(1, 1);
+   void* b = arena.allocate(8, 64);
+   verify(a == buffer.data() && aligned(b, 64), "alignment");
+
+   //exhaustion: bad_alloc without upstream
+   bool exhausted = false;
+   try
+   {
+      static_cast<void>(arena.allocate(8192));
+   }
+   catch (const std::bad_alloc&)
+   {
+      exhausted = true;
+   }
+   verify(exhausted && arena.upstream_bytes() == 0, "exhausted arena throws bad_alloc");
+
+   //with an upstream, the arena continues in chunks
+   sigcpp::static_arena<256> spill(std::pmr::new_delete_resource());
+   {
+      sigcpp::pmr::vector<std::uint64_t> v(&spill);
+      for (std::uint64_t i = 0; i < 1000; ++i)
+         v.push_back(i);
+      verify(v[999] == 999 && spill.upstream_bytes() != 0, "upstream chunks");
+   }
+   spill.release();
+   verify(spill.bytes_used() == 0 && spill.capacity() == 256, "release upstream chunks");
+
+   //a request whose chunk size overflows throws instead of returning nullptr
+   //-volatile: a visible size this large warns at compile time
+   const std::size_t upstreamBefore = spill.upstream_bytes();
+   volatile std::size_t huge = static_cast<std::size_t>(-1) - 8;
+   bool overflow = false;
+   try
+   {
+      static_cast<void>(spill.allocate(huge, 8));
+   }
+   catch (const std::bad_alloc&)
+   {
+      overflow = true;
+   }
+   verify(overflow && spill.upstream_bytes() == upstreamBefore, "huge request throws bad_alloc");
+
+   //fixed-size blocks: list nodes
+   alignas(std::max_align_t) array<std::byte, 1024> poolBuffer;
+   sigcpp::block_pool pool(poolBuffer, 24);
+   verify(pool.block_size() == 24 && pool.block_alignment() == 8 &&
+          pool.block_count() == 1024 / 24, "block geometry");
+   {
+      std::pmr::list<int> l(&pool);
+      for (int i = 0; i < 10; ++i)
+         l.push_back(i);
+      verify(pool.blocks_in_use() == 10 && pool.upstream_allocations() == 0, "pool stats");
+
+      l.pop_front();
+      l.push_back(10);
+      verify(pool.blocks_in_use() == 10 && pool.high_water() == 10, "blocks reused");
+   }
+   verify(pool.blocks_in_use() == 0, "blocks returned");
+
+   //blocks come back in LIFO order
+   void* p = pool.allocate(16, 8);
+   pool.deallocate(p, 16, 8);
+   verify(pool.allocate(16, 8) == p, "free list");
+
+   bool tooLarge = false;
+   try
+   {
+      static_cast<void>(pool.allocate(32));
+   }
+   catch (const std::bad_alloc&)
+   {
+      tooLarge = true;
+   }
+   verify(tooLarge && pool.upstream_allocations() == 1, "oversize request goes upstream");
+
+   //a pool over an arena: large requests spill to the arena
+   sigcpp::static_arena<2048> backing;
+   array<std::byte, 256> small;
+   sigcpp::block_pool chained(small, 32, &backing);
+   void* big = chained.allocate(100, 8);
+   verify(inside(big, &backing, sizeof(backing)) && chained.upstream_allocations() == 1,
+          "pool over arena");
+   chained.deallocate(big, 100, 8);
+}
@@ -13,15 +13,173 @@
 */
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 #include "../include/array.h"
 
 #include "tester.h"
 
-void runTests()
+//compile-time use: every member is usable in constant expressions
+using sigcpp::array;
+
+//build a table of squares through iterators
+constexpr array<unsigned, 8> makeSquares()
+{
+   array<unsigned, 8> a{};
+   unsigned i = 0;
+   for (auto it = a.begin(); it != a.end(); ++it, ++i)
+      *it = i * i;
+   return a;
+}
+
+constexpr array<unsigned, 8> squares = makeSquares();
+static_assert(squares[0] == 0 && squares[3] == 9 && squares.back() == 49);
+static_assert(squares.at(7) == 49);
+static_assert(*squares.try_at(7) == 49 && squares.try_at(8) == nullptr);
+static_assert(*squares.rbegin() == 49 && *(squares.rend() - 1) == 0);
+
+//iterator arithmetic
+static_assert(*(squares.begin() + 5) == 25);
+static_assert(*(2 + squares.begin()) == 4);
+static_assert(*(squares.end() - 1) == 49);
+static_assert(squares.begin()[6] == 36);
+static_assert(squares.end() - squares.begin() == 8);
+static_assert(squares.begin() < squares.end());
+static_assert(squares.begin() <= squares.end() && !(squares.end() <= squares.begin()));
+static_assert(squares.end() >= squares.begin() && squares.begin() <= squares.begin());
+
+constexpr unsigned compoundAssign()
+{
+   auto it = squares.begin();
+   it += 6;
+   it -= 2;
+   return *it;
+}
+static_assert(compoundAssign() == 16);
+
+//fill and swap
+constexpr array<int, 4> makeFilled(int v)
+{
+   array<int, 4> a{};
+   a.fill(v);
+   return a;
+}
+
+static_assert(makeFilled(3)[0] == 3 && makeFilled(3)[3] == 3);
+
+constexpr int swapped()
+{
+   array<int, 3> m{ 1, 2, 3 };
+   array<int, 3> n{ 4, 5, 6 };
+   m.swap(n);
+   return m[0] * 100 + n[2] * 10 + m[2];
+}
+static_assert(swapped() == 436);
+
+//tuple interface
+static_assert(std::tuple_size_v<array<unsigned, 8>> == 8);
+static_assert(std::is_same_v<std::tuple_element_t<2, const array<int, 3>>, const int>);
+static_assert(sigcpp::get<3>(squares) == 9);
+static_assert(sigcpp::get<1>(makeFilled(5)) == 5);
+
+constexpr int sumOfBindings()
 {
-   using sigcpp::array;
+   auto [x, y, z] = array<int, 3>{ 1, 2, 3 };
+   return x * 100 + y * 10 + z;
+}
+static_assert(sumOfBindings() == 123);
+
+//comparison
+static_assert(array{ 1, 2, 3 } == array{ 1, 2, 3 } && array{ 1, 2, 3 } != array{ 1, 2, 4 });
+static_assert(array{ 1, 2, 3 } < array{ 1, 3, 0 } && array{ 2, 0 } > array{ 1, 9 });
+static_assert(array{ 1, 2 } <= array{ 1, 2 } && array{ 1, 2 } >= array{ 1, 2 });
+static_assert(array<unsigned char, 2>{ 1, 2 } < array<unsigned char, 2>{ 1, 200 });
+static_assert(array<int, 0>{} == array<int, 0>{} && !(array<int, 0>{} < array<int, 0>{}));
+
+#if defined(__cpp_lib_three_way_comparison)
+static_assert((array{ 1, 2, 3 } <=> array{ 1, 2, 4 }) < 0);
+#endif
+
+//deduction guide and to_array
+constexpr array deduced{ 2, 4, 6 };
+static_assert(std::is_same_v<decltype(deduced), const array<int, 3>>);
+static_assert(deduced[2] == 6);
+
+constexpr int builtIn[] = { 1, 3, 5, 7 };
+constexpr auto fromBuiltIn = sigcpp::to_array(builtIn);
+static_assert(std::is_same_v<decltype(fromBuiltIn), const array<int, 4>>);
+static_assert(fromBuiltIn[3] == 7);
+
+constexpr auto fromString = sigcpp::to_array("sig");
+static_assert(fromString.size() == 4 && fromString[0] == 's' && fromString[3] == '\0');
+
+//unchecked iterators have the layout of a raw pointer
+#if SIGCPP_ITERATOR_DEBUG
+static_assert(sizeof(array<int, 4>::iterator) == 3 * sizeof(int*));
+#else
+static_assert(sizeof(array<int, 4>::iterator) == sizeof(int*));
+static_assert(sizeof(array<int, 4>::const_iterator) == sizeof(const int*));
+static_assert(std::is_trivially_copyable_v<array<int, 4>::iterator>);
+#endif
+
+#if SIGCPP_ITERATOR_DEBUG
+//true if f traps: main reports iterator misuse as std::logic_error
+template<typename F>
+static bool traps(F f)
+{
+   try
+   {
+      f();
+   }
+   catch (const std::logic_error&)
+   {
+      return true;
+   }
+   return false;
+}
+
+//n hidden from the optimizer: out-of-range offsets that the checks must
+//trap would otherwise warn at compile time
+static std::ptrdiff_t opaque(std::ptrdiff_t n)
+{
+   volatile std::ptrdiff_t v = n;
+   return v;
+}
+
+static void testCheckedIterators()
+{
+   array<int, 3> m{ 1, 2, 3 };
+   array<int, 3> n{ 4, 5, 6 };
+
+   verify(!traps([&] { return *m.begin() + *(m.end() - 1) + m.begin()[2]; }),
+          "checked iterator: valid access");
+   verify(!traps([&] { auto it = m.end(); it -= 3; it += 3; }),
+          "checked iterator: arithmetic to end");
+   verify(traps([&] { return *(m.begin() + opaque(3)); }), "checked iterator: deref end");
+   verify(traps([&] { return m.begin()[opaque(3)]; }), "checked iterator: index past end");
+   verify(traps([&] { return m.begin()[opaque(-1)]; }),
+          "checked iterator: index before begin");
+   verify(traps([&] { auto it = m.begin() + opaque(3); ++it; }),
+          "checked iterator: increment past end");
+   verify(traps([&] { auto it = m.end() - opaque(3); --it; }),
+          "checked iterator: decrement before begin");
+   verify(traps([&] { return m.begin() + 4; }), "checked iterator: add past end");
+   verify(traps([&] { return m.begin() == n.begin(); }),
+          "checked iterator: compare different arrays");
+   verify(traps([&] { return m.end() - n.begin(); }),
+          "checked iterator: subtract different arrays");
+   verify(traps([&] { return *(m.rbegin() + opaque(3)); }), "checked iterator: deref rend");
+}
+#endif
 
+
+TEST_CASE(array)
+{
    //non-empty array with full init
    array<short, 3> s{ 8, -2, 7 };
 
@@ -57,6 +215,23 @@ void runTests()
    verify(p.at(2) == 7, "p.at(2)");
    verify(p.at(4) == 0, "p.at(4)");
 
+   //out-of-range at() throws std::out_of_range by value
+   bool atTest = false;
+   try
+   {
+      s.at(3);
+   }
+   catch (const std::out_of_range&)
+   {
+      atTest = true;
+   }
+   verify(atTest, "s.at(3) throws std::out_of_range");
+
+   verify(s.try_at(1) == &s[1] && *s.try_at(2) == 7, "s.try_at(1), s.try_at(2)");
+   verify(s.try_at(3) == nullptr, "s.try_at(3)");
+   verify(static_cast<const array<short, 5>&>(p).try_at(5) == nullptr,
+          "const p.try_at(5)");
+
    verify(s.front() == 8, "s.front()");
    verify(s.front() != -2, "s.front() != -2");
    verify(s.back() == 7, "s.back()");
@@ -92,7 +267,7 @@ void runTests()
 
    //iterator on empty array: the loop body should not execute
    iteratorTest = true;
-   for (const auto e : c)
+   for ([[maybe_unused]] const auto e : c)
       iteratorTest = false;
    verify(iteratorTest, "fwd iterator on empty array");
 
@@ -121,4 +296,133 @@ void runTests()
    for (std::size_t idx = 0; idx < m.size() && swapTest; ++idx)
       swapTest = m[idx] == mExpected[idx] && n[idx] == nExpected[idx];
    verify(swapTest, "m.swap(n)");
+
+
+   //fill and swap take byte-wise paths for trivially-copyable elements
+   //-use sizes that are not a multiple of the swap block
+   array<std::uint8_t, 4100> bytes1;
+   array<std::uint8_t, 4100> bytes2;
+   bytes1.fill(0xA5);
+   bytes2.fill(0x5A);
+   bytes1[4099] = 1;
+   bytes1.swap(bytes2);
+
+   fillTest = std::all_of(bytes1.begin(), bytes1.end(),
+                          [](std::uint8_t b) { return b == 0x5A; });
+   verify(fillTest, "bytes1.fill(), bytes1.swap(bytes2)");
+
+   swapTest = bytes2[0] == 0xA5 && bytes2[4098] == 0xA5 && bytes2[4099] == 1;
+   verify(swapTest, "bytes2 after bytes1.swap(bytes2)");
+
+   array<float, 1030> f1;
+   array<float, 1030> f2;
+   for (std::size_t idx = 0; idx < f1.size(); ++idx)
+   {
+      f1[idx] = static_cast<float>(idx);
+      f2[idx] = -static_cast<float>(idx);
+   }
+   f1.swap(f2);
+
+   swapTest = true;
+   for (std::size_t idx = 0; idx < f1.size() && swapTest; ++idx)
+      swapTest = f1[idx] == -static_cast<float>(idx) &&
+                 f2[idx] == static_cast<float>(idx);
+   verify(swapTest, "f1.swap(f2)");
+
+   //self-swap leaves the array unchanged
+   f2.swap(f2);
+   verify(f2[1029] == 1029.0f, "f2.swap(f2)");
+
+   //non-trivial elements are still swapped element-wise
+   array<std::string, 2> t1{ "alpha", "beta" };
+   array<std::string, 2> t2{ "gamma", "delta" };
+   t1.swap(t2);
+   swapTest = t1[0] == "gamma" && t1[1] == "delta" && t2[0] == "alpha";
+   verify(swapTest, "t1.swap(t2)");
+
+   t1.fill("epsilon");
+   verify(t1[0] == "epsilon" && t1[1] == "epsilon", "t1.fill()");
+
+   //fill assigns from an element of the same array
+   array<std::string, 3> t3{ "zeta", "eta", "theta" };
+   t3.fill(t3[1]);
+   verify(t3[0] == "eta" && t3[1] == "eta" && t3[2] == "eta", "t3.fill(t3[1])");
+
+   //fill needs only copy assignment, as std::array::fill does
+   struct assign_only
+   {
+      int v;
+      assign_only() : v(0) {}
+      assign_only(const assign_only&) = delete;
+      assign_only& operator=(const assign_only& o) { v = o.v; return *this; }
+   };
+   array<assign_only, 3> ao;
+   assign_only seven;
+   seven.v = 7;
+   ao.fill(seven);
+   verify(ao[0].v == 7 && ao[2].v == 7, "fill without copy construction");
+
+   //structured bindings refer to the elements
+   array<std::string, 2> pair{ "key", "value" };
+   auto& [key, value] = pair;
+   value = "changed";
+   verify(key == "key" && pair[1] == "changed", "structured bindings");
+
+   std::string moved = sigcpp::get<0>(std::move(pair));
+   verify(moved == "key", "get<I> from an rvalue array");
+
+   //comparison: byte-wise at run time for unique object representations
+   array<std::uint8_t, 32> h1{}, h2{};
+   h1.fill(0x80);
+   h2.fill(0x80);
+   verify(h1 == h2 && !(h1 < h2) && h1 <= h2, "byte arrays equal");
+   h2[31] = 0x81;
+   verify(h1 != h2 && h1 < h2 && h2 > h1 && !(h1 >= h2), "byte arrays ordered");
+   h1[0] = 0xFF;
+   verify(h2 < h1, "byte arrays ordered as unsigned");
+
+   array<std::int32_t, 3> i1{ -1, 0, 5 }, i2{ 1, 0, 5 };
+   verify(i1 < i2 && i1 != i2, "signed elements are ordered as values");
+
+   //floating-point equality is not byte equality
+   array<float, 2> z1{ 0.0f, 1.0f }, z2{ -0.0f, 1.0f };
+   verify(z1 == z2, "0.0 == -0.0");
+
+   //a user-defined operator== is used even if elements have no padding
+   struct id
+   {
+      int key;
+      int version;
+      bool operator==(const id& o) const { return key == o.key; }
+   };
+   array<id, 2> id1{ { { 1, 1 }, { 2, 1 } } }, id2{ { { 1, 2 }, { 2, 3 } } };
+   verify(id1 == id2 && !(id1 != id2), "custom operator== elements compared");
+
+   array<array<int, 2>, 2> n1{ { { 1, 2 }, { 3, 4 } } }, n2 = n1;
+   verify(n1 == n2, "nested arrays equal");
+   n2[1][1] = 5;
+   verify(n1 != n2, "nested arrays not equal");
+
+   array<std::string, 2> s1{ "a", "b" }, s2{ "a", "c" };
+   verify(s1 < s2 && s1 != s2 && s2 == array<std::string, 2>{ "a", "c" },
+          "std::string elements compared");
+
+#if defined(__cpp_lib_three_way_comparison)
+   verify((h2 <=> h1) < 0 && (h1 <=> h1) == 0 && (s1 <=> s2) < 0, "operator<=>");
+#endif
+
+   //to_array moves the elements of an rvalue array
+   std::string names[] = { std::string(40, 'a'), std::string(40, 'b') };
+   const char* buffer = names[1].data();
+   auto movedNames = sigcpp::to_array(std::move(names));
+   verify(movedNames[1].data() == buffer && movedNames[0] == std::string(40, 'a'),
+          "to_array(rvalue) moves elements");
+
+   auto copiedNames = sigcpp::to_array(movedNames.values);
+   verify(copiedNames[1] == movedNames[1] && copiedNames[1].data() != buffer,
+          "to_array(lvalue) copies elements");
+
+#if SIGCPP_ITERATOR_DEBUG
+   testCheckedIterators();
+#endif
 }
\ No newline at end of file
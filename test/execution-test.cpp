@@ -0,0 +1,112 @@
+/*
+* execution-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test parallel algorithms on array
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+
+#include "../include/execution.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+namespace execution = sigcpp::execution;
+
+//chunks are whole cache lines
+static_assert(sigcpp::_chunk_size<double>(1 << 20) % 8 == 0);
+static_assert(sigcpp::_chunk_size<char>(100) % 64 == 0);
+static_assert((std::size_t(1 << 20) + sigcpp::_chunk_size<double>(1 << 20) - 1) /
+              sigcpp::_chunk_size<double>(1 << 20) <= sigcpp::parallel_max_chunks);
+
+//run every algorithm with policy p on arrays of size N and compare with std
+template<std::size_t N, typename Policy>
+static void testPolicy(const Policy& p, const char* name)
+{
+   std::string suffix = std::string(": ") + name + " N=" + std::to_string(N);
+
+   //heap allocate: the larger sizes do not fit comfortably on the stack
+   auto a = std::make_unique<array<std::int64_t, N>>();
+   auto b = std::make_unique<array<std::int64_t, N>>();
+
+   sigcpp::fill(p, *a, std::int64_t(3));
+   verify(std::all_of(a->begin(), a->end(), [](auto v) { return v == 3; }),
+          ("fill" + suffix).c_str());
+
+   sigcpp::fill(p, a->begin(), a->end(), 2);
+   verify(std::all_of(a->begin(), a->end(), [](auto v) { return v == 2; }),
+          ("fill range" + suffix).c_str());
+
+   std::iota(a->begin(), a->end(), std::int64_t(0));
+   sigcpp::for_each(p, *a, [](std::int64_t& v) { v *= 2; });
+   verify((*a)[N - 1] == 2 * std::int64_t(N - 1), ("for_each" + suffix).c_str());
+
+   sigcpp::for_each(p, a->begin(), a->end(), [](std::int64_t& v) { v /= 2; });
+   verify((*a)[N - 1] == std::int64_t(N - 1), ("for_each range" + suffix).c_str());
+
+   sigcpp::transform(p, *a, *b, [](std::int64_t v) { return v + 1; });
+   verify((*b)[0] == 1 && (*b)[N - 1] == std::int64_t(N), ("transform" + suffix).c_str());
+
+   sigcpp::transform(p, *a, *b, *b, std::plus<>());
+   verify((*b)[N - 1] == 2 * std::int64_t(N) - 1, ("binary transform" + suffix).c_str());
+
+   auto end = sigcpp::transform(p, a->cbegin(), a->cend(), b->begin(),
+                                [](std::int64_t v) { return -v; });
+   verify(end == b->end() && (*b)[N - 1] == -std::int64_t(N - 1),
+          ("transform range" + suffix).c_str());
+
+   const std::int64_t sum = std::int64_t(N) * std::int64_t(N - 1) / 2;
+   verify(sigcpp::reduce(p, *a, std::int64_t(5)) == sum + 5, ("reduce" + suffix).c_str());
+   verify(sigcpp::reduce(p, a->begin(), a->end(), std::int64_t(0)) == sum,
+          ("reduce range" + suffix).c_str());
+   verify(sigcpp::reduce(p, *a, std::int64_t(0),
+                         [](std::int64_t x, std::int64_t y) { return std::max(x, y); }) ==
+          std::int64_t(N - 1), ("reduce with op" + suffix).c_str());
+
+   //reverse, then sort: descending order is the worst case for merges
+   std::reverse(a->begin(), a->end());
+   sigcpp::sort(p, *a);
+   verify(std::is_sorted(a->begin(), a->end()) && (*a)[0] == 0,
+          ("sort" + suffix).c_str());
+
+   for (std::size_t i = 0; i < N; ++i)
+      (*a)[i] = std::int64_t((i * 7919) % N);
+   sigcpp::sort(p, a->begin(), a->end(), std::greater<>());
+   verify(std::is_sorted(a->begin(), a->end(), std::greater<>()),
+          ("sort range" + suffix).c_str());
+}
+
+template<std::size_t N>
+static void testPolicies()
+{
+   testPolicy<N>(execution::seq, "seq");
+   testPolicy<N>(execution::par, "par");
+   testPolicy<N>(execution::par_unseq, "par_unseq");
+}
+
+TEST_CASE(execution)
+{
+   testPolicies<1>();
+   testPolicies<100>();
+
+   //above the parallel threshold: 8 KiB chunks of int64, many chunks
+   testPolicies<(1 << 16) + 3>();
+   testPolicies<1 << 20>();
+
+   //aligned arrays convert to array
+   sigcpp::aligned_array<float, 1 << 16, sigcpp::cache_line_size> f{};
+   sigcpp::fill(execution::par, f, 1.0f);
+   verify(sigcpp::reduce(execution::par, f, 0.0f) == float(1 << 16), "aligned_array");
+}
@@ -0,0 +1,149 @@
+/*
+* flat_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test flat_map
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../include/flat_map.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::flat_map;
+using sigcpp::static_vector;
+
+enum class color { red, green, blue, cyan };
+
+//value whose construction throws for negative values
+struct positive
+{
+   int value;
+   positive(int v) : value(v)
+   {
+      if (v < 0)
+         throw std::invalid_argument("negative");
+   }
+};
+
+//an enum-to-string table built at compile time
+constexpr auto names = sigcpp::make_flat_map(array<std::pair<color, std::string_view>, 4>{ {
+   { color::cyan, "cyan" }, { color::red, "red" }, { color::blue, "blue" },
+   { color::green, "green" } } });
+
+static_assert(names.at(color::blue) == "blue" && names.begin()->first == color::red);
+
+constexpr auto codes = sigcpp::make_flat_map<sigcpp::eytzinger_layout>(
+   array<std::pair<int, char>, 5>{ { { 404, 'n' }, { 200, 'o' }, { 500, 'e' },
+   { 301, 'm' }, { 418, 't' } } });
+
+static_assert(codes.at(418) == 't' && codes.find(100) == codes.end());
+
+TEST_CASE(flat_map)
+{
+   //immutable maps
+   verify(names.size() == 4 && names.find(color::green)->second == "green", "find");
+   verify(std::is_sorted(names.keys().begin(), names.keys().end()), "keys sorted");
+
+   bool missing = false;
+   try
+   {
+      codes.at(201);
+   }
+   catch (const std::out_of_range&)
+   {
+      missing = true;
+   }
+   verify(missing, "at throws out_of_range");
+
+   int count = 0;
+   for (auto e : codes)
+      count += codes.at(e.first) == e.second;
+   verify(count == 5, "iteration over Eytzinger layout");
+
+   auto table = sigcpp::make_flat_map(array<std::pair<int, int>, 3>{ { { 3, 30 }, { 1, 10 },
+      { 2, 20 } } });
+   table.at(2) = 21;
+   table.find(3)->second += 1;
+   verify(table.values() == array<int, 3>{ 10, 21, 31 }, "values are modifiable");
+
+   verify(table.lower_bound(2)->first == 2 && table.upper_bound(2)->first == 3 &&
+          table.equal_range(4).first == table.end(), "ordered lookup");
+
+   bool duplicate = false;
+   try
+   {
+      sigcpp::make_flat_map(array<std::pair<int, int>, 2>{ { { 1, 1 }, { 1, 2 } } });
+   }
+   catch (const std::invalid_argument&)
+   {
+      duplicate = true;
+   }
+   verify(duplicate, "duplicate keys in array throw");
+
+   //mutable maps
+   using routes_t = flat_map<std::string, int, static_vector<std::string, 4>,
+      static_vector<int, 4>>;
+   routes_t routes{ { "b", 2 }, { "a", 1 }, { "b", 3 } };
+   verify(routes.size() == 2 && routes.at("b") == 2, "initializer list keeps first key");
+
+   routes["c"] = 3;
+   verify(routes.at("c") == 3 && routes.keys()[2] == "c", "operator[] inserts");
+
+   verify(!routes.try_emplace("a", 9).second && routes.at("a") == 1, "try_emplace");
+   routes.insert_or_assign("a", 9);
+   verify(routes.at("a") == 9, "insert_or_assign");
+
+   routes["d"];
+   bool full = false;
+   try
+   {
+      routes["e"] = 5;
+   }
+   catch (const std::length_error&)
+   {
+      full = true;
+   }
+   verify(full && routes.size() == 4, "full map throws length_error");
+
+   flat_map<int, positive, static_vector<int, 4>, static_vector<positive, 4>> checked;
+   checked.try_emplace(2, 20);
+   bool thrown = false;
+   try
+   {
+      checked.try_emplace(1, -1);
+   }
+   catch (const std::invalid_argument&)
+   {
+      thrown = true;
+   }
+   verify(thrown && checked.keys().size() == 1 && checked.values().size() == 1 &&
+          checked.try_emplace(1, 10).second && checked.at(1).value == 10,
+          "throwing value leaves keys and values in step");
+
+   verify(routes.erase("b") == 1 && !routes.contains("b") && routes.values()[1] == 3,
+          "erase keeps keys and values in step");
+
+   auto next = routes.erase(routes.begin());
+   verify(next->first == "c" && routes.size() == 2, "erase at iterator");
+
+   routes_t copy = routes;
+   verify(copy == routes, "compare");
+   copy.clear();
+   verify(copy.empty() && copy != routes, "clear");
+
+   static_vector<int, 3> ks{ 3, 1, 3 }, vs{ 30, 10, 31 };
+   flat_map<int, int, static_vector<int, 3>, static_vector<int, 3>> fromRaw(ks, vs);
+   verify(fromRaw.size() == 2 && fromRaw.at(3) == 30, "containers keep first key");
+}
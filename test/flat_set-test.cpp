@@ -0,0 +1,129 @@
+/*
+* flat_set-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test flat_set and the searches in search.h
+*/
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "../include/flat_set.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::flat_set;
+using sigcpp::static_vector;
+
+//sorted 0, 2, 4, ...: a lower bound of every value 0..2N, found or not
+template<std::size_t N>
+static bool searches_agree()
+{
+   array<int, N> sorted{};
+   for (std::size_t i = 0; i < N; ++i)
+      sorted[i] = static_cast<int>(2 * i);
+   const array<int, N> e = sigcpp::to_eytzinger(sorted);
+
+   bool agree = true;
+   for (int x = -1; x <= static_cast<int>(2 * N); ++x)
+   {
+      const std::size_t expected = static_cast<std::size_t>(
+         std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+
+      const int* b = sigcpp::branchless_lower_bound(sorted.data(), N, x, std::less<>());
+      agree = static_cast<std::size_t>(b - sorted.data()) == expected && agree;
+
+      const std::size_t k = sigcpp::eytzinger_lower_bound(e.data(), N, x, std::less<>());
+      agree = (k == N ? expected == N : e[k] == sorted[expected]) && agree;
+   }
+   return agree;
+}
+
+template<std::size_t... N>
+static bool searches_agree(std::index_sequence<N...>)
+{
+   return (searches_agree<N>() && ...);
+}
+
+//compile-time tables
+constexpr auto primes = sigcpp::make_flat_set(array<int, 8>{ 19, 2, 13, 5, 17, 3, 11, 7 });
+static_assert(primes.contains(13) && !primes.contains(9) && *primes.begin() == 2);
+static_assert(*primes.lower_bound(8) == 11 && *primes.upper_bound(11) == 13);
+
+constexpr auto eprimes = sigcpp::make_flat_set<sigcpp::eytzinger_layout>(
+   array<int, 8>{ 19, 2, 13, 5, 17, 3, 11, 7 });
+static_assert(eprimes.contains(19) && !eprimes.contains(1) && eprimes.find(4) == eprimes.end());
+
+//the Eytzinger order of 1..7: root 4, then 2, 6, then the leaves
+static_assert(sigcpp::eytzinger_order<7> == array<std::size_t, 7>{ 3, 1, 5, 0, 2, 4, 6 });
+
+TEST_CASE(flat_set)
+{
+   verify(searches_agree(std::make_index_sequence<40>()) && searches_agree<100>() &&
+          searches_agree<1000>(), "branchless and Eytzinger lower bounds");
+
+   //immutable sets
+   verify(primes.size() == 8 && std::is_sorted(primes.begin(), primes.end()),
+          "array storage is sorted");
+
+   const auto [first, last] = primes.equal_range(7);
+   verify(last - first == 1 && *first == 7, "equal_range");
+
+   bool duplicate = false;
+   try
+   {
+      sigcpp::make_flat_set(array<int, 3>{ 1, 2, 1 });
+   }
+   catch (const std::invalid_argument&)
+   {
+      duplicate = true;
+   }
+   verify(duplicate, "duplicate keys in array throw");
+
+   flat_set<int, array<int, 3>, std::greater<int>> descending(array<int, 3>{ 1, 3, 2 });
+   verify(*descending.begin() == 3 && descending.contains(1), "comparator");
+
+   //mutable sets
+   flat_set<std::string, static_vector<std::string, 8>> words{ "pear", "fig", "apple", "fig" };
+   verify(words.size() == 3 && *words.begin() == "apple", "initializer list drops duplicates");
+
+   verify(words.insert("kiwi").second && !words.insert("pear").second, "insert");
+   verify(std::is_sorted(words.begin(), words.end()), "insert keeps order");
+
+   verify(words.erase("fig") == 1 && words.erase("fig") == 0 && !words.contains("fig"),
+          "erase");
+
+   words.erase(words.begin());
+   verify(*words.begin() == "kiwi" && words.size() == 2, "erase at iterator");
+
+   static_vector<int, 4> raw{ 4, 1, 4, 2 };
+   flat_set<int, static_vector<int, 4>> fromRaw(raw);
+   verify(fromRaw.size() == 3 && fromRaw.keys()[2] == 4, "container drops duplicates");
+
+   verify(fromRaw.insert(0).second && fromRaw.size() == 4, "insert to capacity");
+
+   bool full = false;
+   try
+   {
+      fromRaw.insert(9);
+   }
+   catch (const std::length_error&)
+   {
+      full = true;
+   }
+   verify(full, "full set throws length_error");
+
+   flat_set<int, static_vector<int, 4>> copy = fromRaw;
+   verify(copy == fromRaw, "compare");
+   copy.clear();
+   verify(copy.empty() && copy != fromRaw, "clear");
+}
@@ -0,0 +1,147 @@
+/*
+* hash-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test hashing of arrays
+*/
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../include/hash.h"
+#include "../include/bit.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+
+//types hashed only through the customization point
+struct point
+{
+   int x, y;
+
+   friend bool operator==(const point& a, const point& b)
+   {
+      return a.x == b.x && a.y == b.y;
+   }
+};
+
+template<>
+struct sigcpp::hash<point>
+{
+   std::size_t operator()(const point& p) const noexcept
+   {
+      return static_cast<std::size_t>(sigcpp::hash_bytes<sizeof(int)>(&p.x) ^
+                                      sigcpp::hash_bytes<sizeof(int)>(&p.y, 7));
+   }
+};
+
+//identity is the key alone: the version is not hashed
+struct id
+{
+   int key;
+   int version;
+
+   friend bool operator==(const id& a, const id& b) { return a.key == b.key; }
+};
+
+template<>
+struct sigcpp::hash<id>
+{
+   std::size_t operator()(const id& i) const noexcept
+   {
+      return static_cast<std::size_t>(sigcpp::hash_bytes<sizeof(int)>(&i.key));
+   }
+};
+
+//flipping any one input bit changes about half of the output bits
+template<std::size_t N>
+static bool avalanches()
+{
+   array<std::uint8_t, N> a{};
+   const std::uint64_t h = std::hash<array<std::uint8_t, N>>()(a);
+
+   unsigned total = 0, least = 64;
+   for (std::size_t bit = 0; bit < N * 8; ++bit)
+   {
+      array<std::uint8_t, N> b = a;
+      b[bit / 8] ^= static_cast<std::uint8_t>(1u << (bit % 8));
+      const unsigned changed = sigcpp::popcount(
+         static_cast<std::uint64_t>(h ^ std::hash<array<std::uint8_t, N>>()(b)));
+      total += changed;
+      least = changed < least ? changed : least;
+   }
+
+   const unsigned mean = total / static_cast<unsigned>(N * 8);
+   return 24 <= mean && mean <= 40 && least >= 12;
+}
+
+TEST_CASE(hash)
+{
+   //equal arrays hash equally; the compile-time length agrees with run time
+   array<std::uint8_t, 20> d1{}, d2{};
+   d1.fill(7);
+   d2.fill(7);
+   std::hash<array<std::uint8_t, 20>> h20;
+   verify(h20(d1) == h20(d2), "equal arrays, equal hashes");
+   verify(sigcpp::hash_bytes<20>(d1.data()) == sigcpp::hash_bytes(d1.data(), 20),
+          "compile-time and run-time lengths agree");
+
+   //every length takes a different path through the hash
+   bool lengths = true;
+   std::unordered_set<std::uint64_t> seen;
+   unsigned char bytes[128] = {};
+   for (std::size_t len = 0; len <= 128; ++len)
+      lengths = seen.insert(sigcpp::hash_bytes(bytes, len)).second && lengths;
+   verify(lengths, "lengths 0..128 hash differently");
+
+   verify(sigcpp::hash_bytes(bytes, 16, 1) != sigcpp::hash_bytes(bytes, 16, 2),
+          "seed changes the hash");
+
+   verify(avalanches<3>() && avalanches<20>() && avalanches<32>() && avalanches<100>(),
+          "avalanche");
+
+   //digests as unordered_map keys
+   std::unordered_map<array<std::uint64_t, 4>, int> cache;
+   for (std::uint64_t i = 0; i < 1000; ++i)
+      cache[array<std::uint64_t, 4>{ i, i * 3, 0, 1 }] = static_cast<int>(i);
+   verify(cache.size() == 1000 && cache.at(array<std::uint64_t, 4>{ 5, 15, 0, 1 }) == 5,
+          "unordered_map keyed by array");
+
+   //elements without unique representations go through their own hash
+   std::hash<array<float, 2>> hf;
+   verify(hf(array<float, 2>{ 0.0f, 1.0f }) == hf(array<float, 2>{ -0.0f, 1.0f }),
+          "0.0 and -0.0 hash equally");
+
+   std::hash<array<std::string, 2>> hs;
+   verify(hs(array<std::string, 2>{ "a", "bc" }) != hs(array<std::string, 2>{ "ab", "c" }),
+          "std::string elements");
+
+   std::hash<array<point, 2>> hp;
+   array<point, 2> p1{ { { 1, 2 }, { 3, 4 } } }, p2 = p1;
+   verify(hp(p1) == hp(p2), "customization point");
+
+   std::unordered_set<array<point, 2>> points{ p1, { { { 3, 4 }, { 1, 2 } } } };
+   verify(points.size() == 2 && points.count(p2) == 1, "unordered_set keyed by points");
+
+   //the hash agrees with the element operator==, not with element bytes
+   std::hash<array<id, 2>> hi;
+   array<id, 2> i1{ { { 1, 1 }, { 2, 1 } } }, i2{ { { 1, 2 }, { 2, 3 } } };
+   verify(i1 == i2 && hi(i1) == hi(i2), "equal arrays of custom elements hash equally");
+
+   //aligned arrays hash as their base array
+   sigcpp::aligned_array<int, 4, 16> v{ 1, 2, 3, 4 };
+   verify(std::hash<decltype(v)>()(v) == std::hash<array<int, 4>>()(v), "aligned_array");
+
+   array<int, 0> none{};
+   verify(std::hash<array<int, 0>>()(none) == std::hash<array<int, 0>>()(none),
+          "zero-size array");
+}
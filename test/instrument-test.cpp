@@ -0,0 +1,102 @@
+/*
+* instrument-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test access instrumentation: build with SIGCPP_INSTRUMENT=1 to test
+* recording, else this tests that instrumentation compiles away
+*/
+
+#include <cstddef>
+#include <cstdio>
+
+#include "../include/array.h"
+#include "../include/instrument.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::access_stats;
+
+#if !SIGCPP_ITERATOR_DEBUG && !SIGCPP_INSTRUMENT
+static_assert(sizeof(array<int, 4>::iterator) == sizeof(int*));
+#endif
+
+//constant evaluation is never recorded
+constexpr int sum_constexpr()
+{
+   array<int, 3> a{ 1, 2, 3 };
+   int sum = 0;
+   for (auto it = a.begin(); it != a.end(); ++it)
+      sum += *it;
+   return sum + a[0] + a.at(1);
+}
+
+static_assert(sum_constexpr() == 9);
+
+TEST_CASE(instrument)
+{
+   sigcpp::instrument_reset();
+
+   array<int, 64> a{};
+   for (std::size_t i = 0; i < a.size(); ++i)
+      a[i] = static_cast<int>(i);
+
+   const access_stats forward = sigcpp::instrument_stats(a.data());
+
+#if SIGCPP_INSTRUMENT
+   verify(forward.indexed == 64 && forward.element_size == sizeof(int) && forward.size == 64,
+      "operator[] counted");
+   verify(forward.strides[1] == 63 && forward.backward == 0 && forward.out_of_order_ratio() == 0,
+      "sequential strides");
+   verify(forward.heat[0] == 2 && forward.heat[31] == 2, "heat map");
+
+   //backward through iterators
+   int sum = 0;
+   for (auto it = a.end(); it != a.begin();)
+      sum += *--it;
+   const access_stats backward = sigcpp::instrument_stats(a.data());
+   verify(sum == 63 * 64 / 2 && backward.derefs == 64 && backward.moves == 64,
+      "iterator derefs and moves");
+   verify(backward.backward == 63 && backward.strides[0] == 1,
+      "backward accesses out of order");
+
+   //strided, checked
+   for (std::size_t i = 0; i < a.size(); i += 16)
+      sum += a.at(i);
+   const access_stats strided = sigcpp::instrument_stats(a.data());
+   verify(strided.checked == 4 && strided.strides[5] == 3 && strided.accesses() == 132,
+      "strided checked accesses");
+   verify(strided.out_of_order_ratio() > 0.48 && strided.out_of_order_ratio() < 0.49,
+      "out of order ratio");
+
+   //stats per range
+   const array<double, 8> other{};
+   const double d = other[7];
+   verify(d == 0 && sigcpp::instrument_stats(other.data()).indexed == 1 &&
+      sigcpp::instrument_stats(a.data()).indexed == 64, "stats per range");
+
+   //a span or static_vector iterator is keyed by its first element
+   array<int, 64>::const_iterator mid(a.data() + 32, a.data() + 32, a.data() + 64);
+   sum += *mid;
+   verify(sigcpp::instrument_stats(a.data() + 32).derefs == 1, "subrange keyed by first");
+
+   std::FILE* sink = std::tmpfile();
+   if (sink != nullptr)
+   {
+      sigcpp::instrument_report(sink);
+      verify(std::ftell(sink) > 0, "report written");
+      std::fclose(sink);
+   }
+
+   sigcpp::instrument_reset();
+   verify(sigcpp::instrument_stats(a.data()).accesses() == 0, "reset");
+#else
+   verify(forward.accesses() == 0 && forward.moves == 0, "nothing recorded when disabled");
+#endif
+}
@@ -0,0 +1,214 @@
+/*
+* linalg-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test small vector and matrix operations
+*/
+
+#include <cstddef>
+#include <cmath>
+#include <stdexcept>
+
+#include "../include/linalg.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::basic_mdarray;
+using sigcpp::layout_left;
+using sigcpp::mdarray;
+
+//constant evaluation takes the scalar paths
+constexpr array<int, 3> u{ 1, 2, 3 }, v{ 4, 5, 6 };
+static_assert(sigcpp::dot(u, v) == 32);
+
+constexpr mdarray<int, 2, 3> a23{ 1, 2, 3, 4, 5, 6 };
+constexpr mdarray<int, 3, 2> b32{ 7, 8, 9, 10, 11, 12 };
+constexpr auto c22 = sigcpp::matmul(a23, b32);
+static_assert(c22(0, 0) == 58 && c22(0, 1) == 64 && c22(1, 0) == 139 && c22(1, 1) == 154);
+static_assert(sigcpp::transpose(a23)(2, 1) == 6 && sigcpp::matvec(a23, u)[1] == 32);
+static_assert(sigcpp::determinant(mdarray<int, 3, 3>{ 2, 0, 1, 1, 3, 2, 1, 1, 2 }) == 6);
+static_assert(sigcpp::identity<int, 3>()(1, 1) == 1 && sigcpp::identity<int, 3>()(1, 2) == 0);
+
+namespace
+{
+   //integer-valued elements: products and sums are exact in float
+   template<typename M>
+   void fill_pattern(M& m, int seed)
+   {
+      for (std::size_t i = 0; i < m.size(); ++i)
+      {
+         const int e = (seed + 7 * static_cast<int>(i)) % 11 - 5;
+         m.values[i] = static_cast<typename M::value_type>(e);
+      }
+   }
+
+   template<typename T, typename L, std::size_t R, std::size_t K, std::size_t C>
+   basic_mdarray<T, L, R, C> naive_matmul(const basic_mdarray<T, L, R, K>& a,
+      const basic_mdarray<T, L, K, C>& b)
+   {
+      basic_mdarray<T, L, R, C> c{};
+      for (std::size_t i = 0; i < R; ++i)
+         for (std::size_t j = 0; j < C; ++j)
+            for (std::size_t k = 0; k < K; ++k)
+               c(i, j) += a(i, k) * b(k, j);
+      return c;
+   }
+
+   template<typename T, typename L, std::size_t N>
+   bool near_identity(const basic_mdarray<T, L, N, N>& m, T tolerance)
+   {
+      for (std::size_t i = 0; i < N; ++i)
+         for (std::size_t j = 0; j < N; ++j)
+            if (std::abs(m(i, j) - (i == j ? T(1) : T(0))) > tolerance)
+               return false;
+      return true;
+   }
+
+   template<typename T, typename L, std::size_t N>
+   bool inverts(const basic_mdarray<T, L, N, N>& m, T tolerance)
+   {
+      const auto inv = sigcpp::inverse(m);
+      return near_identity(sigcpp::matmul(m, inv), tolerance) &&
+         near_identity(sigcpp::matmul(inv, m), tolerance);
+   }
+}
+
+TEST_CASE(linalg)
+{
+   //dot and axpy over whole registers and tails
+   array<float, 19> x{}, y{};
+   float expected = 0;
+   for (std::size_t i = 0; i < x.size(); ++i)
+   {
+      x[i] = static_cast<float>(i);
+      y[i] = static_cast<float>(2 * i + 1);
+      expected += x[i] * y[i];
+   }
+   verify(sigcpp::dot(x, y) == expected, "dot float");
+
+   sigcpp::axpy(2.0f, x, y);
+   bool axpyOk = true;
+   for (std::size_t i = 0; i < y.size(); ++i)
+      axpyOk = y[i] == static_cast<float>(4 * i + 1) && axpyOk;
+   verify(axpyOk, "axpy float");
+
+   array<double, 3> d{ 2, 3, 6 };
+   verify(sigcpp::norm(d) == 7 && sigcpp::dot(d, d) == 49, "norm double");
+   verify(sigcpp::norm(array<float, 4>{ 1, 1, 1, 1 }) == 2, "norm float");
+
+   //4x4 products on the vector path agree with a plain triple loop
+   mdarray<float, 4, 4> a{}, b{};
+   fill_pattern(a, 1);
+   fill_pattern(b, 4);
+   verify(sigcpp::matmul(a, b) == naive_matmul(a, b), "matmul 4x4 float");
+   verify(sigcpp::matmul(a, sigcpp::identity<float, 4>()) == a, "matmul identity");
+
+   mdarray<double, 4, 4> ad{}, bd{};
+   fill_pattern(ad, 2);
+   fill_pattern(bd, 9);
+   verify(sigcpp::matmul(ad, bd) == naive_matmul(ad, bd), "matmul 4x4 double");
+
+   mdarray<float, 3, 3> a3{};
+   fill_pattern(a3, 3);
+   verify(sigcpp::matmul(a3, a3) == naive_matmul(a3, a3), "matmul 3x3");
+
+   mdarray<float, 3, 8> a38{};
+   mdarray<float, 8, 8> b88{};
+   fill_pattern(a38, 5);
+   fill_pattern(b88, 6);
+   verify(sigcpp::matmul(a38, b88) == naive_matmul(a38, b88), "matmul 3x8 8x8");
+
+   //rows of 2 doubles and 4 floats use 128-bit registers where the native
+   //register is wider
+   mdarray<double, 2, 2> a2{}, b2{};
+   fill_pattern(a2, 7);
+   fill_pattern(b2, 8);
+   verify(sigcpp::matmul(a2, b2) == naive_matmul(a2, b2), "matmul 2x2 double");
+
+   mdarray<float, 2, 4> a24{};
+   fill_pattern(a24, 10);
+   verify(sigcpp::matmul(a24, b) == naive_matmul(a24, b), "matmul 2x4 4x4");
+
+   //row-major matvec over rows of several registers
+   mdarray<float, 3, 16> m316{};
+   array<float, 16> x16{};
+   fill_pattern(m316, 2);
+   fill_pattern(x16, 3);
+   const array<float, 3> y3 = sigcpp::matvec(m316, x16);
+   bool matvecRows = true;
+   for (std::size_t i = 0; i < 3; ++i)
+   {
+      float yi = 0;
+      for (std::size_t j = 0; j < 16; ++j)
+         yi += m316(i, j) * x16[j];
+      matvecRows = y3[i] == yi && matvecRows;
+   }
+   verify(matvecRows, "matvec 3x16");
+
+   //column major: the same logical product
+   basic_mdarray<float, layout_left, 4, 4> al{}, bl{};
+   for (std::size_t i = 0; i < 4; ++i)
+      for (std::size_t j = 0; j < 4; ++j)
+      {
+         al(i, j) = a(i, j);
+         bl(i, j) = b(i, j);
+      }
+
+   const auto cl = sigcpp::matmul(al, bl);
+   const auto cr = sigcpp::matmul(a, b);
+   bool sameProduct = true;
+   for (std::size_t i = 0; i < 4; ++i)
+      for (std::size_t j = 0; j < 4; ++j)
+         sameProduct = cl(i, j) == cr(i, j) && sameProduct;
+   verify(sameProduct, "matmul layout_left");
+
+   const array<float, 4> p{ 1, -2, 3, 1 };
+   verify(sigcpp::matvec(al, p) == sigcpp::matvec(a, p), "matvec layouts agree");
+   const array<float, 4> ap = sigcpp::matvec(a, p);
+   verify(ap[0] == a(0, 0) - 2 * a(0, 1) + 3 * a(0, 2) + a(0, 3), "matvec");
+
+   //transpose
+   const auto at = sigcpp::transpose(a38);
+   verify(at.extent(0) == 8 && at(5, 2) == a38(2, 5), "transpose");
+   verify(sigcpp::transpose(sigcpp::transpose(a)) == a, "transpose twice");
+
+   //inverses
+   verify(inverts(mdarray<double, 2, 2>{ 4, 7, 2, 6 }, 1e-12), "inverse 2x2");
+   verify(inverts(mdarray<double, 3, 3>{ 2, -1, 0, -1, 2, -1, 0, -1, 2 }, 1e-12), "inverse 3x3");
+   verify(inverts(mdarray<float, 4, 4>{ 1, 2, 0, 1, 0, 1, 3, 2, 4, 0, 1, 1, 2, 1, 1, 3 }, 1e-5f),
+      "inverse 4x4 float");
+   verify(inverts(basic_mdarray<double, layout_left, 4, 4>{ 3, 0, 2, -1, 1, 2, 0, -2, 4, 0, 6,
+      -3, 5, 0, 2, 0 }, 1e-12), "inverse 4x4 layout_left");
+
+   //a translation and its inverse
+   mdarray<float, 4, 4> t = sigcpp::identity<float, 4>();
+   t(0, 3) = 5;
+   t(1, 3) = -2;
+   const auto moved = sigcpp::matvec(t, p);
+   verify(moved == array<float, 4>{ 6, -4, 3, 1 }, "transform point");
+   verify(sigcpp::matvec(sigcpp::inverse(t), moved) == p, "inverse transform");
+   verify(sigcpp::determinant(t) == 1, "determinant 4x4");
+
+   const mdarray<double, 3, 3> singular{ 1, 2, 3, 2, 4, 6, 0, 1, 1 };
+   mdarray<double, 3, 3> unchanged = sigcpp::identity<double, 3>();
+   verify(!sigcpp::try_inverse(singular, unchanged) &&
+      unchanged == sigcpp::identity<double, 3>(), "try_inverse singular");
+
+   bool threw = false;
+   try
+   {
+      sigcpp::inverse(singular);
+   }
+   catch (const std::invalid_argument&)
+   {
+      threw = true;
+   }
+   verify(threw, "inverse singular throws");
+}
@@ -8,32 +8,184 @@
 * - Copyright notice cannot be altered
 * Attribution and copyright info may be relocated but they must be conspicuous.
 *
-* Intialize tester and start unit tests
+* Intialize tester from the command line and start unit tests
+* - options: --passes none|indicate|detail, --format text|tap|json,
+*   --fail-threshold N|max, --output stdout|stderr|FILE, --threads N,
+*   --shard I/N, --help
+* - an option's value follows it as the next argument or after '='
+* - exit status is 0 if all tests pass, 1 if any fail, 2 on bad usage
+* - with checked iterators, misuse is reported as std::logic_error so that
+*   tests can trap it; the handler is installed once, before cases start on
+*   several threads
 */
 
 #include <iostream>
+#include <fstream>
 #include <string>
-#include <array>
+#include <cstdlib>
+#include <climits>
+#include <stdexcept>
+
+#include "../include/array_iterator.h"
 
 #include "tester.h"
 
-//must be defined in a unit-specific source file such as "array-test.cpp"
-void runTests();
+#if SIGCPP_ITERATOR_DEBUG
+static void throwIteratorFailure(const char* msg)
+{
+   throw std::logic_error(msg);
+}
+#endif
+
+//tests to run: 0 threads is one per hardware thread
+struct runOptions
+{
+   unsigned threads{ 0 };
+   unsigned shardIndex{ 1 };
+   unsigned shardCount{ 1 };
+};
 
-int main()
+static void printUsage(const char* program)
 {
-   //TODO: configure the tester based on cmd-line
-   try
+   std::cerr << "usage: " << program << " [options]\n"
+      << "  --passes none|indicate|detail  report of passing tests (indicate)\n"
+      << "  --format text|tap|json         report format (text)\n"
+      << "  --fail-threshold N|max         failures allowed before stopping (0)\n"
+      << "  --output stdout|stderr|FILE    report destination (stdout)\n"
+      << "  --threads N                    threads to run tests on (0: all)\n"
+      << "  --shard I/N                    run part I of N of the tests (1/1)\n";
+}
+
+//parse a decimal number of at most max
+static bool parseNumber(const std::string& value, unsigned long max, unsigned long& n)
+{
+   char* end = nullptr;
+   n = std::strtoul(value.c_str(), &end, 10);
+   return !value.empty() && *end == '\0' && value[0] != '-' && n <= max;
+}
+
+//apply one option; false if the option or its value is not valid
+static bool applyOption(const std::string& option, const std::string& value,
+   std::ofstream& file, reportFormat& format, std::ostream*& out, runOptions& run)
+{
+   if (option == "--passes")
+   {
+      if (value == "none")
+         setPassReportMode(passReportMode::none);
+      else if (value == "indicate")
+         setPassReportMode(passReportMode::indicate);
+      else if (value == "detail")
+         setPassReportMode(passReportMode::detail);
+      else
+         return false;
+   }
+   else if (option == "--format")
+   {
+      if (value == "text")
+         format = reportFormat::text;
+      else if (value == "tap")
+         format = reportFormat::tap;
+      else if (value == "json")
+         format = reportFormat::json;
+      else
+         return false;
+      setReportFormat(format);
+   }
+   else if (option == "--fail-threshold")
+   {
+      if (value == "max")
+         setMaxFailThreshold();
+      else
+      {
+         unsigned long n;
+         if (!parseNumber(value, USHRT_MAX, n))
+            return false;
+         setFailThreshold(static_cast<unsigned short>(n));
+      }
+   }
+   else if (option == "--threads")
+   {
+      unsigned long n;
+      if (!parseNumber(value, UINT_MAX, n))
+         return false;
+      run.threads = static_cast<unsigned>(n);
+   }
+   else if (option == "--shard")
    {
-      std::cout << "Running tests:\n"; //TODO: conditionally print: which destination?
-      runTests();
+      const auto slash = value.find('/');
+      unsigned long index, count;
+      if (slash == std::string::npos || !parseNumber(value.substr(0, slash), UINT_MAX, index) ||
+         !parseNumber(value.substr(slash + 1), UINT_MAX, count) || index == 0 || index > count)
+         return false;
+      run.shardIndex = static_cast<unsigned>(index);
+      run.shardCount = static_cast<unsigned>(count);
    }
-   catch (const std::string& msg)
+   else if (option == "--output")
    {
-      std::cout << msg << '\n'; //TODO: print in appropriate stream based in cmd-line
+      if (value == "stdout")
+         out = &std::cout;
+      else if (value == "stderr")
+         out = &std::cerr;
+      else
+      {
+         file.open(value);
+         if (!file)
+         {
+            std::cerr << "cannot open " << value << '\n';
+            return false;
+         }
+         out = &file;
+      }
+      setOutputStream(*out);
    }
-   //TODO handle other exceptions
+   else
+      return false;
+
+   return true;
+}
+
+int main(int argc, char* argv[])
+{
+   std::ofstream file;
+   reportFormat format{ reportFormat::text };
+   std::ostream* out{ &std::cout };
+   runOptions run;
+
+   for (int i = 1; i < argc; ++i)
+   {
+      std::string option = argv[i];
+      if (option == "--help" || option == "-h")
+      {
+         printUsage(argv[0]);
+         return 0;
+      }
+
+      std::string value;
+      const auto equals = option.find('=');
+      if (equals != std::string::npos)
+      {
+         value = option.substr(equals + 1);
+         option.erase(equals);
+      }
+      else if (i + 1 < argc)
+         value = argv[++i];
+
+      if (!applyOption(option, value, file, format, out, run))
+      {
+         std::cerr << "invalid option: " << option << ' ' << value << '\n';
+         printUsage(argv[0]);
+         return 2;
+      }
+   }
+
+#if SIGCPP_ITERATOR_DEBUG
+   sigcpp::iterator_failure_handler = throwIteratorFailure;
+#endif
+
+   if (format == reportFormat::text)
+      *out << "Running tests:\n";
+   runRegisteredTests(run.threads, run.shardIndex, run.shardCount);
 
-   //TODO: conditionally print summary to appropriate destination
    summarizeTests();
-}
\ No newline at end of file
+   return failedTestCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*
+* mdarray-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test mdarray and its layouts
+*/
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "../include/mdarray.h"
+
+#include "tester.h"
+
+using sigcpp::basic_mdarray;
+using sigcpp::layout_left;
+using sigcpp::layout_right;
+using sigcpp::layout_tiled;
+using sigcpp::mdarray;
+
+//compile-time strides
+using image = mdarray<float, 4, 6>;
+static_assert(image::rank() == 2 && image::extent(1) == 6 && image::size() == 24);
+static_assert(image::stride(0) == 6 && image::stride(1) == 1 && image::offset(2, 3) == 15);
+
+using column_major = basic_mdarray<int, layout_left, 3, 4, 5>;
+static_assert(column_major::stride(0) == 1 && column_major::stride(1) == 3 &&
+   column_major::stride(2) == 12 && column_major::offset(1, 2, 3) == 1 + 6 + 36);
+
+//2x3 tiles of a 4x6 grid: tile (1, 1) starts at 4 * 6 = 24, its row 1 at 27
+using tiled = basic_mdarray<int, layout_tiled<2, 3>, 4, 6>;
+static_assert(!tiled::is_strided() && tiled::size() == 24);
+static_assert(tiled::offset(0, 0) == 0 && tiled::offset(0, 3) == 6 &&
+   tiled::offset(2, 0) == 12 && tiled::offset(3, 4) == 18 + 3 + 1);
+
+//aggregate, constexpr
+constexpr mdarray<int, 2, 3> m{ 1, 2, 3, 4, 5, 6 };
+static_assert(m(1, 0) == 4 && m.at(0, 2) == 3 && m.storage()[5] == 6);
+
+//each layout maps the index space onto storage one to one
+template<typename M, std::size_t... E>
+static bool bijective(std::index_sequence<E...>)
+{
+   static_assert(sizeof...(E) == 2);
+   bool seen[M::size()] = {};
+   for (std::size_t i = 0; i < M::extent(0); ++i)
+      for (std::size_t j = 0; j < M::extent(1); ++j)
+      {
+         const std::size_t o = M::offset(i, j);
+         if (o >= M::size() || seen[o])
+            return false;
+         seen[o] = true;
+      }
+   return true;
+}
+
+TEST_CASE(mdarray)
+{
+   verify(bijective<image>(std::make_index_sequence<2>()) &&
+          bijective<basic_mdarray<int, layout_left, 5, 7>>(std::make_index_sequence<2>()) &&
+          bijective<tiled>(std::make_index_sequence<2>()) &&
+          bijective<basic_mdarray<int, layout_tiled<4, 4>, 16, 8>>(
+             std::make_index_sequence<2>()), "layouts are one to one");
+
+   //the same logical contents in each layout
+   image a{};
+   basic_mdarray<float, layout_left, 4, 6> b{};
+   basic_mdarray<float, layout_tiled<2, 2>, 4, 6> c{};
+   for (std::size_t i = 0; i < 4; ++i)
+      for (std::size_t j = 0; j < 6; ++j)
+         a(i, j) = b(i, j) = c(i, j) = static_cast<float>(10 * i + j);
+
+   verify(a.storage()[7] == 11 && b.storage()[7] == 31 && c.storage()[7] == 13,
+          "storage order per layout");
+
+   bool agree = true;
+   for (std::size_t i = 0; i < 4; ++i)
+      for (std::size_t j = 0; j < 6; ++j)
+         agree = a(i, j) == b(i, j) && b(i, j) == c(i, j) && agree;
+   verify(agree, "layouts agree on indexes");
+
+   //a 2x2 tile is contiguous
+   const float* tile = &c(2, 4);
+   verify(tile[0] == 24 && tile[1] == 25 && tile[2] == 34 && tile[3] == 35, "tile contiguous");
+
+   bool outOfRange = false;
+   try
+   {
+      a.at(4, 0);
+   }
+   catch (const std::out_of_range&)
+   {
+      outOfRange = true;
+   }
+   verify(outOfRange, "at throws out_of_range");
+
+   image copy = a;
+   verify(copy == a, "compare");
+   copy.fill(0);
+   verify(copy != a && copy(3, 5) == 0, "fill");
+   copy.swap(a);
+   verify(copy(3, 5) == 35 && a(3, 5) == 0, "swap");
+
+   mdarray<int, 2, 2, 2> cube{ 0, 1, 2, 3, 4, 5, 6, 7 };
+   verify(cube(1, 0, 1) == 5 && cube.rank() == 3, "rank 3");
+}
@@ -0,0 +1,121 @@
+/*
+* mpmc_queue-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test mpmc_queue template
+*/
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/mpmc_queue.h"
+
+#include "tester.h"
+
+using sigcpp::mpmc_queue;
+
+constexpr unsigned producers = 4, consumers = 4;
+constexpr std::uint64_t perProducer = 20000;
+
+//each producer pushes distinct values; consumers sum what they pop
+//-every value is popped exactly once if the sums and counts match
+template<bool Bulk>
+static bool transfer()
+{
+   static mpmc_queue<std::uint64_t, 256> q;
+   std::atomic<std::uint64_t> sum{ 0 }, popped{ 0 };
+   constexpr std::uint64_t total = producers * perProducer;
+
+   std::vector<std::thread> threads;
+   for (unsigned p = 0; p < producers; ++p)
+      threads.emplace_back([p] {
+         std::uint64_t next = p * perProducer, last = next + perProducer;
+         std::uint64_t buffer[8];
+         while (next != last)
+         {
+            if constexpr (Bulk)
+            {
+               std::size_t n = last - next < 8 ? last - next : 8;
+               for (std::size_t i = 0; i < n; ++i)
+                  buffer[i] = next + i;
+               std::size_t k = q.try_push_n(buffer, n);
+               next += k;
+               if (k == 0)
+                  std::this_thread::yield();
+            }
+            else if (q.try_push(next))
+               ++next;
+            else
+               std::this_thread::yield();
+         }
+      });
+
+   for (unsigned c = 0; c < consumers; ++c)
+      threads.emplace_back([&] {
+         std::uint64_t buffer[8];
+         while (popped.load(std::memory_order_relaxed) != total)
+         {
+            std::size_t n = 0;
+            if constexpr (Bulk)
+               n = q.try_pop_n(buffer, 8);
+            else
+               n = q.try_pop(buffer[0]) ? 1 : 0;
+
+            if (n == 0)
+               std::this_thread::yield();
+
+            std::uint64_t s = 0;
+            for (std::size_t i = 0; i < n; ++i)
+               s += buffer[i];
+            sum += s;
+            popped += n;
+         }
+      });
+
+   for (auto& t : threads)
+      t.join();
+
+   return popped == total && sum == total * (total - 1) / 2 && q.empty_approx();
+}
+
+TEST_CASE(mpmc_queue)
+{
+   mpmc_queue<int, 4> q;
+   verify(q.empty_approx() && q.capacity() == 4, "empty on construction");
+
+   for (int i = 0; i < 4; ++i)
+      q.try_push(i);
+   verify(!q.try_push(4) && q.size_approx() == 4, "try_push when full");
+
+   int v = -1;
+   verify(q.try_pop(v) && v == 0 && q.try_push(4), "pop frees a slot");
+
+   int out[8] = {};
+   verify(q.try_pop_n(out, 8) == 4 && out[0] == 1 && out[3] == 4,
+          "try_pop_n across the wrap point");
+   verify(!q.try_pop(v) && q.try_pop_n(out, 8) == 0, "pop when empty");
+
+   const int in[6] = { 10, 11, 12, 13, 14, 15 };
+   verify(q.try_push_n(in, 6) == 4 && q.try_pop_n(out, 2) == 2 &&
+          q.try_push_n(in + 4, 2) == 2 && q.try_pop_n(out, 8) == 4 &&
+          out[0] == 12 && out[3] == 15, "try_push_n stops when full");
+
+   //non-trivial elements
+   mpmc_queue<std::string, 2> s;
+   s.try_push("alpha");
+   std::string t;
+   verify(s.try_pop(t) && t == "alpha", "std::string elements");
+
+   //concurrent producers and consumers
+   verify(transfer<false>(), "concurrent single transfer, each value once");
+   verify(transfer<true>(), "concurrent bulk transfer, each value once");
+}
@@ -0,0 +1,154 @@
+/*
+* packed_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test packed_array
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../include/packed_array.h"
+
+#include "tester.h"
+
+using sigcpp::packed_array;
+
+//storage is ceil(N * Bits / 64) words
+static_assert(sizeof(packed_array<1, 1000>) == 16 * sizeof(std::uint64_t));
+static_assert(sizeof(packed_array<3, 64>) == 3 * sizeof(std::uint64_t));
+static_assert(sizeof(packed_array<64, 5>) == 5 * sizeof(std::uint64_t));
+
+static_assert(std::is_same_v<packed_array<1, 8>::value_type, bool>);
+static_assert(std::is_same_v<packed_array<5, 8>::value_type, std::uint8_t>);
+static_assert(std::is_same_v<packed_array<12, 8>::value_type, std::uint16_t>);
+static_assert(std::is_same_v<packed_array<33, 8>::value_type, std::uint64_t>);
+
+static_assert(std::is_same_v<std::iterator_traits<packed_array<4, 8>::iterator>::iterator_category,
+   std::random_access_iterator_tag>);
+
+//constexpr: a value of 7 bits at index 9 spans words 0 and 1
+constexpr packed_array<7, 20> make_table()
+{
+   packed_array<7, 20> p{};
+   p.set(9, 0x55);
+   p[19] = 127;
+   return p;
+}
+
+constexpr packed_array<7, 20> table = make_table();
+static_assert(table[9] == 0x55 && table.get(8) == 0 && table.get(10) == 0 && table[19] == 127);
+static_assert(table.find_first() == 9 && table.find_next(10) == 19 && table.popcount() == 11);
+
+TEST_CASE(packed_array)
+{
+   //a bit set
+   packed_array<1, 200> bits{};
+   verify(bits.none() && bits.find_first() == 200 && bits.popcount() == 0, "empty bit set");
+
+   bits[3] = true;
+   bits[64] = true;
+   bits.set(199, true);
+   verify(bits[3] && !bits[4] && bits.at(64) && bits[199], "set bits");
+   verify(bits.popcount() == 3 && bits.any(), "popcount");
+   verify(bits.find_first() == 3 && bits.find_next(4) == 64 && bits.find_next(65) == 199 &&
+      bits.find_next(200) == 200, "find_first, find_next");
+
+   bits[3].flip();
+   verify(!bits[3] && bits.find_first() == 64, "flip one");
+
+   //fill and flip keep the unused bits of the last word clear
+   bits.fill(true);
+   verify(bits.popcount() == 200 && bits.words[3] == (std::uint64_t(1) << 8) - 1, "fill");
+   bits.flip();
+   verify(bits.none(), "flip all");
+   verify((~bits).popcount() == 200, "operator~");
+
+   //bitwise ops
+   packed_array<1, 70> a{}, b{};
+   for (std::size_t i = 0; i < a.size(); ++i)
+   {
+      a[i] = i % 2 == 0;
+      b[i] = i % 3 == 0;
+   }
+   const auto both = a & b;
+   const auto either = a | b;
+   const auto one = a ^ b;
+   verify(both.popcount() == 12 && both[6] && !both[2], "operator&");
+   verify(either.popcount() == 35 + 24 - 12 && either[3] && !either[5], "operator|");
+   verify(one == (either ^ both) && one != both, "operator^, ==");
+
+   //multi-bit values, some spanning two words
+   packed_array<5, 100> fives{};
+   for (std::size_t i = 0; i < fives.size(); ++i)
+      fives[i] = static_cast<std::uint8_t>(i % 32);
+
+   bool valuesOk = true;
+   for (std::size_t i = 0; i < fives.size(); ++i)
+      valuesOk = fives[i] == i % 32 && valuesOk;
+   verify(valuesOk, "5-bit values");
+
+   fives[12] = 0xFF;
+   verify(fives[12] == 31 && fives[11] == 11 && fives[13] == 13, "values truncated");
+   verify(fives.find_first() == 1 && fives.popcount() > 0, "find_first multi-bit");
+
+   fives.fill(21);
+   verify(std::count(fives.cbegin(), fives.cend(), std::uint8_t(21)) == 100, "fill spanning");
+
+   packed_array<16, 9> halves{};
+   halves.fill(0xABCD);
+   verify(halves[8] == 0xABCD && halves.words[2] == 0xABCD, "fill 16-bit");
+
+   packed_array<64, 3> full{};
+   full[1] = ~std::uint64_t(0);
+   verify(full[1] == ~std::uint64_t(0) && full[0] == 0 && full.popcount() == 64, "64-bit values");
+
+   //iterators
+   packed_array<3, 10> p{};
+   std::uint8_t next = 0;
+   for (auto r : p)
+      r = next++;
+   verify(p[0] == 0 && p[7] == 7 && p[9] == 1, "range-for assigns");
+
+   auto it = p.begin();
+   it += 4;
+   verify(*it == 4 && it[2] == 6 && it - p.begin() == 4 && it.index() == 4, "iterator arithmetic");
+   verify(p.end() - p.begin() == 10 && (it < p.end()) && !(it >= p.end()), "iterator compare");
+   verify(p.begin() <= p.end() && !(p.end() <= p.begin()) && p.begin() <= p.begin() &&
+          p.end() >= p.begin() && !(p.begin() >= p.end()), "iterator <= and >=");
+
+   packed_array<3, 10>::const_iterator cit = it;
+   verify(*cit == 4 && cit == it, "const_iterator from iterator");
+   verify(*p.rbegin() == 1 && *(p.rend() - 1) == 0, "reverse iterators");
+
+   std::fill(p.begin(), p.begin() + 3, std::uint8_t(6));
+   verify(std::find(p.cbegin(), p.cend(), std::uint8_t(5)).index() == 5 && p[2] == 6,
+      "std algorithms");
+
+   swap(p[0], p[9]);
+   verify(p[0] == 1 && p[9] == 6, "swap references");
+
+   p[1] = p[5];
+   verify(p[1] == 5 && p[5] == 5, "assign through references");
+
+   bool outOfRange = false;
+   try
+   {
+      p.at(10);
+   }
+   catch (const std::out_of_range&)
+   {
+      outOfRange = true;
+   }
+   verify(outOfRange, "at throws out_of_range");
+}
@@ -0,0 +1,107 @@
+/*
+* prefetch-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test prefetching traversals
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../include/prefetch.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+
+namespace
+{
+   struct big
+   {
+      char bytes[100];
+      int value;
+   };
+}
+
+TEST_CASE(prefetch)
+{
+   //every element once, in order, for sizes around the prefetch distance
+   array<int, 1000> a{};
+   for (std::size_t i = 0; i < a.size(); ++i)
+      a[i] = static_cast<int>(i);
+
+   int expected = 0;
+   bool inOrder = true;
+   sigcpp::prefetch_for_each(a, [&](int x) { inOrder = x == expected++ && inOrder; });
+   verify(inOrder && expected == 1000, "prefetch_for_each visits in order");
+
+   sigcpp::prefetch_for_each(a, [](int& x) { x *= 2; }, 1);
+   verify(a[0] == 0 && a[999] == 1998, "prefetch_for_each modifies");
+
+   long long sum = 0;
+   const array<int, 1000>& ca = a;
+   sigcpp::prefetch_for_each(ca, [&](int x) { sum += x; }, 1000);
+   verify(sum == 999 * 1000, "distance past the end");
+
+   array<short, 3> few{ 1, 2, 3 };
+   int count = 0;
+   sigcpp::prefetch_for_each(few, [&](short) { ++count; });
+   sigcpp::prefetch_for_each(few.data(), 0, [&](short) { ++count; });
+   verify(count == 3, "fewer elements than a line");
+
+   array<big, 10> bigs{};
+   bigs[9].value = 7;
+   int bigSum = 0;
+   sigcpp::prefetch_for_each(bigs, [&](const big& b) { bigSum += b.value + 1; }, 2);
+   verify(bigSum == 17, "elements larger than a line");
+
+   //indirect: table[idx[i]]
+   std::vector<std::uint64_t> table(4096);
+   for (std::size_t i = 0; i < table.size(); ++i)
+      table[i] = i * i;
+
+   array<std::uint32_t, 200> idx{};
+   std::uint64_t expectedGather = 0;
+   for (std::size_t i = 0; i < idx.size(); ++i)
+   {
+      idx[i] = static_cast<std::uint32_t>((i * 2654435761u) % table.size());
+      expectedGather += table[idx[i]];
+   }
+
+   std::uint64_t gathered = 0;
+   sigcpp::prefetch_gather_for_each(idx, table, [&](std::uint64_t v) { gathered += v; });
+   verify(gathered == expectedGather, "prefetch_gather_for_each");
+
+   array<int, 8> small{};
+   array<std::uint32_t, 4> smallIdx{ 7, 0, 7, 3 };
+   sigcpp::prefetch_gather_for_each(smallIdx, small, [](int& v) { ++v; }, 100);
+   verify(small[7] == 2 && small[0] == 1 && small[3] == 1 && small[1] == 0,
+      "gather modifies table");
+
+   //iterator adaptor
+   std::size_t visited = 0;
+   for (int& x : sigcpp::prefetched(a, 2))
+   {
+      x += 1;
+      ++visited;
+   }
+   verify(visited == 1000 && a[0] == 1 && a[999] == 1999, "prefetched range");
+
+   auto range = sigcpp::prefetched(ca);
+   auto it = range.begin();
+   auto prev = it++;
+   verify(*prev == 1 && *it == 3 && it != range.end() && it.base() == ca.begin() + 1,
+      "prefetch_iterator");
+
+   array<big, 2> twoBigs{};
+   twoBigs[1].value = 5;
+   auto bigRange = sigcpp::prefetched(twoBigs);
+   verify((++bigRange.begin())->value == 5, "prefetch_iterator member access");
+}
@@ -0,0 +1,177 @@
+/*
+* ring_buffer-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test ring_buffer template
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "../include/ring_buffer.h"
+
+#include "tester.h"
+
+using sigcpp::ring_buffer;
+
+//ring buffers are usable in constant expressions
+constexpr int sumAfterWrap()
+{
+   ring_buffer<int, 4> r;
+   for (int i = 0; i < 4; ++i)
+      r.push_back(i);
+   r.pop_front();
+   r.pop_front();
+   r.push_back(4);
+   r.push_back(5);
+
+   int sum = 0;
+   for (auto it = r.begin(); it != r.end(); ++it)
+      sum += *it;
+   return sum;
+}
+
+static_assert(sumAfterWrap() == 2 + 3 + 4 + 5);
+
+template<typename R>
+static bool contains(const R& r, std::initializer_list<int> expected)
+{
+   return r.size() == expected.size() &&
+      std::equal(r.begin(), r.end(), expected.begin());
+}
+
+#if SIGCPP_ITERATOR_DEBUG
+//true if f traps: main reports iterator misuse as std::logic_error
+template<typename F>
+static bool traps(F f)
+{
+   try
+   {
+      f();
+   }
+   catch (const std::logic_error&)
+   {
+      return true;
+   }
+   return false;
+}
+
+static void testCheckedIterators()
+{
+   ring_buffer<int, 4> r;
+   r.push_back(1);
+   r.push_back(2);
+
+   verify(!traps([&] { return *r.begin() + r.begin()[1]; }),
+          "checked iterator: valid access");
+   verify(traps([&] { return *r.end(); }), "checked iterator: dereference end");
+   verify(traps([&] { return r.begin() + 3; }), "checked iterator: move past end");
+
+   ring_buffer<int, 4> s;
+   verify(traps([&] { return r.begin() == s.begin(); }),
+          "checked iterator: compare different buffers");
+}
+#endif
+
+TEST_CASE(ring_buffer)
+{
+   ring_buffer<int, 8> r;
+   verify(r.empty() && !r.full() && r.capacity() == 8, "empty on construction");
+
+   for (int i = 0; i < 8; ++i)
+      r.push_back(i);
+   verify(r.full() && contains(r, { 0, 1, 2, 3, 4, 5, 6, 7 }), "fill to capacity");
+
+   bool threw = false;
+   try
+   {
+      r.push_back(8);
+   }
+   catch (const std::length_error&)
+   {
+      threw = true;
+   }
+   verify(threw && !r.try_push_back(8), "push when full");
+
+   //wrap around
+   r.pop_front();
+   r.pop_front();
+   r.pop_front();
+   r.push_back(8);
+   r.push_back(9);
+   verify(contains(r, { 3, 4, 5, 6, 7, 8, 9 }) && r.front() == 3 && r.back() == 9,
+          "push after wrap");
+   verify(r[0] == 3 && r.at(6) == 9, "indexing relative to front");
+
+   threw = false;
+   try
+   {
+      r.at(7);
+   }
+   catch (const std::out_of_range&)
+   {
+      threw = true;
+   }
+   verify(threw, "at() out of range throws");
+
+   //iterators across the wrap point
+   verify(r.end() - r.begin() == 7 && r.begin() < r.end() && *(r.end() - 1) == 9,
+          "iterator arithmetic across wrap");
+   verify(r.begin() <= r.end() && !(r.end() <= r.begin()) && r.end() >= r.begin() &&
+          r.begin() <= r.begin() && !(r.begin() >= r.end()), "iterator <= and >=");
+
+   ring_buffer<int, 4> two;
+   two.push_back(1);
+   two.push_back(2);
+   verify(two.begin() <= two.end() && two.begin() + 1 <= two.end() - 1,
+          "iterator <= in a two-element ring");
+   verify(std::equal(r.rbegin(), r.rend(),
+                     std::initializer_list<int>{ 9, 8, 7, 6, 5, 4, 3 }.begin()),
+          "reverse iterator across wrap");
+   std::sort(r.begin(), r.end(), [](int a, int b) { return a > b; });
+   verify(contains(r, { 9, 8, 7, 6, 5, 4, 3 }), "std::sort across wrap");
+
+   int v = 0;
+   verify(r.try_pop_front(v) && v == 9 && r.size() == 6, "try_pop_front");
+
+   //bulk copy in two spans: slots 4..7 then 0..1
+   ring_buffer<int, 8> b;
+   int in[8];
+   std::iota(in, in + 8, 10);
+   b.push_n(in, 4);
+   int out[8] = {};
+   verify(b.pop_n(out, 4) == 4 && std::equal(out, out + 4, in), "pop_n in one span");
+
+   verify(b.push_n(in, 6) == 6 && contains(b, { 10, 11, 12, 13, 14, 15 }),
+          "push_n in two spans");
+   verify(b.push_n(in, 8) == 2 && b.full(), "push_n stops when full");
+
+   verify(b.pop_n(out, 8) == 8 && contains(b, {}) && out[5] == 15 && out[7] == 11,
+          "pop_n in two spans");
+   verify(b.pop_n(out, 1) == 0, "pop_n when empty");
+
+   //non-trivial elements
+   ring_buffer<std::string, 2> s;
+   s.push_back("alpha");
+   s.push_back("beta");
+   std::string t;
+   s.try_pop_front(t);
+   s.push_back("gamma");
+   verify(t == "alpha" && s.front() == "beta" && s.back() == "gamma",
+          "std::string elements");
+
+   s.clear();
+   verify(s.empty(), "clear");
+
+#if SIGCPP_ITERATOR_DEBUG
+   testCheckedIterators();
+#endif
+}
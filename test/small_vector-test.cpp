@@ -0,0 +1,199 @@
+/*
+* small_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test small_vector template
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "../include/small_vector.h"
+
+#include "tester.h"
+#include "tracked.h"
+
+using sigcpp::small_vector;
+
+//exercise all modifiers with elements of type T, across the spill to heap
+template<typename T>
+static void testModifiers(const char* type)
+{
+   std::string name(type);
+
+   small_vector<T, 4> v;
+   verify(v.empty() && v.capacity() == 4 && v.is_inline(),
+          (name + ": empty and inline on construction").c_str());
+
+   v.push_back(T(1));
+   v.emplace_back(2);
+   T three(3);
+   v.push_back(three);
+   v.push_back(T(4));
+   verify(contains(v, { 1, 2, 3, 4 }) && v.is_inline(),
+          (name + ": inline up to capacity").c_str());
+
+   //spill: push a copy of an element being relocated
+   v.push_back(v[0]);
+   verify(contains(v, { 1, 2, 3, 4, 1 }) && !v.is_inline() && v.capacity() >= 5,
+          (name + ": spill to heap with aliased element").c_str());
+
+   {
+      auto it = v.insert(v.begin(), T(0));
+      verify(it == v.begin() && contains(v, { 0, 1, 2, 3, 4, 1 }),
+             (name + ": insert at begin").c_str());
+
+      //fill to capacity, then insert an aliased element so growth is needed
+      while (v.size() < v.capacity())
+         v.push_back(T(9));
+      const std::size_t n = v.size();
+      v.insert(v.begin() + 1, v[n - 1]);
+      verify(v.size() == n + 1 && v[1] == 9 && v[2] == 1,
+             (name + ": insert aliased element with growth").c_str());
+
+      it = v.erase(v.begin() + 1);
+      v.erase(v.begin() + 6, v.end());
+      verify(*it == 1 && contains(v, { 0, 1, 2, 3, 4, 1 }),
+             (name + ": erase").c_str());
+   }
+
+   //shrink back to inline storage
+   v.resize(3);
+   v.shrink_to_fit();
+   verify(contains(v, { 0, 1, 2 }) && v.is_inline() && v.capacity() == 4,
+          (name + ": shrink_to_fit returns inline").c_str());
+
+   v.resize(6, T(7));
+   verify(contains(v, { 0, 1, 2, 7, 7, 7 }) && !v.is_inline(),
+          (name + ": resize up spills").c_str());
+
+   //copy
+   small_vector<T, 4> c(v);
+   verify(c == v && !c.is_inline() && c.data() != v.data(),
+          (name + ": copy ctor").c_str());
+
+   small_vector<T, 4> i{ T(5), T(6) };
+   c = i;
+   verify(contains(c, { 5, 6 }), (name + ": copy assign shorter").c_str());
+
+   //move steals the heap buffer
+   const T* heap = v.data();
+   small_vector<T, 4> m(std::move(v));
+   verify(m.data() == heap && contains(m, { 0, 1, 2, 7, 7, 7 }) &&
+          v.empty() && v.is_inline(), (name + ": move ctor steals heap").c_str());
+
+   //move of inline elements
+   small_vector<T, 4> mi(std::move(i));
+   verify(mi.is_inline() && contains(mi, { 5, 6 }) && i.empty(),
+          (name + ": move ctor of inline elements").c_str());
+
+   mi = std::move(m);
+   verify(mi.data() == heap && contains(mi, { 0, 1, 2, 7, 7, 7 }) && m.empty(),
+          (name + ": move assign steals heap").c_str());
+
+   //swap heap with inline, and heap with heap
+   small_vector<T, 4> s{ T(8) };
+   s.swap(mi);
+   verify(contains(s, { 0, 1, 2, 7, 7, 7 }) && contains(mi, { 8 }),
+          (name + ": swap heap and inline").c_str());
+
+   small_vector<T, 4> h{ T(1), T(2), T(3), T(4), T(5) };
+   const T* hs = h.data();
+   h.swap(s);
+   verify(s.data() == hs && contains(s, { 1, 2, 3, 4, 5 }) &&
+          contains(h, { 0, 1, 2, 7, 7, 7 }), (name + ": swap heap and heap").c_str());
+
+   h.clear();
+   verify(h.empty() && !h.is_inline(), (name + ": clear keeps capacity").c_str());
+}
+
+TEST_CASE(small_vector)
+{
+   testModifiers<int>("int");
+   testModifiers<tracked>("tracked");
+
+   //all elements are destroyed
+   verify(tracked::live == 0, "tracked: no live objects");
+
+   //a throwing copy while spilling leaves the elements in place
+   bool spillTest = false;
+   try
+   {
+      small_vector<fragile, 2> f{ 1, 2 };
+      fragile::copies = 1;
+      try
+      {
+         f.emplace_back(3);
+      }
+      catch (const std::runtime_error&)
+      {
+         spillTest = f.is_inline() && contains(f, { 1, 2 }) && tracked::live == 2;
+      }
+
+      fragile::copies = 1;
+      f.reserve(8);
+      spillTest = false;
+   }
+   catch (const std::runtime_error&)
+   {
+      spillTest = spillTest && tracked::live == 0;
+   }
+   fragile::copies = -1;
+   verify(spillTest, "throwing copy in spill leaks nothing");
+
+   //reserve within inline capacity does not allocate
+   small_vector<int, 8> r;
+   r.reserve(8);
+   verify(r.is_inline() && r.capacity() == 8, "reserve within inline capacity");
+   r.reserve(100);
+   verify(!r.is_inline() && r.capacity() == 100, "reserve beyond inline capacity");
+
+   //inserts with room left do not grow
+   for (int i = 0; i < 5; ++i)
+      r.push_back(i);
+   for (int i = 0; i < 5; ++i)
+      r.insert(r.begin(), -i);
+   verify(r.size() == 10 && r.capacity() == 100 && r[0] == -4 && r[9] == 4,
+          "insert within capacity keeps capacity");
+
+   //many elements
+   small_vector<int, 2> big;
+   for (int i = 0; i < 1000; ++i)
+      big.push_back(i);
+   bool sequence = true;
+   for (int i = 0; i < 1000; ++i)
+      sequence = sequence && big[static_cast<std::size_t>(i)] == i;
+   verify(big.size() == 1000 && sequence, "1000 push_backs");
+
+   //out-of-range access
+   bool atTest = false;
+   try
+   {
+      small_vector<int, 4> v{ 1, 2 };
+      v.at(2);
+   }
+   catch (const std::out_of_range&)
+   {
+      atTest = true;
+   }
+   verify(atTest, "at() out of range throws");
+
+   //non-trivial elements across the spill
+   small_vector<std::string, 2> s{ "alpha", "beta" };
+   s.insert(s.begin() + 1, "gamma");
+   s.emplace_back(3, 'x');
+   verify(s[0] == "alpha" && s[1] == "gamma" && s[2] == "beta" && s[3] == "xxx",
+          "std::string elements");
+
+   //reverse iteration
+   small_vector<int, 2> rv{ 1, 2, 3 };
+   verify(std::equal(rv.rbegin(), rv.rend(), small_vector<int, 2>{ 3, 2, 1 }.begin()),
+          "reverse iterator");
+}
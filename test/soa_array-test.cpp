@@ -0,0 +1,119 @@
+/*
+* soa_array-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test soa_array template
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "../include/soa_array.h"
+
+#include "tester.h"
+
+using sigcpp::soa_array;
+
+//each field is its own column: no padding between fields of a record
+static_assert(sizeof(soa_array<8, double, char>) == 8 * sizeof(double) + 8);
+static_assert(std::is_same_v<soa_array<4, int, float>::field_type<1>, float>);
+
+//usable in constant expressions
+constexpr int sumOfFields()
+{
+   soa_array<3, int, int> s;
+   for (std::size_t i = 0; i < s.size(); ++i)
+   {
+      s[i].get<0>() = static_cast<int>(i);
+      s[i].get<1>() = 10;
+   }
+
+   int sum = 0;
+   for (auto r : s)
+      sum += r.get<0>() + r.get<1>();
+   return sum;
+}
+
+static_assert(sumOfFields() == 33);
+
+TEST_CASE(soa_array)
+{
+   soa_array<5, int, double, std::string> s;
+   verify(s.size() == 5 && s.field_count() == 3 && !s.empty(), "size");
+
+   s.fill(1, 2.5, "x");
+   verify(s[4].get<0>() == 1 && s[4].get<1>() == 2.5 && s[4].get<2>() == "x",
+          "fill");
+
+   //columns are arrays
+   std::iota(s.column<0>().begin(), s.column<0>().end(), 0);
+   verify(s[3].get<0>() == 3 && s.column<0>()[3] == 3, "column access");
+
+   //proxies read and write records
+   s[1] = std::make_tuple(7, 0.5, std::string("seven"));
+   std::tuple<int, double, std::string> r = s[1];
+   verify(std::get<0>(r) == 7 && std::get<2>(r) == "seven", "assign and convert");
+
+   s[2] = s[1];
+   verify(s[2].get<0>() == 7 && s[2].get<1>() == 0.5, "assign record to record");
+
+   //iterators
+   verify(s.end() - s.begin() == 5 && (*(s.begin() + 1)).get<0>() == 7 &&
+          s.begin()[3].get<0>() == 3, "iterator arithmetic");
+   verify(s.begin() < s.end() && s.begin() <= s.end() && !(s.end() <= s.begin()) &&
+          s.end() >= s.begin() && !(s.begin() >= s.end()), "iterator compare");
+
+   const auto& c = s;
+   int sum = 0;
+   for (auto it = c.begin(); it != c.end(); ++it)
+      sum += (*it).get<0>();
+   verify(sum == 0 + 7 + 7 + 3 + 4, "const iteration");
+
+   verify(std::count_if(s.rbegin(), s.rend(), [](auto e) { return e.template get<0>() == 7; }) == 2,
+          "reverse iteration");
+
+   //records move together when sorted
+   soa_array<6, int, char> k;
+   const int keys[] = { 4, 2, 6, 1, 5, 3 };
+   for (std::size_t i = 0; i < 6; ++i)
+   {
+      k[i].get<0>() = keys[i];
+      k[i].get<1>() = static_cast<char>('a' + keys[i]);
+   }
+   //the comparison may be passed proxies or values: compare as values
+   using record = soa_array<6, int, char>::value_type;
+   std::sort(k.begin(), k.end(), [](const record& a, const record& b) {
+      return std::get<0>(a) < std::get<0>(b);
+   });
+   bool sorted = true;
+   for (std::size_t i = 0; i < 6; ++i)
+      sorted = sorted && k[i].get<0>() == int(i + 1) && k[i].get<1>() == 'b' + int(i);
+   verify(sorted, "std::sort moves whole records");
+
+   //swap
+   soa_array<6, int, char> z;
+   z.fill(0, 'z');
+   z.swap(k);
+   verify(k[0].get<1>() == 'z' && z[0].get<0>() == 1, "swap");
+
+   //checked access
+   bool threw = false;
+   try
+   {
+      s.at(5);
+   }
+   catch (const std::out_of_range&)
+   {
+      threw = true;
+   }
+   verify(threw, "at() out of range throws");
+}
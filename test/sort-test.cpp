@@ -0,0 +1,173 @@
+/*
+* sort-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test sort and sorting networks
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "../include/sort.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+
+//network sizes of Batcher's merge exchange
+static_assert(sigcpp::sorting_network<2>.size() == 1);
+static_assert(sigcpp::sorting_network<4>.size() == 5);
+static_assert(sigcpp::sorting_network<8>.size() == 19);
+static_assert(sigcpp::sorting_network<16>.size() == 63);
+
+//sort is usable in constant expressions: network and introsort
+template<std::size_t N>
+constexpr bool sortsReversed()
+{
+   array<int, N> a{};
+   for (std::size_t i = 0; i < N; ++i)
+      a[i] = static_cast<int>(N - i);
+
+   sigcpp::sort(a);
+
+   for (std::size_t i = 0; i < N; ++i)
+      if (a[i] != static_cast<int>(i + 1))
+         return false;
+   return true;
+}
+
+static_assert(sortsReversed<9>());
+static_assert(sortsReversed<32>());
+static_assert(sortsReversed<100>());
+
+constexpr array<int, 5> sortedDescending()
+{
+   array<int, 5> a{ 3, 1, 4, 1, 5 };
+   sigcpp::sort(a, std::greater<>());
+   return a;
+}
+
+static_assert(sortedDescending()[0] == 5 && sortedDescending()[4] == 1);
+
+//0-1 principle: a network sorts all inputs if it sorts all inputs of 0s and 1s
+template<std::size_t N>
+static bool sortsAllZeroOne()
+{
+   for (std::uint32_t bits = 0; bits < (std::uint32_t(1) << N); ++bits)
+   {
+      array<unsigned char, N> a{};
+      for (std::size_t i = 0; i < N; ++i)
+         a[i] = (bits >> i) & 1;
+
+      sigcpp::sort(a);
+      if (!std::is_sorted(a.begin(), a.end()))
+         return false;
+   }
+   return true;
+}
+
+template<std::size_t... N>
+static bool sortsAllZeroOne(std::index_sequence<N...>)
+{
+   return (sortsAllZeroOne<N + 2>() && ...);
+}
+
+//random inputs for each element type, compared with std::sort
+template<typename T, std::size_t N, typename Compare = std::less<>>
+static bool sortsRandom(std::mt19937& gen, Compare comp = Compare())
+{
+   std::uniform_int_distribution<int> dist(-50, 50);
+   for (int trial = 0; trial < 100; ++trial)
+   {
+      array<T, N> a{}, b{};
+      for (std::size_t i = 0; i < N; ++i)
+         a[i] = b[i] = static_cast<T>(dist(gen));
+
+      sigcpp::sort(a, comp);
+      std::sort(b.begin(), b.end(), comp);
+      if (!std::equal(a.begin(), a.end(), b.begin()))
+         return false;
+   }
+   return true;
+}
+
+//true if a and b hold the same multiset of object representations: equal
+//floating-point values such as 0.0 and -0.0 are told apart
+template<typename T, std::size_t N>
+static bool samePatterns(const array<T, N>& a, const array<T, N>& b)
+{
+   using bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+   static_assert(sizeof(T) == sizeof(bits));
+
+   array<bits, N> pa{}, pb{};
+   std::memcpy(pa.data(), a.data(), sizeof(a.values));
+   std::memcpy(pb.data(), b.data(), sizeof(b.values));
+   std::sort(pa.begin(), pa.end());
+   std::sort(pb.begin(), pb.end());
+   return pa == pb;
+}
+
+struct key
+{
+   int k;
+   double payload;
+};
+
+TEST_CASE(sort)
+{
+   verify(sortsAllZeroOne(std::make_index_sequence<15>()), "0-1 inputs, N = 2..16");
+   verify(sortsAllZeroOne<20>(), "0-1 inputs, N = 20");
+
+   std::mt19937 gen(42);
+   verify(sortsRandom<int, 7>(gen) && sortsRandom<int, 32>(gen),
+          "int, network sizes");
+   verify(sortsRandom<float, 9>(gen) && sortsRandom<double, 25>(gen),
+          "floating point, network sizes");
+   verify(sortsRandom<int, 24>(gen, std::greater<>()), "int, descending");
+
+   //signed zeros compare equal: the output is a permutation of the input
+   const array<float, 2> zf{ 0.0f, -0.0f };
+   array<float, 2> sf = zf;
+   sigcpp::sort(sf);
+   verify(samePatterns(sf, zf), "float signed zeros kept");
+
+   const array<double, 5> zd{ 1.0, -0.0, 0.0, -0.0, -1.0 };
+   array<double, 5> sd = zd;
+   sigcpp::sort(sd);
+   verify(samePatterns(sd, zd) && std::is_sorted(sd.begin(), sd.end()),
+          "double signed zeros kept");
+   verify(sortsRandom<int, 33>(gen) && sortsRandom<int, 1000>(gen),
+          "int, introsort sizes");
+
+   //trivially-copyable class type: selects on a custom comparison
+   array<key, 6> k{ { { 3, 0.3 }, { 1, 0.1 }, { 2, 0.2 }, { 6, 0.6 }, { 5, 0.5 },
+                      { 4, 0.4 } } };
+   sigcpp::sort(k, [](const key& x, const key& y) { return x.k < y.k; });
+   verify(std::is_sorted(k.begin(), k.end(),
+                         [](const key& x, const key& y) { return x.k < y.k; }) &&
+          k[0].payload == 0.1, "trivially-copyable class type");
+
+   //non-trivial elements: swaps
+   array<std::string, 5> s{ "delta", "alpha", "echo", "charlie", "bravo" };
+   sigcpp::sort(s);
+   verify(s[0] == "alpha" && s[4] == "echo" && std::is_sorted(s.begin(), s.end()),
+          "std::string elements");
+
+   //sizes with nothing to do
+   array<int, 1> one{ 7 };
+   array<int, 0> none{};
+   sigcpp::sort(one);
+   sigcpp::sort(none);
+   verify(one[0] == 7, "sizes 0 and 1");
+}
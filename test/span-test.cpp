@@ -0,0 +1,156 @@
+/*
+* span-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test span
+*/
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../include/span.h"
+#include "../include/algorithm.h"
+#include "../include/static_vector.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::span;
+using sigcpp::dynamic_extent;
+
+//one instantiation for all sizes
+static float sum(span<const float> s)
+{
+   float total = 0;
+   for (float f : s)
+      total += f;
+   return total;
+}
+
+//a static extent is one pointer
+static_assert(sizeof(span<int, 4>) == sizeof(int*));
+static_assert(sizeof(span<int>) == sizeof(int*) + sizeof(std::size_t));
+
+//deduction and extents
+static_assert(std::is_same_v<decltype(span(std::declval<array<int, 3>&>())), span<int, 3>>);
+static_assert(std::is_same_v<decltype(span(std::declval<const array<int, 3>&>())),
+   span<const int, 3>>);
+static_assert(std::is_same_v<decltype(span(std::declval<std::vector<int>&>())), span<int>>);
+static_assert(std::is_same_v<decltype(std::declval<span<int, 8>>().subspan<2>()),
+   span<int, 6>>);
+static_assert(std::is_same_v<decltype(std::declval<span<int>>().subspan<2, 3>()),
+   span<int, 3>>);
+static_assert(std::is_same_v<decltype(std::declval<span<int>>().subspan<2>()), span<int>>);
+
+//spans are constexpr
+constexpr array<int, 5> digits{ 1, 2, 3, 4, 5 };
+static_assert(span(digits).last<2>()[0] == 4 && span(digits).subspan(1, 3).back() == 4);
+
+//conversions: not from a different extent, nor dropping const
+static_assert(std::is_constructible_v<span<const int, 5>, span<int, 5>>);
+static_assert(!std::is_constructible_v<span<int, 4>, array<int, 5>&>);
+static_assert(!std::is_constructible_v<span<int>, const array<int, 5>&>);
+static_assert(!std::is_convertible_v<span<int>, span<int, 5>>);
+
+TEST_CASE(span)
+{
+   array<float, 4> small{ 1, 2, 3, 4 };
+   array<float, 8> large{ 1, 1, 1, 1, 1, 1, 1, 1 };
+   sigcpp::static_vector<float, 4> sv{ 0.5f, 0.5f };
+   std::vector<float> v{ 2, 2, 2 };
+   float raw[2] = { 3, 4 };
+
+   verify(sum(small) == 10 && sum(large) == 8 && sum(sv) == 1 && sum(v) == 6 && sum(raw) == 7,
+          "any contiguous source");
+
+   //static extents keep array kernels
+   span<float, 4> s(small);
+   verify(sigcpp::reduce(s) == 10 && sigcpp::minmax(s) == std::make_pair(1.0f, 4.0f),
+          "reduce and minmax on span");
+   verify(*sigcpp::find(s, 3.0f) == 3 && sigcpp::count(span(large), 1.0f) == 8,
+          "find and count on span");
+   verify(sigcpp::equal(span(large).first<4>(), span<const float, 4>(large.data(), 4)) &&
+          sigcpp::lexicographical_compare(span(large).first<4>(), s), "equal and compare");
+
+   //subviews
+   span<float> d(large);
+   verify(d.first(3).size() == 3 && d.last(2).data() == large.data() + 6 &&
+          d.subspan(5).size() == 3 && d.subspan(2, 0).empty(), "dynamic subviews");
+
+   auto mid = span(small).subspan<1, 2>();
+   verify(mid.extent == 2 && mid[0] == 2 && mid.back() == 3, "static subviews");
+
+   //iteration and modification through the view
+   for (float& f : span(small))
+      f *= 2;
+   verify(small[3] == 8 && *span(small).rbegin() == 8, "iterators");
+
+   //bytes
+   verify(sigcpp::as_bytes(s).size() == sizeof(small) &&
+          sigcpp::as_bytes(s).extent == 16, "as_bytes");
+   sigcpp::as_writable_bytes(span(raw))[0] = std::byte{ 0 };
+
+   //checked operations throw
+   bool outOfRange = false;
+   try
+   {
+      d.subspan(9);
+   }
+   catch (const std::out_of_range&)
+   {
+      outOfRange = true;
+   }
+   verify(outOfRange, "subspan out of range");
+
+   //offset + count wraps around
+   bool wraps = false;
+   try
+   {
+      span<float>(small).subspan(2, std::numeric_limits<std::size_t>::max() - 1);
+   }
+   catch (const std::out_of_range&)
+   {
+      wraps = true;
+   }
+   verify(wraps, "subspan count beyond the end throws");
+
+   bool mismatch = false;
+   try
+   {
+      span<float, 4> wrong(v);
+   }
+   catch (const std::out_of_range&)
+   {
+      mismatch = true;
+   }
+   verify(mismatch, "static extent of container must agree");
+
+   bool at = false;
+   try
+   {
+      s.at(4);
+   }
+   catch (const std::out_of_range&)
+   {
+      at = true;
+   }
+   verify(at && s.at(3) == 8, "at");
+
+   span<int> empty;
+   verify(empty.empty() && empty.begin() == empty.end() && empty.data() == nullptr,
+          "default span");
+
+   std::string text("abc");
+   span<const char> chars(text);
+   verify(chars.size() == 3 && chars[1] == 'b', "string");
+}
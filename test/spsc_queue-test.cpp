@@ -0,0 +1,107 @@
+/*
+* spsc_queue-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test spsc_queue template
+*/
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <thread>
+
+#include "../include/spsc_queue.h"
+
+#include "tester.h"
+
+using sigcpp::spsc_queue;
+
+//producer and consumer state never share a cache line with each other
+static_assert(sizeof(spsc_queue<char, 4>) >= 3 * sigcpp::cache_line_size);
+static_assert(alignof(spsc_queue<char, 4>) == sigcpp::cache_line_size);
+
+//one thread pushes 0..count-1 while another pops and checks the order
+template<bool Bulk>
+static bool transfer(std::uint32_t count)
+{
+   static spsc_queue<std::uint32_t, 64> q;
+   bool ordered = true;
+
+   std::thread consumer([&] {
+      std::uint32_t expected = 0, buffer[16];
+      while (expected != count)
+      {
+         std::size_t n = 0;
+         if constexpr (Bulk)
+            n = q.try_pop_n(buffer, 16);
+         else
+            n = q.try_pop(buffer[0]) ? 1 : 0;
+
+         if (n == 0)
+            std::this_thread::yield();
+
+         for (std::size_t i = 0; i < n; ++i)
+            ordered = ordered && buffer[i] == expected++;
+      }
+   });
+
+   std::uint32_t next = 0, buffer[16];
+   while (next != count)
+   {
+      if constexpr (Bulk)
+      {
+         std::iota(buffer, buffer + 16, next);
+         std::size_t n = count - next < 16 ? count - next : 16;
+         std::size_t k = q.try_push_n(buffer, n);
+         next += static_cast<std::uint32_t>(k);
+         if (k == 0)
+            std::this_thread::yield();
+      }
+      else if (q.try_push(next))
+         ++next;
+      else
+         std::this_thread::yield();
+   }
+
+   consumer.join();
+   return ordered && q.empty_approx();
+}
+
+TEST_CASE(spsc_queue)
+{
+   spsc_queue<int, 4> q;
+   verify(q.empty_approx() && q.capacity() == 4, "empty on construction");
+
+   for (int i = 0; i < 4; ++i)
+      q.try_push(i);
+   verify(!q.try_push(4) && q.size_approx() == 4, "try_push when full");
+
+   int v = -1;
+   verify(q.try_pop(v) && v == 0 && q.try_push(4), "pop frees a slot");
+
+   int out[8] = {};
+   verify(q.try_pop_n(out, 8) == 4 && out[0] == 1 && out[3] == 4,
+          "try_pop_n across the wrap point");
+   verify(!q.try_pop(v) && q.try_pop_n(out, 8) == 0, "pop when empty");
+
+   const int in[6] = { 10, 11, 12, 13, 14, 15 };
+   verify(q.try_push_n(in, 6) == 4 && q.try_pop_n(out, 2) == 2 &&
+          q.try_push_n(in + 4, 2) == 2 && q.try_pop_n(out, 8) == 4 &&
+          out[0] == 12 && out[3] == 15, "try_push_n stops when full");
+
+   //non-trivial elements
+   spsc_queue<std::string, 2> s;
+   s.try_push("alpha");
+   std::string t;
+   verify(s.try_pop(t) && t == "alpha", "std::string elements");
+
+   //concurrent producer and consumer
+   verify(transfer<false>(200000), "concurrent single transfer in order");
+   verify(transfer<true>(200000), "concurrent bulk transfer in order");
+}
@@ -0,0 +1,157 @@
+/*
+* static_flat_map-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test static_flat_map
+*/
+
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../include/static_flat_map.h"
+
+#include "tester.h"
+
+using sigcpp::static_flat_map;
+
+namespace
+{
+   //every key in one probe sequence: exercises probing past full groups
+   struct collide
+   {
+      std::size_t operator()(int) const noexcept { return 42; }
+   };
+
+   //pseudo-random keys
+   std::uint32_t next(std::uint32_t& state)
+   {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state;
+   }
+}
+
+TEST_CASE(static_flat_map)
+{
+   static_flat_map<int, int, 256> m;
+   verify(m.empty() && m.begin() == m.end(), "empty map");
+   verify(m.capacity() == 256 && m.slot_count() == 512, "slot count");
+
+   //insert, find, duplicate
+   for (int i = 0; i < 256; ++i)
+      m.try_emplace(i, i * 10);
+
+   verify(m.size() == 256 && m.at(17) == 170 && m.find(256) == m.end(), "insert and find");
+   verify(!m.insert({ 17, 0 }).second && m[17] == 170, "duplicate key not inserted");
+
+   bool full = false;
+   try
+   {
+      m[1000] = 1;
+   }
+   catch (const std::length_error&)
+   {
+      full = true;
+   }
+   verify(full && m.size() == 256, "full map throws length_error");
+
+   bool missing = false;
+   try
+   {
+      m.at(-1);
+   }
+   catch (const std::out_of_range&)
+   {
+      missing = true;
+   }
+   verify(missing, "at throws out_of_range");
+
+   //iteration visits each entry once
+   long long sum = 0;
+   std::size_t visited = 0;
+   for (const auto& e : m)
+   {
+      sum += e.second;
+      ++visited;
+   }
+   verify(visited == 256 && sum == 10LL * 255 * 256 / 2, "iteration");
+
+   //erase: by key and by iterator
+   verify(m.erase(17) == 1 && m.erase(17) == 0 && !m.contains(17), "erase by key");
+   for (auto it = m.begin(); it != m.end();)
+      it = it->first % 2 == 0 ? m.erase(it) : ++it;
+   verify(m.size() == 127 && m.contains(3) && !m.contains(4), "erase by iterator");
+
+   //insert_or_assign and operator[]
+   m.insert_or_assign(3, -3);
+   m[4] += 7;
+   verify(m.at(3) == -3 && m.at(4) == 7, "insert_or_assign and operator[]");
+
+   //churn against a reference map: tombstones are dropped, keys stay reachable
+   //-kept near capacity, erases in full groups leave tombstones
+   static_flat_map<int, int, 112> churn;
+   std::unordered_map<int, int> expected;
+   std::uint32_t state = 12345;
+   bool agree = true;
+   for (int step = 0; step < 50000; ++step)
+   {
+      const int key = static_cast<int>(next(state) % 300);
+      if (expected.size() < 112 && (next(state) % 4) != 0)
+      {
+         churn[key] = step;
+         expected[key] = step;
+      }
+      else
+      {
+         agree = churn.erase(key) == expected.erase(key) && agree;
+      }
+   }
+   for (const auto& e : expected)
+      agree = churn.contains(e.first) && churn.at(e.first) == e.second && agree;
+   verify(agree && churn.size() == expected.size(), "churn against unordered_map");
+
+   //a degenerate hash puts every key in one probe sequence
+   static_flat_map<int, int, 100, collide> same;
+   for (int i = 0; i < 100; ++i)
+      same[i] = i;
+   for (int i = 0; i < 100; i += 3)
+      same.erase(i);
+   for (int i = 1000; i < 1034; ++i)
+      same[i] = i;
+   bool reachable = same.size() == 100;
+   for (int i = 0; i < 100; ++i)
+      reachable = same.contains(i) == (i % 3 != 0) && reachable;
+   verify(reachable, "colliding keys");
+
+   //non-trivial keys and values; copy, move, compare
+   static_flat_map<std::string, std::string, 8> s{ { "a", "x" }, { "bb", "y" } };
+   s.emplace("ccc", "z");
+   static_flat_map<std::string, std::string, 8> copy = s;
+   verify(copy == s && copy.at("bb") == "y", "copy");
+
+   static_flat_map<std::string, std::string, 8> moved = std::move(copy);
+   verify(moved == s && copy.empty(), "move");
+
+   moved["a"] = "changed";
+   verify(moved != s, "compare");
+
+   moved.swap(s);
+   verify(s.at("a") == "changed" && moved.at("a") == "x", "swap");
+
+   s.clear();
+   verify(s.empty() && s.find("a") == s.end(), "clear");
+
+   //const access
+   const static_flat_map<int, int, 256>& cm = m;
+   static_flat_map<int, int, 256>::const_iterator ci = cm.find(5);
+   verify(ci != cm.end() && ci->second == 50 && cm.count(5) == 1, "const find");
+}
@@ -0,0 +1,200 @@
+/*
+* static_vector-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test static_vector template
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <iterator>
+
+#include "../include/static_vector.h"
+
+#include "tester.h"
+#include "tracked.h"
+
+using sigcpp::static_vector;
+
+//the size is held in the smallest type that can count to capacity
+static_assert(sizeof(static_vector<char, 32>) == 33);
+static_assert(sizeof(static_vector<short, 300>) == 602);
+
+static bool throwsLengthError(void (*f)())
+{
+   try
+   {
+      f();
+   }
+   catch (const std::length_error&)
+   {
+      return true;
+   }
+   return false;
+}
+
+//exercise all modifiers with elements of type T
+template<typename T>
+static void testModifiers(const char* type)
+{
+   std::string name(type);
+
+   static_vector<T, 8> v;
+   verify(v.empty() && v.size() == 0 && v.capacity() == 8,
+          (name + ": empty on construction").c_str());
+
+   v.push_back(T(1));
+   v.emplace_back(2);
+   T three(3);
+   v.push_back(three);
+   verify(contains(v, { 1, 2, 3 }), (name + ": push_back, emplace_back").c_str());
+   verify(v.front() == 1 && v.back() == 3 && v[1] == 2 && v.at(2) == 3,
+          (name + ": element access").c_str());
+
+   auto it = v.insert(v.begin(), T(0));
+   verify(it == v.begin() && contains(v, { 0, 1, 2, 3 }),
+          (name + ": insert at begin").c_str());
+
+   it = v.insert(v.begin() + 2, T(9));
+   verify(*it == 9 && contains(v, { 0, 1, 9, 2, 3 }),
+          (name + ": insert in middle").c_str());
+
+   v.insert(v.end(), T(4));
+   verify(contains(v, { 0, 1, 9, 2, 3, 4 }), (name + ": insert at end").c_str());
+
+   //insert a copy of one of the elements being shifted
+   v.insert(v.begin(), v[5]);
+   verify(contains(v, { 4, 0, 1, 9, 2, 3, 4 }),
+          (name + ": insert aliased element").c_str());
+
+   it = v.erase(v.begin() + 3);
+   verify(*it == 2 && contains(v, { 4, 0, 1, 2, 3, 4 }),
+          (name + ": erase one").c_str());
+
+   it = v.erase(v.begin(), v.begin() + 2);
+   verify(*it == 1 && contains(v, { 1, 2, 3, 4 }), (name + ": erase range").c_str());
+
+   it = v.erase(v.end() - 1, v.end());
+   verify(it == v.end() && contains(v, { 1, 2, 3 }),
+          (name + ": erase at end").c_str());
+
+   v.pop_back();
+   verify(contains(v, { 1, 2 }), (name + ": pop_back").c_str());
+
+   v.resize(4);
+   verify(contains(v, { 1, 2, 0, 0 }), (name + ": resize up").c_str());
+   v.resize(5, T(7));
+   verify(contains(v, { 1, 2, 0, 0, 7 }), (name + ": resize up with value").c_str());
+   v.resize(1);
+   verify(contains(v, { 1 }), (name + ": resize down").c_str());
+
+   //copy and move
+   static_vector<T, 8> c{ T(5), T(6), T(7) };
+   static_vector<T, 8> d(c);
+   verify(contains(d, { 5, 6, 7 }) && d == c, (name + ": copy ctor").c_str());
+
+   static_vector<T, 8> m(std::move(d));
+   verify(contains(m, { 5, 6, 7 }), (name + ": move ctor").c_str());
+
+   v = c;
+   verify(contains(v, { 5, 6, 7 }), (name + ": copy assign to shorter").c_str());
+   v = static_vector<T, 8>{ T(1) };
+   verify(contains(v, { 1 }), (name + ": move assign from shorter").c_str());
+
+   v.swap(c);
+   verify(contains(v, { 5, 6, 7 }) && contains(c, { 1 }), (name + ": swap").c_str());
+
+   //capacity
+   while (!v.full())
+      v.push_back(T(8));
+   verify(v.size() == 8 && v.try_push_back(T(9)) == nullptr,
+          (name + ": try_push_back when full").c_str());
+
+   v.clear();
+   verify(v.empty() && v.try_push_back(T(9)) != nullptr && v[0] == 9,
+          (name + ": clear, try_push_back").c_str());
+}
+
+TEST_CASE(static_vector)
+{
+   testModifiers<int>("int");
+   testModifiers<tracked>("tracked");
+
+   //all elements are destroyed
+   verify(tracked::live == 0, "tracked: no live objects");
+
+   //the capacity is a hard limit
+   verify(throwsLengthError([] {
+             static_vector<int, 2> v{ 1, 2 };
+             v.push_back(3);
+          }), "push_back when full throws");
+   verify(throwsLengthError([] {
+             static_vector<int, 2> v{ 1, 2 };
+             v.insert(v.begin(), 0);
+          }), "insert when full throws");
+   verify(throwsLengthError([] { static_vector<int, 2> v(3); }),
+          "construction over capacity throws");
+
+   //elements built before construction over capacity throws are destroyed
+   verify(throwsLengthError([] { static_vector<tracked, 2> v{ 1, 2, 3 }; }) &&
+          tracked::live == 0, "forward range over capacity builds nothing");
+   verify(throwsLengthError([] {
+             std::istringstream in("1 2 3");
+             std::istream_iterator<int> first(in), last;
+             static_vector<tracked, 2> v(first, last);
+          }) && tracked::live == 0, "input range over capacity destroys elements");
+
+   //elements built before a copy throws during assignment are destroyed
+   bool assignTest = false;
+   try
+   {
+      static_vector<fragile, 4> source{ 1, 2, 3, 4 };
+      static_vector<fragile, 4> target{ 9 };
+      fragile::copies = 2;
+      target = source;
+   }
+   catch (const std::runtime_error&)
+   {
+      assignTest = tracked::live == 0;
+   }
+   fragile::copies = -1;
+   verify(assignTest, "throwing copy in assignment leaks nothing");
+
+   //out-of-range access
+   bool atTest = false;
+   try
+   {
+      static_vector<int, 4> v{ 1, 2 };
+      v.at(2);
+   }
+   catch (const std::out_of_range&)
+   {
+      atTest = true;
+   }
+   verify(atTest, "at() out of range throws");
+
+   //non-trivial elements
+   static_vector<std::string, 4> s{ "alpha", "beta" };
+   s.insert(s.begin() + 1, "gamma");
+   s.emplace_back(3, 'x');
+   verify(s[0] == "alpha" && s[1] == "gamma" && s[2] == "beta" && s[3] == "xxx",
+          "std::string elements");
+
+   //reverse iteration
+   static_vector<int, 4> r{ 1, 2, 3 };
+   verify(std::equal(r.rbegin(), r.rend(), static_vector<int, 4>{ 3, 2, 1 }.begin()),
+          "reverse iterator");
+
+   //zero capacity
+   static_vector<int, 0> z;
+   verify(z.empty() && z.begin() == z.end() && z.try_push_back(1) == nullptr,
+          "zero capacity");
+}
@@ -0,0 +1,107 @@
+/*
+* stream-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test stream_fill and stream_copy
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../include/stream.h"
+#include "../include/aligned_array.h"
+
+#include "tester.h"
+
+using sigcpp::array;
+using sigcpp::stream_threshold;
+
+namespace
+{
+   template<typename T>
+   bool all_equal(const T* p, std::size_t n, const T& value)
+   {
+      for (std::size_t i = 0; i < n; ++i)
+         if (!(p[i] == value))
+            return false;
+      return true;
+   }
+
+   //not a divisor of the register size: filled with ordinary stores
+   struct rgb
+   {
+      unsigned char r, g, b;
+      bool operator==(const rgb& c) const { return r == c.r && g == c.g && b == c.b; }
+   };
+
+   //elements just above the threshold, with a tail
+   template<typename T>
+   constexpr std::size_t large = stream_threshold / sizeof(T) + 13;
+}
+
+TEST_CASE(stream)
+{
+   //small arrays take ordinary stores
+   array<int, 5> small{};
+   sigcpp::stream_fill(small, 7);
+   verify(all_equal(small.data(), small.size(), 7), "fill small array");
+
+   array<int, 5> smallCopy{};
+   sigcpp::stream_copy(small, smallCopy);
+   verify(smallCopy == small, "copy small array");
+
+   //large arrays, each size of element, starting off a register boundary
+   std::vector<unsigned char> bytes(large<unsigned char> + 64, 0);
+   sigcpp::stream_fill(bytes.data() + 3, large<unsigned char>, static_cast<unsigned char>(0xA5));
+   verify(bytes[2] == 0 && all_equal(bytes.data() + 3, large<unsigned char>,
+      static_cast<unsigned char>(0xA5)) && bytes[3 + large<unsigned char>] == 0, "fill bytes");
+
+   std::vector<std::uint16_t> shorts(large<std::uint16_t> + 8, 0);
+   sigcpp::stream_fill(shorts.data() + 1, large<std::uint16_t>, std::uint16_t(0x1234));
+   verify(shorts[0] == 0 && all_equal(shorts.data() + 1, large<std::uint16_t>,
+      std::uint16_t(0x1234)) && shorts[1 + large<std::uint16_t>] == 0, "fill 16-bit");
+
+   std::vector<double> doubles(large<double> + 2, 0.0);
+   sigcpp::stream_fill(doubles.data() + 1, large<double>, -2.5);
+   verify(doubles[0] == 0 && all_equal(doubles.data() + 1, large<double>, -2.5) &&
+      doubles.back() == 0, "fill double");
+
+   std::vector<rgb> pixels(large<rgb>);
+   sigcpp::stream_fill(pixels.data(), pixels.size(), rgb{ 1, 2, 3 });
+   verify(all_equal(pixels.data(), pixels.size(), rgb{ 1, 2, 3 }), "fill 3-byte type");
+
+   //copy into a destination off a register boundary
+   std::vector<std::uint32_t> source(large<std::uint32_t>);
+   for (std::size_t i = 0; i < source.size(); ++i)
+      source[i] = static_cast<std::uint32_t>(i * 2654435761u);
+
+   std::vector<std::uint32_t> target(source.size() + 2, 0);
+   sigcpp::stream_copy(source.data(), source.size(), target.data() + 1);
+   bool copied = target[0] == 0 && target.back() == 0;
+   for (std::size_t i = 0; i < source.size(); ++i)
+      copied = target[i + 1] == source[i] && copied;
+   verify(copied, "copy large");
+
+   //large arrays: the size selects streaming at compile time
+   using grid = array<float, large<float>>;
+   auto a = std::make_unique<grid>();
+   auto b = std::make_unique<grid>();
+   sigcpp::stream_fill(*a, 0.5f);
+   (*a)[1000] = 3;
+   sigcpp::stream_copy(*a, *b);
+   verify(all_equal(b->data(), 1000, 0.5f) && (*b)[1000] == 3 && b->back() == 0.5f,
+      "fill and copy large array");
+
+   using aligned_grid = sigcpp::aligned_array<int, large<int>, 64>;
+   auto c = std::make_unique<aligned_grid>();
+   sigcpp::stream_fill(*c, -1);
+   verify(all_equal(c->data(), c->size(), -1), "fill aligned_array");
+}
@@ -12,7 +12,17 @@
 */
 
 #include <iostream>
-#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
 #include <climits>
 
 #include "tester.h"
@@ -36,63 +46,475 @@ void setMaxFailThreshold()
 }
 
 
-//counter for number of tests run, failed
-static unsigned testsDone;
-static unsigned testsFailed;
+static reportFormat format{ reportFormat::text };
+void setReportFormat(reportFormat f)
+{
+   format = f;
+}
+
+
+static std::ostream* output{ &std::cout };
+void setOutputStream(std::ostream& out)
+{
+   output = &out;
+}
+
+
+namespace
+{
+   using testClock = std::chrono::steady_clock;
+
+   //text kept in a string reserved per case
+   class textBuffer
+   {
+   public:
+      void reserve(std::size_t n) { text.reserve(n); }
+
+      void put(char c) { text.push_back(c); }
+
+      void put(const char* s) { text.append(s); }
+
+      void put(unsigned long long n)
+      {
+         char digits[24];
+         std::snprintf(digits, sizeof(digits), "%llu", n);
+         put(digits);
+      }
+
+      void putSeconds(double seconds)
+      {
+         char digits[32];
+         std::snprintf(digits, sizeof(digits), "%.3f", seconds);
+         put(digits);
+      }
+
+      //a string as a JSON string literal
+      void putQuoted(const char* s)
+      {
+         put('"');
+         for (; *s != '\0'; ++s)
+         {
+            const unsigned char c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\')
+            {
+               put('\\');
+               put(*s);
+            }
+            else if (c < 0x20)
+            {
+               char escape[8];
+               std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+               put(escape);
+            }
+            else
+               put(*s);
+         }
+         put('"');
+      }
+
+      //start a line unless at the start of one
+      void endLine()
+      {
+         if (!text.empty() && text.back() != '\n')
+            put('\n');
+      }
+
+      bool endsWith(char c) const { return !text.empty() && text.back() == c; }
+
+      void writeTo(std::ostream& out) const
+      {
+         out.write(text.data(), static_cast<std::streamsize>(text.size()));
+      }
+
+   private:
+      std::string text;
+   };
+
+   struct failure
+   {
+      unsigned long long test;
+      const char* status;
+      std::string hint;
+   };
+
+   //a registered test case and the results of running it
+   //-only the thread running the case modifies it until the case finishes
+   struct testCase
+   {
+      testCase(const char* n, testFunction f) : name(n), run(f) {}
+
+      const char* name;
+      testFunction run;
+
+      unsigned long long done{ 0 };
+      unsigned long long failed{ 0 };
+      unsigned long long pendingPasses{ 0 };
+      unsigned long long indicated{ 0 };
+      double seconds{ 0 };
+      bool finished{ false };
+      std::vector<failure> failures;
+      textBuffer output;
+   };
+}
+
+static std::vector<testCase>& registeredTests()
+{
+   static std::vector<testCase> tests;
+   return tests;
+}
+
+bool registerTest(const char* name, testFunction test)
+{
+   registeredTests().push_back(testCase{ name, test });
+   return true;
+}
+
+
+//cases selected to run, in order of name
+static std::vector<testCase*> selected;
+
+//checks outside a test case
+static testCase defaultCase{ "default", nullptr };
+
+//case running on this thread
+static thread_local testCase* currentCase{ nullptr };
+
+//failures in all cases: compared with the fail threshold
+static std::atomic<unsigned long long> testsFailed{ 0 };
+static std::atomic<bool> testsStopped{ false };
+
+
+//pass indicators written per case: further passes are written as a count
+//so that the output of a case stays within its reserved buffer
+static constexpr unsigned long long maxPassIndicators = 1024;
+
+//write indicators for passes counted since the last output of a case
+static void writePasses(testCase& c)
+{
+   if (c.pendingPasses == 0)
+      return;
+
+   const unsigned long long room = maxPassIndicators - c.indicated;
+   const unsigned long long shown = c.pendingPasses < room ? c.pendingPasses : room;
+
+   if (c.output.endsWith(':'))
+      c.output.put(' ');
+   for (unsigned long long i = 0; i < shown; ++i)
+      c.output.put('.');
+
+   if (shown < c.pendingPasses)
+   {
+      if (shown != 0)
+         c.output.put(' ');
+      c.output.put("(+");
+      c.output.put(c.pendingPasses - shown);
+      c.output.put(" passes)");
+   }
+
+   c.indicated += shown;
+   c.pendingPasses = 0;
+}
+
+//print a line for a check in text reports
+static void printCheck(testCase& c, const char* status, const char* hint)
+{
+   c.output.put("Test# ");
+   c.output.put(c.done);
+   c.output.put(": ");
+   c.output.put(status);
+   c.output.put(" (");
+   c.output.put(hint);
+   c.output.put(")\n");
+}
+
+//count a failure and report it in text reports; true if tests must stop
+static bool recordFailure(testCase& c, const char* status, const char* hint)
+{
+   ++c.failed;
+   c.failures.push_back(failure{ c.done, status, hint });
+
+   if (format == reportFormat::text)
+   {
+      writePasses(c);
+      c.output.endLine();
+      printCheck(c, status, hint);
+   }
+
+   if (++testsFailed <= failThreshold)
+      return false;
+
+   testsStopped = true;
+   return true;
+}
 
-bool lastOutputEndedInLineBreak{ false };
 
 //track number of tests and check test result
 void verify(bool success, const char* hint)
 {
-   ++testsDone;
-   std::ostringstream message;
-
-   //assume stream is at start of line on first call 
-   lastOutputEndedInLineBreak = testsDone == 1;
+   testCase& c = currentCase != nullptr ? *currentCase : defaultCase;
+   ++c.done;
 
    if (success)
    {
+      if (format != reportFormat::text)
+         return;
+
       if (passMode == passReportMode::indicate)
-         message << '.';
+         ++c.pendingPasses;
       else if (passMode == passReportMode::detail)
       {
-         message << "Test# " << testsDone << ": Pass (" << hint << ")\n";
-         lastOutputEndedInLineBreak = true;
+         c.output.endLine();
+         printCheck(c, "Pass", hint);
       }
+      return;
    }
-   else
+
+   if (recordFailure(c, "FAIL", hint))
+      throw "Test# " + std::to_string(c.done) + ": FAIL (" + hint + ")";
+}
+
+
+//run a case on this thread: exceptions escaping the case count as failures
+static void runTestCase(testCase& c)
+{
+   c.output.reserve(4096);
+   if (format == reportFormat::text)
    {
-      ++testsFailed;
+      c.output.put(c.name);
+      c.output.put(':');
+   }
 
-      if (!lastOutputEndedInLineBreak)
-         message << '\n';
-      message << "Test# " << testsDone << ": FAIL (" << hint << ")\n";
-      lastOutputEndedInLineBreak = true;
+   currentCase = &c;
+   const auto start = testClock::now();
+   try
+   {
+      c.run();
+   }
+   catch (const std::string&)
+   {
+      //verify reported the failure that stopped the tests
+   }
+   catch (const std::exception& e)
+   {
+      ++c.done;
+      recordFailure(c, "EXCEPTION", e.what());
+   }
+   catch (...)
+   {
+      ++c.done;
+      recordFailure(c, "EXCEPTION", "unknown exception");
+   }
+   c.seconds = std::chrono::duration<double>(testClock::now() - start).count();
+   currentCase = nullptr;
 
-      if (testsFailed > failThreshold)
-         throw message.str();
+   if (format == reportFormat::text)
+   {
+      writePasses(c);
+      c.output.endLine();
    }
+}
 
-   std::cout << message.str();
+void runRegisteredTests(unsigned threads, unsigned shardIndex, unsigned shardCount)
+{
+   std::vector<testCase>& tests = registeredTests();
+   std::sort(tests.begin(), tests.end(), [](const testCase& a, const testCase& b) {
+      return std::strcmp(a.name, b.name) < 0;
+   });
+
+   selected.clear();
+   for (std::size_t i = 0; i < tests.size(); ++i)
+      if (shardCount <= 1 || i % shardCount == shardIndex - 1)
+         selected.push_back(&tests[i]);
+
+   if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+   if (threads > selected.size())
+      threads = static_cast<unsigned>(std::max<std::size_t>(1, selected.size()));
+
+   //cases start in order; output is written in order as a prefix finishes
+   std::atomic<std::size_t> next{ 0 };
+   std::mutex outputMutex;
+   std::size_t written = 0;
+
+   auto work = [&] {
+      for (std::size_t i = next++; i < selected.size() && !testsStopped; i = next++)
+      {
+         runTestCase(*selected[i]);
+
+         std::lock_guard<std::mutex> lock(outputMutex);
+         selected[i]->finished = true;
+         for (; written < selected.size() && selected[written]->finished; ++written)
+            selected[written]->output.writeTo(*output);
+      }
+   };
+
+   std::vector<std::thread> workers;
+   for (unsigned t = 1; t < threads; ++t)
+      workers.emplace_back(work);
+   work();
+   for (auto& w : workers)
+      w.join();
+
+   //once tests stop, a claimed case may be skipped while later cases finish:
+   //write those too, so that the output has every case the summary reports
+   for (; written < selected.size(); ++written)
+      if (selected[written]->finished)
+         selected[written]->output.writeTo(*output);
 }
 
+unsigned long long failedTestCount()
+{
+   return testsFailed;
+}
+
+
+//cases with results: the default case if it has checks, and those that ran
+static std::vector<const testCase*> reportedCases()
+{
+   std::vector<const testCase*> cases;
+   if (defaultCase.done != 0)
+      cases.push_back(&defaultCase);
+   for (const testCase* c : selected)
+      if (c->finished)
+         cases.push_back(c);
+   return cases;
+}
+
+static void summarizeText(textBuffer& out, const std::vector<const testCase*>& cases,
+   unsigned long long done)
+{
+   //exactly one empty line before summary
+   writePasses(defaultCase);
+   defaultCase.output.endLine();
+   defaultCase.output.writeTo(*output);
+   out.put('\n');
 
-//print a simple test report
+   for (const testCase* c : cases)
+   {
+      out.put("Case ");
+      out.put(c->name);
+      out.put(": ");
+      out.put(c->done);
+      out.put(" tests, ");
+      out.put(c->failed);
+      out.put(" failed, ");
+      out.putSeconds(c->seconds);
+      out.put(" s\n");
+   }
+
+   out.put("Tests completed: ");
+   out.put(done);
+   out.put("\nTests passed: ");
+   out.put(done - testsFailed);
+   out.put("\nTests failed: ");
+   out.put(testsFailed.load());
+   out.put('\n');
+
+   if (testsStopped)
+   {
+      out.put("Tests stopped after ");
+      out.put(testsFailed.load());
+      out.put(" failure(s)\n");
+   }
+}
+
+//one test point per case; failures are diagnostics
+static void summarizeTap(textBuffer& out, const std::vector<const testCase*>& cases)
+{
+   out.put("TAP version 13\n1..");
+   out.put(static_cast<unsigned long long>(cases.size()));
+   out.put('\n');
+
+   for (std::size_t i = 0; i < cases.size(); ++i)
+   {
+      const testCase& c = *cases[i];
+      out.put(c.failed == 0 ? "ok " : "not ok ");
+      out.put(static_cast<unsigned long long>(i + 1));
+      out.put(" - ");
+      out.put(c.name);
+      out.put(" # ");
+      out.put(c.done);
+      out.put(" checks, ");
+      out.putSeconds(c.seconds);
+      out.put(" s\n");
+
+      for (const failure& f : c.failures)
+      {
+         out.put("# Test# ");
+         out.put(f.test);
+         out.put(": ");
+         out.put(f.status);
+         out.put(" (");
+         out.put(f.hint.c_str());
+         out.put(")\n");
+      }
+   }
+
+   if (testsStopped)
+   {
+      out.put("Bail out! Tests stopped after ");
+      out.put(testsFailed.load());
+      out.put(" failure(s)\n");
+   }
+}
+
+static void summarizeJson(textBuffer& out, const std::vector<const testCase*>& cases,
+   unsigned long long done)
+{
+   out.put("{\"completed\":");
+   out.put(done);
+   out.put(",\"passed\":");
+   out.put(done - testsFailed);
+   out.put(",\"failed\":");
+   out.put(testsFailed.load());
+   out.put(",\"stopped\":");
+   out.put(testsStopped ? "true" : "false");
+   out.put(",\"cases\":[");
+
+   for (std::size_t i = 0; i < cases.size(); ++i)
+   {
+      const testCase& c = *cases[i];
+      out.put(i == 0 ? "{\"name\":" : ",{\"name\":");
+      out.putQuoted(c.name);
+      out.put(",\"completed\":");
+      out.put(c.done);
+      out.put(",\"failed\":");
+      out.put(c.failed);
+      out.put(",\"seconds\":");
+      out.putSeconds(c.seconds);
+      out.put(",\"failures\":[");
+
+      for (std::size_t j = 0; j < c.failures.size(); ++j)
+      {
+         out.put(j == 0 ? "{\"test\":" : ",{\"test\":");
+         out.put(c.failures[j].test);
+         out.put(",\"message\":");
+         out.putQuoted(c.failures[j].hint.c_str());
+         out.put('}');
+      }
+      out.put("]}");
+   }
+
+   out.put("]}\n");
+}
+
+
+//print a test report in the chosen format
 void summarizeTests()
 {
-   //TODO: there should always be one and exactly one empty line before summary
-   //-assume if an exception was thrown earlier on test failure, the client
-   //-printed the msg and caused a line break after printing the msg
-   if (!lastOutputEndedInLineBreak)
-      std::cout << '\n';
-   else if (testsFailed <= failThreshold)
-      std::cout << '\n';
-
-   std::cout << "Tests completed: " << testsDone << '\n';
-   std::cout << "Tests passed: " << testsDone - testsFailed << '\n';
-   std::cout << "Tests failed: " << testsFailed << '\n';
-
-   if (testsFailed > failThreshold)
-      std::cout << "Tests stopped after " << testsFailed << " failure(s)\n";
-}
\ No newline at end of file
+   const std::vector<const testCase*> cases = reportedCases();
+   unsigned long long done = 0;
+   for (const testCase* c : cases)
+      done += c->done;
+
+   textBuffer out;
+   if (format == reportFormat::tap)
+      summarizeTap(out, cases);
+   else if (format == reportFormat::json)
+      summarizeJson(out, cases, done);
+   else
+      summarizeText(out, cases, done);
+
+   out.writeTo(*output);
+   output->flush();
+}
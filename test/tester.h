@@ -3,19 +3,65 @@
 * Sean Murthy
 * (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
 *
-* Attribution and copyright notice must be retained. 
-* - Attribution may be augmented to include additional authors 
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
 * - Copyright notice cannot be altered
 * Attribution and copyright info may be relocated but they must be conspicuous.
 *
 * Declare testing infrastructure
+* - TEST_CASE(name) defines a test case and registers it before main runs;
+*   names must be unique identifiers across all unit files
+* - runRegisteredTests runs test cases in order of name on a number of
+*   threads; a shard runs every shardCount-th case starting at shardIndex
+*   (1-based), so shards 1/n ... n/n together run every case once
+* - verify counts a check in the test case running on the calling thread:
+*   call it from that thread, not from threads a test starts; checks
+*   outside a test case count in a default case
+* - each case keeps its own counters, merged in the summary; output of a
+*   case is written when it and all cases before it have finished, or after
+*   all threads end if tests stopped before an earlier case ran
+* - in indicate mode a pass only counts: indicators are written when the
+*   case next has output, at most 1024 per case and the rest as a count, so
+*   passes neither allocate nor grow the output; detail mode writes a line
+*   per pass
+* - checks are numbered within a test case
+* - when failures in all cases exceed the fail threshold, verify reports the
+*   failure and throws its message as a std::string: the case ends, and no
+*   more cases start
+* - reports are text (pass indicators as configured, then a summary), TAP
+*   (one test point per case), or JSON (written by summarizeTests);
+*   TAP and JSON omit pass indicators
 */
 
+#include <iosfwd>
+
 enum class passReportMode { none, indicate, detail };
+enum class reportFormat { text, tap, json };
 
 void setPassReportMode(passReportMode mode);
 void setFailThreshold(unsigned short value);
 void setMaxFailThreshold();
+void setReportFormat(reportFormat format);
+void setOutputStream(std::ostream& out);
+
+using testFunction = void (*)();
+
+//returns true so that registration can initialize a variable
+bool registerTest(const char* name, testFunction test);
+
+#define SIGCPP_TEST_CONCAT2(a, b) a##b
+#define SIGCPP_TEST_CONCAT(a, b) SIGCPP_TEST_CONCAT2(a, b)
+
+#define TEST_CASE(name) \
+   static void SIGCPP_TEST_CONCAT(sigcppTest_, name)(); \
+   [[maybe_unused]] static const bool SIGCPP_TEST_CONCAT(sigcppRegistered_, name) = \
+      registerTest(#name, SIGCPP_TEST_CONCAT(sigcppTest_, name)); \
+   static void SIGCPP_TEST_CONCAT(sigcppTest_, name)()
+
+//threads 0 means one per hardware thread
+void runRegisteredTests(unsigned threads, unsigned shardIndex, unsigned shardCount);
 
 void verify(bool success, const char* msg);
-void summarizeTests();
\ No newline at end of file
+
+void summarizeTests();
+unsigned long long failedTestCount();
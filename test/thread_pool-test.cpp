@@ -0,0 +1,78 @@
+/*
+* thread_pool-test.cpp
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Test thread_pool
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../include/thread_pool.h"
+
+#include "tester.h"
+
+using sigcpp::thread_pool;
+
+//each index is visited exactly once
+static bool visitsEachOnce(thread_pool& pool, std::size_t n)
+{
+   std::vector<std::atomic<int>> visits(n);
+   pool.parallel_for(n, [&](std::size_t i) { ++visits[i]; });
+
+   for (auto& v : visits)
+      if (v != 1)
+         return false;
+   return true;
+}
+
+TEST_CASE(thread_pool)
+{
+   thread_pool one(1);
+   verify(one.size() == 1 && visitsEachOnce(one, 100), "one-thread pool");
+
+   thread_pool pool(4);
+   verify(pool.size() == 4, "size includes the calling thread");
+   verify(visitsEachOnce(pool, 0) && visitsEachOnce(pool, 1) &&
+          visitsEachOnce(pool, 3) && visitsEachOnce(pool, 1000),
+          "each index visited once");
+
+   //repeated calls reuse the workers
+   bool repeated = true;
+   for (int r = 0; r < 50; ++r)
+      repeated = repeated && visitsEachOnce(pool, 64);
+   verify(repeated, "repeated parallel_for");
+
+   //uneven work is balanced by stealing: all tasks still complete
+   std::atomic<std::size_t> sum{ 0 };
+   pool.parallel_for(16, [&](std::size_t i) {
+      if (i < 4)
+         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      sum += i;
+   });
+   verify(sum == 120, "uneven tasks");
+
+   //nested parallel_for runs sequentially in the task
+   std::atomic<std::size_t> inner{ 0 };
+   pool.parallel_for(8, [&](std::size_t) {
+      pool.parallel_for(8, [&](std::size_t) { ++inner; });
+   });
+   verify(inner == 64, "nested parallel_for");
+
+   //concurrent callers are serialized
+   std::atomic<std::size_t> total{ 0 };
+   std::thread other([&] {
+      pool.parallel_for(100, [&](std::size_t) { ++total; });
+   });
+   pool.parallel_for(100, [&](std::size_t) { ++total; });
+   other.join();
+   verify(total == 200, "concurrent callers");
+}
@@ -0,0 +1,71 @@
+/*
+* tracked.h
+* Sean Murthy
+* (c) 2020 sigcpp https://sigcpp.github.io. See LICENSE.MD
+*
+* Attribution and copyright notice must be retained.
+* - Attribution may be augmented to include additional authors
+* - Copyright notice cannot be altered
+* Attribution and copyright info may be relocated but they must be conspicuous.
+*
+* Define element types and checks shared by container tests
+* - tracked counts live objects; the count is per thread because test cases
+*   run on threads of their own
+* - fragile is a tracked whose copy constructor throws once a budget of
+*   copies is spent; a negative budget never throws
+* - contains checks the elements of a container against a list of ints
+*/
+
+#ifndef SIGCPP_TEST_TRACKED_H
+#define SIGCPP_TEST_TRACKED_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+
+struct tracked
+{
+   static inline thread_local int live = 0;
+   int value;
+
+   tracked(int v = 0) : value(v) { ++live; }
+   tracked(const tracked& t) : value(t.value) { ++live; }
+   tracked(tracked&& t) noexcept : value(t.value) { t.value = -1; ++live; }
+   tracked& operator=(const tracked&) = default;
+   tracked& operator=(tracked&& t) noexcept
+   {
+      value = t.value;
+      t.value = -1;
+      return *this;
+   }
+   ~tracked() { --live; }
+
+   friend bool operator==(const tracked& t, int i) { return t.value == i; }
+   friend bool operator==(const tracked& a, const tracked& b)
+   {
+      return a.value == b.value;
+   }
+};
+
+struct fragile : tracked
+{
+   static inline thread_local int copies = -1;
+
+   fragile(int v = 0) : tracked(v) {}
+   fragile(const fragile& f) : tracked(f)
+   {
+      if (copies-- == 0)
+         throw std::runtime_error("copy failed");
+   }
+   fragile& operator=(const fragile&) = default;
+};
+
+template<typename V>
+bool contains(const V& v, std::initializer_list<int> expected)
+{
+   return v.size() == expected.size() &&
+      std::equal(v.begin(), v.end(), expected.begin(),
+                 [](const auto& e, int i) { return e == i; });
+}
+
+#endif